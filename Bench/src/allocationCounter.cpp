@@ -0,0 +1,105 @@
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replacing the global allocation functions in the executable also routes the
+// engine library's allocations through them on ELF platforms. Windows DLLs
+// keep their own CRT heap, so there only the benchmark's own allocations are
+// counted.
+
+namespace
+{
+	std::atomic<uint64_t> g_allocations{ 0 };
+	std::atomic<uint64_t> g_bytes{ 0 };
+
+	void* countedAllocate(std::size_t _size)
+	{
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+		g_bytes.fetch_add(_size, std::memory_order_relaxed);
+
+		void* pointer = std::malloc(_size == 0 ? 1 : _size);
+		if (pointer == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return pointer;
+	}
+}
+
+namespace tra::bench
+{
+	AllocationCounts getAllocationCounts()
+	{
+		AllocationCounts counts;
+		counts.m_allocations = g_allocations.load(std::memory_order_relaxed);
+		counts.m_bytes = g_bytes.load(std::memory_order_relaxed);
+		return counts;
+	}
+}
+
+void* operator new(std::size_t _size)
+{
+	return countedAllocate(_size);
+}
+
+void* operator new[](std::size_t _size)
+{
+	return countedAllocate(_size);
+}
+
+void* operator new(std::size_t _size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return countedAllocate(_size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t _size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return countedAllocate(_size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void operator delete(void* _pointer) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete[](void* _pointer) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete(void* _pointer, std::size_t) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete[](void* _pointer, std::size_t) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete(void* _pointer, const std::nothrow_t&) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete[](void* _pointer, const std::nothrow_t&) noexcept
+{
+	std::free(_pointer);
+}
@@ -0,0 +1,272 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+namespace tra::bench
+{
+	namespace
+	{
+		constexpr uint64_t MAX_ITERATIONS = 1000000000;
+
+		// Setup excluded with pauseTiming() still takes wall time, so a run
+		// also stops growing once it has taken this many times --min-time.
+		constexpr double MAX_WALL_TIME_FACTOR = 10.0;
+
+		struct Options
+		{
+			std::string m_filter;
+			double m_minTimeSeconds = 0.5;
+			bool m_csv = false;
+		};
+
+		struct Result
+		{
+			std::string m_name;
+			uint64_t m_iterations = 0;
+			double m_nsPerOp = 0.0;
+			double m_allocationsPerOp = 0.0;
+			double m_bytesPerOp = 0.0;
+		};
+
+		std::vector<std::unique_ptr<Benchmark>>& getBenchmarks()
+		{
+			static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+			return benchmarks;
+		}
+
+		bool parseOptions(int _argc, char** _argv, Options& _outOptions)
+		{
+			for (int i = 1; i < _argc; i++)
+			{
+				const char* argument = _argv[i];
+				if (std::strncmp(argument, "--filter=", 9) == 0)
+				{
+					_outOptions.m_filter = argument + 9;
+				}
+				else if (std::strncmp(argument, "--min-time=", 11) == 0)
+				{
+					_outOptions.m_minTimeSeconds = std::atof(argument + 11);
+				}
+				else if (std::strcmp(argument, "--format=csv") == 0)
+				{
+					_outOptions.m_csv = true;
+				}
+				else if (std::strcmp(argument, "--format=console") == 0)
+				{
+					_outOptions.m_csv = false;
+				}
+				else
+				{
+					std::fprintf(stderr, "usage: %s [--filter=<substring>] [--min-time=<seconds>] [--format=console|csv]\n", _argv[0]);
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		Result runOne(const Benchmark& _benchmark, int64_t _argument, const std::string& _name, const Options& _options)
+		{
+			uint64_t minTimeNs = static_cast<uint64_t>(_options.m_minTimeSeconds * 1e9);
+			uint64_t iterations = 1;
+
+			for (;;)
+			{
+				State state(iterations, _argument);
+
+				uint64_t startNs = now();
+				_benchmark.getFunction()(state);
+				uint64_t wallNs = now() - startNs;
+
+				uint64_t measuredNs = state.getMeasuredNs();
+
+				double wallLimit = static_cast<double>(minTimeNs) * MAX_WALL_TIME_FACTOR;
+				bool done = measuredNs >= minTimeNs || iterations >= MAX_ITERATIONS || static_cast<double>(wallNs) >= wallLimit;
+				if (done)
+				{
+					double operations = static_cast<double>(iterations) * static_cast<double>((std::max)(state.getItemsPerIteration(), static_cast<uint64_t>(1)));
+					AllocationCounts allocations = state.getMeasuredAllocations();
+
+					Result result;
+					result.m_name = _name;
+					result.m_iterations = iterations;
+					result.m_nsPerOp = static_cast<double>(measuredNs) / operations;
+					result.m_allocationsPerOp = static_cast<double>(allocations.m_allocations) / operations;
+					result.m_bytesPerOp = static_cast<double>(allocations.m_bytes) / operations;
+					return result;
+				}
+
+				// Aim a little past the minimum, as Google Benchmark does, without
+				// letting setup time run away.
+				double multiplier = measuredNs == 0 ? 10.0 : static_cast<double>(minTimeNs) * 1.4 / static_cast<double>(measuredNs);
+				multiplier = (std::min)(multiplier, 10.0);
+				if (wallNs > 0)
+				{
+					multiplier = (std::min)(multiplier, wallLimit / static_cast<double>(wallNs));
+				}
+
+				uint64_t next = static_cast<uint64_t>(static_cast<double>(iterations) * multiplier);
+				iterations = (std::min)((std::max)(next, iterations + 1), MAX_ITERATIONS);
+			}
+		}
+
+		void printHeader(const Options& _options)
+		{
+			if (_options.m_csv)
+			{
+				std::printf("name,iterations,ns_per_op,allocs_per_op,bytes_per_op\n");
+				return;
+			}
+
+			std::printf("%-56s %14s %12s %12s %12s\n", "Benchmark", "Time (ns/op)", "Allocs/op", "Bytes/op", "Iterations");
+			std::printf("%s\n", std::string(110, '-').c_str());
+		}
+
+		void printResult(const Result& _result, const Options& _options)
+		{
+			if (_options.m_csv)
+			{
+				std::printf("%s,%llu,%.3f,%.3f,%.3f\n", _result.m_name.c_str(), static_cast<unsigned long long>(_result.m_iterations),
+					_result.m_nsPerOp, _result.m_allocationsPerOp, _result.m_bytesPerOp);
+			}
+			else
+			{
+				std::printf("%-56s %14.2f %12.2f %12.1f %12llu\n", _result.m_name.c_str(), _result.m_nsPerOp,
+					_result.m_allocationsPerOp, _result.m_bytesPerOp, static_cast<unsigned long long>(_result.m_iterations));
+			}
+
+			std::fflush(stdout);
+		}
+	}
+
+	uint64_t now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	State::State(uint64_t _iterations, int64_t _argument)
+		: m_iterations(_iterations), m_remaining(_iterations), m_argument(_argument), m_itemsPerIteration(1),
+		m_startNs(0), m_stopNs(0), m_pauseStartNs(0), m_pausedNs(0)
+	{
+	}
+
+	void State::start()
+	{
+		m_startAllocations = getAllocationCounts();
+		m_startNs = now();
+	}
+
+	void State::stop()
+	{
+		if (m_stopNs != 0)
+		{
+			return;
+		}
+
+		m_stopNs = now();
+		m_stopAllocations = getAllocationCounts();
+	}
+
+	uint64_t State::getMeasuredNs() const
+	{
+		uint64_t elapsedNs = m_stopNs > m_startNs ? m_stopNs - m_startNs : 0;
+		return elapsedNs - (std::min)(m_pausedNs, elapsedNs);
+	}
+
+	AllocationCounts State::getMeasuredAllocations() const
+	{
+		AllocationCounts allocations;
+		allocations.m_allocations = m_stopAllocations.m_allocations - m_startAllocations.m_allocations - m_pausedAllocations.m_allocations;
+		allocations.m_bytes = m_stopAllocations.m_bytes - m_startAllocations.m_bytes - m_pausedAllocations.m_bytes;
+		return allocations;
+	}
+
+	void State::pauseTiming()
+	{
+		m_pauseStartNs = now();
+		m_pauseStartAllocations = getAllocationCounts();
+	}
+
+	void State::resumeTiming()
+	{
+		AllocationCounts allocations = getAllocationCounts();
+		m_pausedAllocations.m_allocations += allocations.m_allocations - m_pauseStartAllocations.m_allocations;
+		m_pausedAllocations.m_bytes += allocations.m_bytes - m_pauseStartAllocations.m_bytes;
+		m_pausedNs += now() - m_pauseStartNs;
+	}
+
+	Benchmark::Benchmark(const std::string& _name, BenchmarkFunction _function)
+		: m_name(_name), m_function(_function)
+	{
+	}
+
+	Benchmark* Benchmark::arg(int64_t _argument)
+	{
+		m_arguments.push_back(_argument);
+		return this;
+	}
+
+	Benchmark* Benchmark::range(int64_t _low, int64_t _high, int64_t _multiplier)
+	{
+		for (int64_t argument = _low; argument <= _high; argument *= _multiplier)
+		{
+			m_arguments.push_back(argument);
+		}
+
+		return this;
+	}
+
+	Benchmark* registerBenchmark(const std::string& _name, BenchmarkFunction _function)
+	{
+		getBenchmarks().push_back(std::make_unique<Benchmark>(_name, _function));
+		return getBenchmarks().back().get();
+	}
+
+	int runBenchmarks(int _argc, char** _argv)
+	{
+		Options options;
+		if (!parseOptions(_argc, _argv, options))
+		{
+			return 1;
+		}
+
+#if defined(_DEBUG)
+		std::fprintf(stderr, "warning: benchmarking a Debug build\n");
+#endif
+
+		printHeader(options);
+
+		for (const std::unique_ptr<Benchmark>& benchmark : getBenchmarks())
+		{
+			std::vector<int64_t> arguments = benchmark->getArguments();
+			bool hasArguments = !arguments.empty();
+			if (!hasArguments)
+			{
+				arguments.push_back(0);
+			}
+
+			for (int64_t argument : arguments)
+			{
+				std::string name = benchmark->getName();
+				if (hasArguments)
+				{
+					name += "/" + std::to_string(argument);
+				}
+
+				if (!options.m_filter.empty() && name.find(options.m_filter) == std::string::npos)
+				{
+					continue;
+				}
+
+				printResult(runOne(*benchmark, argument, name, options), options);
+			}
+		}
+
+		return 0;
+	}
+}
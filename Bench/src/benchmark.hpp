@@ -0,0 +1,133 @@
+#ifndef TRA_BENCH_BENCHMARK_HPP
+#define TRA_BENCH_BENCHMARK_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tra::bench
+{
+	// Heap use of the whole process, counted by the replaced global operator
+	// new in allocationCounter.cpp.
+	struct AllocationCounts
+	{
+		uint64_t m_allocations = 0;
+		uint64_t m_bytes = 0;
+	};
+
+	AllocationCounts getAllocationCounts();
+
+	uint64_t now();
+
+	// Passed to every benchmark function, which runs its measured operation
+	// while keepRunning() returns true. Setup that must not be measured goes
+	// between pauseTiming() and resumeTiming(); its time and allocations are
+	// subtracted. A benchmark doing a batch of operations per iteration calls
+	// setItemsPerIteration() so results are reported per item.
+	class State
+	{
+	public:
+		State(uint64_t _iterations, int64_t _argument);
+
+		// Timing starts at the first call and stops at the one returning false,
+		// so setup before the loop is not measured.
+		bool keepRunning()
+		{
+			if (m_remaining == 0)
+			{
+				stop();
+				return false;
+			}
+
+			if (m_remaining == m_iterations)
+			{
+				start();
+			}
+
+			--m_remaining;
+			return true;
+		}
+
+		int64_t getArgument() const { return m_argument; }
+		uint64_t getIterations() const { return m_iterations; }
+
+		void pauseTiming();
+		void resumeTiming();
+
+		void setItemsPerIteration(uint64_t _items) { m_itemsPerIteration = _items; }
+		uint64_t getItemsPerIteration() const { return m_itemsPerIteration; }
+
+		// Time and allocations of the loop, pauses excluded.
+		uint64_t getMeasuredNs() const;
+		AllocationCounts getMeasuredAllocations() const;
+
+	private:
+		void start();
+		void stop();
+
+		uint64_t m_iterations;
+		uint64_t m_remaining;
+		int64_t m_argument;
+		uint64_t m_itemsPerIteration;
+
+		uint64_t m_startNs;
+		uint64_t m_stopNs;
+		AllocationCounts m_startAllocations;
+		AllocationCounts m_stopAllocations;
+
+		uint64_t m_pauseStartNs;
+		AllocationCounts m_pauseStartAllocations;
+		uint64_t m_pausedNs;
+		AllocationCounts m_pausedAllocations;
+	};
+
+	using BenchmarkFunction = void(*)(State&);
+
+	class Benchmark
+	{
+	public:
+		Benchmark(const std::string& _name, BenchmarkFunction _function);
+
+		// Runs the benchmark once per argument; without any it runs once with 0.
+		Benchmark* arg(int64_t _argument);
+		// _low, then every _multiplier times that up to _high.
+		Benchmark* range(int64_t _low, int64_t _high, int64_t _multiplier = 10);
+
+		const std::string& getName() const { return m_name; }
+		BenchmarkFunction getFunction() const { return m_function; }
+		const std::vector<int64_t>& getArguments() const { return m_arguments; }
+
+	private:
+		std::string m_name;
+		BenchmarkFunction m_function;
+		std::vector<int64_t> m_arguments;
+	};
+
+	Benchmark* registerBenchmark(const std::string& _name, BenchmarkFunction _function);
+
+	// Options: --filter=<substring>, --min-time=<seconds>, --format=console|csv.
+	int runBenchmarks(int _argc, char** _argv);
+
+	// Keeps the compiler from discarding a result that is otherwise unused.
+	template<typename T>
+	inline void doNotOptimize(const T& _value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(_value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &_value;
+#endif
+	}
+}
+
+#define TRA_BENCH_CONCAT_INNER(a, b) a##b
+#define TRA_BENCH_CONCAT(a, b) TRA_BENCH_CONCAT_INNER(a, b)
+
+#define TRA_BENCHMARK(function) \
+	static ::tra::bench::Benchmark* TRA_BENCH_CONCAT(function##_benchmark_, __LINE__) = ::tra::bench::registerBenchmark(#function, function)
+
+#define TRA_BENCHMARK_TEMPLATE(function, type) \
+	static ::tra::bench::Benchmark* TRA_BENCH_CONCAT(function##_benchmark_, __LINE__) = ::tra::bench::registerBenchmark(#function "<" #type ">", function<type>)
+
+#endif
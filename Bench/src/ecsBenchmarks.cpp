@@ -0,0 +1,180 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#include "TRA/engine/networkEcs.hpp"
+#include "TRA/engine/INetworkComponent.hpp"
+
+using namespace tra;
+using namespace tra::engine;
+
+namespace
+{
+	struct BenchPositionComponent : public INetworkComponent
+	{
+		float m_x = 0.0f;
+		float m_y = 0.0f;
+		float m_z = 0.0f;
+	};
+
+	struct BenchHealthComponent : public INetworkComponent
+	{
+		int32_t m_health = 100;
+	};
+
+	// Removing from a SparseSet scans its index, so the removal benchmark
+	// only removes this many components from a store of the given size.
+	constexpr int64_t MAX_REMOVED_COMPONENTS = 256;
+
+	// Every entity gets a position, every other one a health component too.
+	void populate(NetworkEcs& _ecs, int64_t _count)
+	{
+		for (int64_t i = 0; i < _count; i++)
+		{
+			EntityId entityId = _ecs.createEntity();
+			_ecs.addComponentToEntity(entityId, std::make_shared<BenchPositionComponent>());
+			if (i % 2 == 0)
+			{
+				_ecs.addComponentToEntity(entityId, std::make_shared<BenchHealthComponent>());
+			}
+		}
+	}
+
+	// The argument of every benchmark below is the entity count; results are
+	// per entity.
+	void ecsCreateEntity(bench::State& _state)
+	{
+		int64_t count = _state.getArgument();
+		_state.setItemsPerIteration(static_cast<uint64_t>(count));
+
+		while (_state.keepRunning())
+		{
+			_state.pauseTiming();
+			std::unique_ptr<NetworkEcs> ecs = std::make_unique<NetworkEcs>();
+			_state.resumeTiming();
+
+			for (int64_t i = 0; i < count; i++)
+			{
+				bench::doNotOptimize(ecs->createEntity());
+			}
+
+			_state.pauseTiming();
+			ecs.reset();
+			_state.resumeTiming();
+		}
+	}
+
+	void ecsAddComponent(bench::State& _state)
+	{
+		int64_t count = _state.getArgument();
+		_state.setItemsPerIteration(static_cast<uint64_t>(count));
+
+		std::vector<std::shared_ptr<BenchPositionComponent>> components;
+
+		while (_state.keepRunning())
+		{
+			_state.pauseTiming();
+			std::unique_ptr<NetworkEcs> ecs = std::make_unique<NetworkEcs>();
+			for (int64_t i = 0; i < count; i++)
+			{
+				ecs->createEntity();
+			}
+
+			components.clear();
+			for (int64_t i = 0; i < count; i++)
+			{
+				components.push_back(std::make_shared<BenchPositionComponent>());
+			}
+			_state.resumeTiming();
+
+			for (int64_t i = 0; i < count; i++)
+			{
+				ecs->addComponentToEntity(static_cast<EntityId>(i + 1), std::move(components[static_cast<size_t>(i)]));
+			}
+
+			_state.pauseTiming();
+			ecs.reset();
+			_state.resumeTiming();
+		}
+	}
+
+	void ecsRemoveComponent(bench::State& _state)
+	{
+		int64_t count = _state.getArgument();
+		int64_t removed = (std::min)(count, MAX_REMOVED_COMPONENTS);
+		_state.setItemsPerIteration(static_cast<uint64_t>(removed));
+
+		while (_state.keepRunning())
+		{
+			_state.pauseTiming();
+			std::unique_ptr<NetworkEcs> ecs = std::make_unique<NetworkEcs>();
+			populate(*ecs, count);
+			_state.resumeTiming();
+
+			for (int64_t i = 0; i < removed; i++)
+			{
+				ecs->removeComponentFromEntity<BenchPositionComponent>(static_cast<EntityId>(i * (count / removed) + 1));
+			}
+
+			_state.pauseTiming();
+			ecs.reset();
+			_state.resumeTiming();
+		}
+	}
+
+	void ecsGetComponent(bench::State& _state)
+	{
+		int64_t count = _state.getArgument();
+		_state.setItemsPerIteration(static_cast<uint64_t>(count));
+
+		NetworkEcs ecs;
+		populate(ecs, count);
+
+		while (_state.keepRunning())
+		{
+			for (int64_t i = 0; i < count; i++)
+			{
+				auto getComponentResult = ecs.getComponentOfEntity<BenchPositionComponent>(static_cast<EntityId>(i + 1));
+				bench::doNotOptimize(getComponentResult);
+			}
+		}
+	}
+
+	void ecsQueryIds(bench::State& _state)
+	{
+		int64_t count = _state.getArgument();
+		_state.setItemsPerIteration(static_cast<uint64_t>(count));
+
+		NetworkEcs ecs;
+		populate(ecs, count);
+
+		while (_state.keepRunning())
+		{
+			std::vector<EntityId> entityIds = ecs.queryIds<BenchPositionComponent, BenchHealthComponent>();
+			bench::doNotOptimize(entityIds);
+		}
+	}
+
+	void ecsQuery(bench::State& _state)
+	{
+		int64_t count = _state.getArgument();
+		_state.setItemsPerIteration(static_cast<uint64_t>(count));
+
+		NetworkEcs ecs;
+		populate(ecs, count);
+
+		while (_state.keepRunning())
+		{
+			auto queryResult = ecs.query<BenchPositionComponent, BenchHealthComponent>();
+			bench::doNotOptimize(queryResult);
+		}
+	}
+}
+
+TRA_BENCHMARK(ecsCreateEntity)->range(1000, 1000000);
+TRA_BENCHMARK(ecsAddComponent)->range(1000, 1000000);
+TRA_BENCHMARK(ecsRemoveComponent)->range(1000, 1000000);
+TRA_BENCHMARK(ecsGetComponent)->range(1000, 1000000);
+TRA_BENCHMARK(ecsQueryIds)->range(1000, 1000000);
+TRA_BENCHMARK(ecsQuery)->range(1000, 1000000);
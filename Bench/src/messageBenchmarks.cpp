@@ -0,0 +1,165 @@
+#include "benchmark.hpp"
+
+#include "TRA/engine/message.hpp"
+
+#include "messageSerializer.hpp"
+
+using namespace tra;
+using namespace tra::engine;
+
+DECLARE_MESSAGE_BEGIN(BenchScalars)
+FIELD(int32_t, id)
+FIELD(uint64_t, tick)
+FIELD(float, x)
+FIELD(float, y)
+FIELD(float, z)
+FIELD(double, time)
+FIELD(bool, alive)
+FIELD(bool, grounded)
+DECLARE_MESSAGE_END()
+
+DECLARE_MESSAGE_BEGIN(BenchVarints)
+FIELD_VARINT(uint32_t, id)
+FIELD_VARINT(uint64_t, tick)
+FIELD_VARINT(int32_t, health)
+FIELD_VARINT(int32_t, score)
+DECLARE_MESSAGE_END()
+
+DECLARE_MESSAGE_BEGIN(BenchQuantized)
+FIELD_QUANTIZED_FLOAT(x, -1000.0f, 1000.0f, 0.01f)
+FIELD_QUANTIZED_FLOAT(y, -1000.0f, 1000.0f, 0.01f)
+FIELD_QUANTIZED_FLOAT(z, -1000.0f, 1000.0f, 0.01f)
+FIELD_QUATERNION(rotation, 10)
+FIELD_BOUNDED_INT(int32_t, health, 0, 100)
+DECLARE_MESSAGE_END()
+
+DECLARE_MESSAGE_BEGIN(BenchString)
+FIELD(std::string, name)
+FIELD(std::string, text)
+DECLARE_MESSAGE_END()
+
+DECLARE_MESSAGE_BEGIN(BenchArrays)
+FIELD(std::vector<float>, samples)
+FIELD(std::vector<uint32_t>, ids)
+FIELD_ARRAY(float, 16, matrix)
+DECLARE_MESSAGE_END()
+
+namespace
+{
+	void fill(message::BenchScalars& _message)
+	{
+		_message.id = 42;
+		_message.tick = 123456789;
+		_message.x = 1.5f;
+		_message.y = -2.25f;
+		_message.z = 300.0f;
+		_message.time = 12.5;
+		_message.alive = true;
+		_message.grounded = false;
+	}
+
+	void fill(message::BenchVarints& _message)
+	{
+		_message.id = 42;
+		_message.tick = 123456789;
+		_message.health = 87;
+		_message.score = -1500;
+	}
+
+	void fill(message::BenchQuantized& _message)
+	{
+		_message.x = 12.34f;
+		_message.y = -56.78f;
+		_message.z = 910.11f;
+		_message.rotation = Quaternion{ 0.0f, 0.7071f, 0.0f, 0.7071f };
+		_message.health = 87;
+	}
+
+	void fill(message::BenchString& _message)
+	{
+		_message.name = "Traveler";
+		_message.text = std::string(200, 'x');
+	}
+
+	void fill(message::BenchArrays& _message)
+	{
+		_message.samples.assign(256, 0.5f);
+		_message.ids.assign(64, 7u);
+		_message.matrix.fill(1.0f);
+	}
+
+	template<typename MessageType>
+	void messageSerialize(bench::State& _state)
+	{
+		MessageType message;
+		fill(message);
+
+		while (_state.keepRunning())
+		{
+			std::vector<uint8_t> payload = message.serialize();
+			bench::doNotOptimize(payload);
+		}
+	}
+
+	template<typename MessageType>
+	void messageCreateFromBytes(bench::State& _state)
+	{
+		MessageType message;
+		fill(message);
+		std::vector<uint8_t> payload = message.serialize();
+
+		while (_state.keepRunning())
+		{
+			std::unique_ptr<Message> decoded = MessageType::createFromBytes(payload);
+			bench::doNotOptimize(decoded);
+		}
+	}
+
+	// The argument is the payload size in bytes.
+	void serializeForNetwork(bench::State& _state)
+	{
+		std::vector<uint8_t> payload(static_cast<size_t>(_state.getArgument()), 0x5A);
+		MessageHeader header;
+		header.typeId = message::BenchString::MESSAGE_TYPE_ID;
+
+		while (_state.keepRunning())
+		{
+			std::vector<uint8_t> frame = MessageSerializer::serializeForNetwork(header, payload);
+			bench::doNotOptimize(frame);
+		}
+	}
+
+	void getPayloadFromNetworkBuffer(bench::State& _state)
+	{
+		std::vector<uint8_t> payload(static_cast<size_t>(_state.getArgument()), 0x5A);
+		MessageHeader header;
+		header.typeId = message::BenchString::MESSAGE_TYPE_ID;
+		std::vector<uint8_t> frame = MessageSerializer::serializeForNetwork(header, payload);
+
+		MessageHeader decodedHeader;
+		std::vector<uint8_t> decodedPayload;
+		size_t consumedBytes = 0;
+
+		while (_state.keepRunning())
+		{
+			bool result = MessageSerializer::getPayloadFromNetworkBuffer(frame, decodedHeader, decodedPayload, consumedBytes);
+			bench::doNotOptimize(result);
+			bench::doNotOptimize(decodedPayload);
+		}
+	}
+}
+
+TRA_BENCHMARK_TEMPLATE(messageSerialize, message::BenchScalars);
+TRA_BENCHMARK_TEMPLATE(messageSerialize, message::BenchVarints);
+TRA_BENCHMARK_TEMPLATE(messageSerialize, message::BenchQuantized);
+TRA_BENCHMARK_TEMPLATE(messageSerialize, message::BenchString);
+TRA_BENCHMARK_TEMPLATE(messageSerialize, message::BenchArrays);
+
+TRA_BENCHMARK_TEMPLATE(messageCreateFromBytes, message::BenchScalars);
+TRA_BENCHMARK_TEMPLATE(messageCreateFromBytes, message::BenchVarints);
+TRA_BENCHMARK_TEMPLATE(messageCreateFromBytes, message::BenchQuantized);
+TRA_BENCHMARK_TEMPLATE(messageCreateFromBytes, message::BenchString);
+TRA_BENCHMARK_TEMPLATE(messageCreateFromBytes, message::BenchArrays);
+
+TRA_BENCHMARK(serializeForNetwork)->range(16, 65536, 16);
+TRA_BENCHMARK(getPayloadFromNetworkBuffer)->range(16, 65536, 16);
@@ -16,6 +16,9 @@ namespace tra::client
 	class Client
 	{
 	public:
+		TRA_API explicit Client(const engine::NetworkEngineConfig& _config = engine::NetworkEngineConfig());
+		TRA_API ~Client();
+
 		Client(Client& other) = delete;
 		void operator=(const Client&) = delete;
 
@@ -31,6 +34,30 @@ namespace tra::client
 
 		TRA_API ErrorCode sendTcpMessage(std::shared_ptr<engine::Message> _message);
 		TRA_API std::vector<std::shared_ptr<engine::Message>> getTcpMessages(const std::string& _messageType);
+		TRA_API std::pair<ErrorCode, engine::ConnectionStats> getConnectionStats();
+
+		TRA_API bool IsUdpConnected();
+		TRA_API ErrorCode sendUdpMessage(std::shared_ptr<engine::Message> _message, engine::UdpChannel _channel);
+		TRA_API std::vector<std::shared_ptr<engine::Message>> getUdpMessages(const std::string& _messageType);
+
+		TRA_API core::MetricsSnapshot getMetricsSnapshot();
+		TRA_API ErrorCode dumpMetrics(const std::string& _path);
+		TRA_API ErrorCode startMetricsEndpoint(uint16_t _port);
+		TRA_API ErrorCode stopMetricsEndpoint();
+
+		TRA_API std::vector<engine::MessageLatency> getMessageLatencies() const;
+		TRA_API void resetMessageLatencies();
+
+		TRA_API std::vector<engine::SystemTiming> getTickProfile() const;
+		TRA_API void startTickTrace(size_t _maxEvents = 1 << 20);
+		TRA_API void stopTickTrace();
+		TRA_API ErrorCode writeTickTrace(const std::string& _path) const;
+
+		TRA_API ErrorCode startCapture(const std::string& _path);
+		TRA_API ErrorCode stopCapture();
+
+		TRA_API const engine::NetworkEngineConfig& getConfig() const;
+		TRA_API void setConfig(const engine::NetworkEngineConfig& _config);
 
 		template<typename ComponentType>
 		bool entityHasComponent(EntityId _entityId)
@@ -54,9 +81,6 @@ namespace tra::client
 		static Client* m_singleton;
 
 		engine::NetworkEngine* m_networkEngine;
-
-		Client();
-		~Client();
 	};
 }
 
@@ -7,14 +7,16 @@ namespace tra::client
 {
 	Client* Client::m_singleton = nullptr;
 
-	Client::Client()
+	Client::Client(const engine::NetworkEngineConfig& _config)
 	{
-		m_networkEngine = new engine::NetworkEngine;
+		m_networkEngine = new engine::NetworkEngine(_config);
 	}
 
 	Client::~Client()
 	{
 		Disconnect();
+
+		delete m_networkEngine;
 	}
 
 	Client* Client::Get()
@@ -50,12 +52,12 @@ namespace tra::client
 			return ec;
 		}
 
-		/*ec = m_networkEngine->startUdpOnPort(0, false);
+		ec = m_networkEngine->startUdpOnPort(0, false);
 		if (ec != ErrorCode::Success)
 		{
 			m_networkEngine->stopTcpConnect();
 			return ec;
-		}*/
+		}
 
 		TRA_INFO_LOG("Client: Successfully connected to server at %s:%d.", _address.c_str(), _port);
 		return ErrorCode::Success;
@@ -76,11 +78,11 @@ namespace tra::client
 		}
 
 		ErrorCode ecTcp = m_networkEngine->stopTcpConnect();
-		//ErrorCode ecUdp = m_networkEngine->stopUdp();
+		ErrorCode ecUdp = m_networkEngine->stopUdp();
 
-		if (ecTcp != ErrorCode::Success /*|| ecUdp != ErrorCode::Success*/)
+		if (ecTcp != ErrorCode::Success || ecUdp != ErrorCode::Success)
 		{
-			TRA_ERROR_LOG("Client: Disconnection encountered errors. TCP ErrorCode: %d", static_cast<int>(ecTcp));
+			TRA_ERROR_LOG("Client: Disconnection encountered errors. TCP ErrorCode: %d, UDP ErrorCode: %d", static_cast<int>(ecTcp), static_cast<int>(ecUdp));
 			return ErrorCode::DisconnectWithErrors;
 		}
 		else
@@ -134,4 +136,109 @@ namespace tra::client
 
 		return m_networkEngine->getTcpMessages(m_networkEngine->getSelfEntityId(), _messageType);
 	}
+
+	std::pair<ErrorCode, engine::ConnectionStats> Client::getConnectionStats()
+	{
+		if (!IsConnected())
+		{
+			return { ErrorCode::ClientNotConnected, engine::ConnectionStats() };
+		}
+
+		return m_networkEngine->getConnectionStats(m_networkEngine->getSelfEntityId());
+	}
+
+	bool Client::IsUdpConnected()
+	{
+		return m_networkEngine->isUdpConnected(m_networkEngine->getSelfEntityId());
+	}
+
+	ErrorCode Client::sendUdpMessage(std::shared_ptr<engine::Message> _message, engine::UdpChannel _channel)
+	{
+		if (!IsConnected())
+		{
+			return ErrorCode::ClientNotConnected;
+		}
+
+		return m_networkEngine->sendUdpMessage(m_networkEngine->getSelfEntityId(), _message, _channel);
+	}
+
+	std::vector<std::shared_ptr<engine::Message>> Client::getUdpMessages(const std::string& _messageType)
+	{
+		if (!IsConnected())
+		{
+			return {};
+		}
+
+		return m_networkEngine->getUdpMessages(m_networkEngine->getSelfEntityId(), _messageType);
+	}
+
+	core::MetricsSnapshot Client::getMetricsSnapshot()
+	{
+		return m_networkEngine->getMetricsSnapshot();
+	}
+
+	ErrorCode Client::dumpMetrics(const std::string& _path)
+	{
+		return m_networkEngine->dumpMetrics(_path);
+	}
+
+	ErrorCode Client::startMetricsEndpoint(uint16_t _port)
+	{
+		return m_networkEngine->startMetricsEndpoint(_port);
+	}
+
+	ErrorCode Client::stopMetricsEndpoint()
+	{
+		return m_networkEngine->stopMetricsEndpoint();
+	}
+
+	std::vector<engine::MessageLatency> Client::getMessageLatencies() const
+	{
+		return m_networkEngine->getMessageLatencies();
+	}
+
+	void Client::resetMessageLatencies()
+	{
+		m_networkEngine->resetMessageLatencies();
+	}
+
+	std::vector<engine::SystemTiming> Client::getTickProfile() const
+	{
+		return m_networkEngine->getTickProfile();
+	}
+
+	void Client::startTickTrace(size_t _maxEvents)
+	{
+		m_networkEngine->startTickTrace(_maxEvents);
+	}
+
+	void Client::stopTickTrace()
+	{
+		m_networkEngine->stopTickTrace();
+	}
+
+	ErrorCode Client::writeTickTrace(const std::string& _path) const
+	{
+		return m_networkEngine->writeTickTrace(_path);
+	}
+
+	ErrorCode Client::startCapture(const std::string& _path)
+	{
+		return m_networkEngine->startCapture(_path);
+	}
+
+	ErrorCode Client::stopCapture()
+	{
+		return m_networkEngine->stopCapture();
+	}
+
+	const engine::NetworkEngineConfig& Client::getConfig() const
+	{
+		return m_networkEngine->getConfig();
+	}
+
+	void Client::setConfig(const engine::NetworkEngineConfig& _config)
+	{
+		m_networkEngine->setConfig(_config);
+	}
 }
\ No newline at end of file
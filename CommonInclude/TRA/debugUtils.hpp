@@ -3,44 +3,53 @@
 
 #include <cassert>
 #include <type_traits>
-#include <iostream>
-#include <mutex>
-#include <sstream>
 
+#include "TRA/core/logger.hpp"
+
+#define TRA_LOG_LEVEL_DEBUG 0
+#define TRA_LOG_LEVEL_INFO 1
+#define TRA_LOG_LEVEL_ERROR 2
+#define TRA_LOG_LEVEL_NONE 3
+
+// Calls below TRA_LOG_LEVEL compile to nothing, arguments included.
+#ifndef TRA_LOG_LEVEL
 #ifdef NDEBUG
-#define TRA_ASSERT_REF_PTR_OR_COPIABLE(obj) ((void)0)
-#define TRA_DEBUG_LOG(fmt, ...) ((void)0)
+#define TRA_LOG_LEVEL TRA_LOG_LEVEL_INFO
+#else
+#define TRA_LOG_LEVEL TRA_LOG_LEVEL_DEBUG
+#endif
+#endif
 
+#define TRA_LOG_AT(level, fmt, ...) \
+	{ \
+		static tra::core::LogSite traLogSite(level, fmt); \
+		tra::core::Logger::log(traLogSite, ##__VA_ARGS__); \
+	}
+
+#ifdef NDEBUG
+#define TRA_ASSERT_REF_PTR_OR_COPIABLE(obj) ((void)0)
 #else
 #define TRA_ASSERT_REF_PTR_OR_COPIABLE(obj) \
 	static_assert(RefPtrOrTriviallyCopiable<decltype(obj)>().m_value && #obj " is not a reference, a pointer, or copyable")
-#define TRA_DEBUG_LOG(fmt, ...) \
-	{ \
-		char buffer[512]; \
-		snprintf(buffer, sizeof(buffer), fmt, ##__VA_ARGS__); \
-		std::stringstream ss; \
-		ss << "\033[34m[DEBUG]\033[0m " << buffer << "\n"; \
-		std::cout << ss.str(); \
-	}
 #endif
 
-#define TRA_INFO_LOG(fmt, ...) \
-	{ \
-		char buffer[512]; \
-		snprintf(buffer, sizeof(buffer), fmt, ##__VA_ARGS__); \
-		std::stringstream ss; \
-		ss << "\033[32m[INFO]\033[0m " << buffer << "\n"; \
-		std::cerr << ss.str(); \
-	}
+#if TRA_LOG_LEVEL <= TRA_LOG_LEVEL_DEBUG
+#define TRA_DEBUG_LOG(fmt, ...) TRA_LOG_AT(tra::core::LogLevel::Debug, fmt, ##__VA_ARGS__)
+#else
+#define TRA_DEBUG_LOG(fmt, ...) ((void)0)
+#endif
 
-#define TRA_ERROR_LOG(fmt, ...) \
-	{ \
-		char buffer[512]; \
-		snprintf(buffer, sizeof(buffer), fmt, ##__VA_ARGS__); \
-		std::stringstream ss; \
-		ss << "\033[31m[ERROR]\033[0m " << buffer << "\n"; \
-		std::cerr << ss.str(); \
-	}
+#if TRA_LOG_LEVEL <= TRA_LOG_LEVEL_INFO
+#define TRA_INFO_LOG(fmt, ...) TRA_LOG_AT(tra::core::LogLevel::Info, fmt, ##__VA_ARGS__)
+#else
+#define TRA_INFO_LOG(fmt, ...) ((void)0)
+#endif
+
+#if TRA_LOG_LEVEL <= TRA_LOG_LEVEL_ERROR
+#define TRA_ERROR_LOG(fmt, ...) TRA_LOG_AT(tra::core::LogLevel::Error, fmt, ##__VA_ARGS__)
+#else
+#define TRA_ERROR_LOG(fmt, ...) ((void)0)
+#endif
 
 	template<typename T>
 	struct RefPtrOrTriviallyCopiable
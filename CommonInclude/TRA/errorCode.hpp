@@ -14,6 +14,8 @@ namespace tra
 		// Server Error
 		ServerAlreadyStarted,
 		ServerNotRunning,
+		InvalidShardIndex,
+		ShardingNotSupported,
 
 		// Client Error
 		ClientAlreadyConnected,
@@ -24,6 +26,17 @@ namespace tra
 		InvalidIpAddress,
 		InvalidPortNumber,
 		InvalidComponent,
+		FrameSizeTooLarge,
+		ReceiveBufferFull,
+		SendQueueCongested,
+		UdpNotConnected,
+		UdpMessageTooLarge,
+		MetricsWriteFailed,
+		TickTraceWriteFailed,
+		CaptureAlreadyRunning,
+		CaptureOpenFailed,
+		CaptureWriteFailed,
+		CaptureInvalidFormat,
 
 		// Network ECS Error
 		EntityDoesNotHaveComponent,
@@ -50,6 +63,10 @@ namespace tra
 		SocketReceiveFailed,
 		SocketSetBlockingFailed,
 		SocketGetPortFailed,
+		SocketGetPeerAddressFailed,
+		SocketSetOptionFailed,
+		SocketOptionNotSupported,
+		SocketConnectInProgress,
 
 		// WSA Error
 		WSAStartupFailed
@@ -0,0 +1,54 @@
+#ifndef TRA_CORE_HDR_HISTOGRAM_HPP
+#define TRA_CORE_HDR_HISTOGRAM_HPP
+
+#include "TRA/export.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace tra::core
+{
+    // Log-linear histogram in the style of HdrHistogram. Values below
+    // SUB_BUCKET_COUNT are counted exactly; above that every power of two is
+    // split into SUB_BUCKET_COUNT / 2 linear buckets, so any recorded value is
+    // reported within 1/64 (about 1.6%) of itself. Values up to 2^MAX_EXPONENT
+    // (about 18 minutes in nanoseconds) are tracked, larger ones are clamped.
+    // Not thread-safe: meant to be owned by one engine thread.
+    class HdrHistogram
+    {
+    public:
+        static constexpr uint32_t SUB_BUCKET_BITS = 7;
+        static constexpr uint64_t SUB_BUCKET_COUNT = 1ull << SUB_BUCKET_BITS;
+        static constexpr uint64_t SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT / 2;
+        static constexpr uint32_t MAX_EXPONENT = 40;
+        static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKET_HALF_COUNT;
+
+        TRA_API HdrHistogram();
+
+        TRA_API void record(uint64_t _value);
+        TRA_API void merge(const HdrHistogram& _other);
+        TRA_API void reset();
+
+        uint64_t getCount() const { return m_count; }
+        uint64_t getMin() const { return m_count == 0 ? 0 : m_min; }
+        uint64_t getMax() const { return m_max; }
+        double getMean() const { return m_count == 0 ? 0.0 : static_cast<double>(m_sum) / static_cast<double>(m_count); }
+
+        // Highest value equivalent to the one at _percentile (0-100), capped
+        // at the largest value recorded.
+        TRA_API uint64_t getValueAtPercentile(double _percentile) const;
+
+        TRA_API static size_t getBucketIndex(uint64_t _value);
+        TRA_API static uint64_t getBucketUpperBound(size_t _index);
+
+    private:
+        std::vector<uint64_t> m_counts;
+        uint64_t m_count;
+        uint64_t m_sum;
+        uint64_t m_min;
+        uint64_t m_max;
+    };
+}
+
+#endif
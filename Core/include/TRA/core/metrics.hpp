@@ -0,0 +1,209 @@
+#ifndef TRA_CORE_METRICS_HPP
+#define TRA_CORE_METRICS_HPP
+
+#include "TRA/export.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "TRA/errorCode.hpp"
+
+namespace tra::core
+{
+    constexpr size_t METRIC_STRIPES = 16;
+
+    // Stable per-thread stripe index, handed out round robin on first use.
+    TRA_API size_t getMetricStripe();
+
+    // Each thread adds to its own cache line; reads sum every stripe, so writes
+    // never contend and reads are only as fresh as the last add.
+    class Counter
+    {
+    public:
+        void add(uint64_t _value = 1)
+        {
+            m_stripes[getMetricStripe()].m_value.fetch_add(_value, std::memory_order_relaxed);
+        }
+
+        uint64_t read() const
+        {
+            uint64_t total = 0;
+            for (const Stripe& stripe : m_stripes)
+            {
+                total += stripe.m_value.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+    private:
+        struct alignas(64) Stripe
+        {
+            std::atomic<uint64_t> m_value{ 0 };
+        };
+
+        Stripe m_stripes[METRIC_STRIPES];
+    };
+
+    class Gauge
+    {
+    public:
+        void set(int64_t _value)
+        {
+            m_value.store(_value, std::memory_order_relaxed);
+        }
+
+        void add(int64_t _value)
+        {
+            m_value.fetch_add(_value, std::memory_order_relaxed);
+        }
+
+        int64_t read() const
+        {
+            return m_value.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<int64_t> m_value{ 0 };
+    };
+
+    // Power-of-two buckets: bucket i counts values that need i bits, so its
+    // upper bound is 2^i - 1. The last bucket takes everything larger.
+    class Histogram
+    {
+    public:
+        static constexpr size_t BUCKET_COUNT = 33;
+
+        void record(uint64_t _value)
+        {
+            Stripe& stripe = m_stripes[getMetricStripe()];
+            stripe.m_buckets[getBucket(_value)].fetch_add(1, std::memory_order_relaxed);
+            stripe.m_sum.fetch_add(_value, std::memory_order_relaxed);
+        }
+
+        static size_t getBucket(uint64_t _value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            size_t bits = _value == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(_value));
+#else
+            size_t bits = 0;
+            while (_value != 0)
+            {
+                _value >>= 1;
+                bits++;
+            }
+#endif
+            return bits < BUCKET_COUNT - 1 ? bits : BUCKET_COUNT - 1;
+        }
+
+        static uint64_t getBucketUpperBound(size_t _bucket)
+        {
+            return (static_cast<uint64_t>(1) << _bucket) - 1;
+        }
+
+        void read(std::vector<uint64_t>& _outBuckets, uint64_t& _outSum) const
+        {
+            _outBuckets.assign(BUCKET_COUNT, 0);
+            _outSum = 0;
+            for (const Stripe& stripe : m_stripes)
+            {
+                for (size_t i = 0; i < BUCKET_COUNT; i++)
+                {
+                    _outBuckets[i] += stripe.m_buckets[i].load(std::memory_order_relaxed);
+                }
+                _outSum += stripe.m_sum.load(std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        struct alignas(64) Stripe
+        {
+            std::atomic<uint64_t> m_buckets[BUCKET_COUNT] = {};
+            std::atomic<uint64_t> m_sum{ 0 };
+        };
+
+        Stripe m_stripes[METRIC_STRIPES];
+    };
+
+    enum class MetricType : uint8_t
+    {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    struct MetricSample
+    {
+        std::string m_name;
+        std::string m_help;
+        std::string m_labels;
+        MetricType m_type = MetricType::Counter;
+        int64_t m_value = 0;
+
+        // Histograms only: per-bucket (not cumulative) counts and the sum.
+        std::vector<uint64_t> m_buckets;
+        uint64_t m_sum = 0;
+    };
+
+    struct MetricsSnapshot
+    {
+        std::vector<MetricSample> m_samples;
+
+        TRA_API const MetricSample* find(const std::string& _name, const std::string& _labels = std::string()) const;
+
+        TRA_API std::string toPrometheusText() const;
+
+        // Writes through a temporary file and a rename, so a scraper reading the
+        // file (e.g. the node_exporter textfile collector) never sees half of it.
+        TRA_API ErrorCode writeToFile(const std::string& _path) const;
+    };
+
+    // Owns metrics by name and label set. Registering is locked and meant for
+    // setup; the returned references stay valid for the registry's lifetime and
+    // are updated lock-free. Registering an existing name and label set returns
+    // the same metric.
+    class MetricsRegistry
+    {
+    public:
+        TRA_API MetricsRegistry();
+        TRA_API ~MetricsRegistry();
+
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        // _labels is the inside of a Prometheus label set, e.g. protocol="tcp".
+        TRA_API Counter& counter(const std::string& _name, const std::string& _help, const std::string& _labels = std::string());
+        TRA_API Gauge& gauge(const std::string& _name, const std::string& _help, const std::string& _labels = std::string());
+        TRA_API Histogram& histogram(const std::string& _name, const std::string& _help, const std::string& _labels = std::string());
+
+        // Appends the current value of every metric.
+        TRA_API void collect(MetricsSnapshot& _snapshot) const;
+
+        // Process-wide metrics that have no engine to belong to, such as socket
+        // system calls.
+        TRA_API static MetricsRegistry& getProcessRegistry();
+
+    private:
+        struct Entry
+        {
+            std::string m_name;
+            std::string m_help;
+            std::string m_labels;
+            MetricType m_type;
+            std::unique_ptr<Counter> m_counter;
+            std::unique_ptr<Gauge> m_gauge;
+            std::unique_ptr<Histogram> m_histogram;
+        };
+
+        Entry& getOrCreate(const std::string& _name, const std::string& _help, const std::string& _labels, MetricType _type);
+
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<Entry>> m_entries;
+    };
+}
+
+#endif
@@ -12,6 +12,9 @@ namespace tra::core
 	{
 		TRA_API bool isValidIpV4Address(const std::string& _address);
 		TRA_API bool isValidPort(uint16_t _port);
+		// Whether several sockets can listen on one port (SO_REUSEPORT), which
+		// Windows lacks.
+		TRA_API bool isReusePortSupported();
 	}
 }
 
@@ -24,6 +24,7 @@ namespace tra::core
     constexpr int SHUTDOWN_BOTH = SD_BOTH;
     constexpr int SOCKET_NOT_CONNECTED = WSAENOTCONN;
     constexpr int SOCKET_CONNECTION_RESET = WSAECONNRESET;
+    constexpr int SOCKET_CONNECT_IN_PROGRESS = WSAEWOULDBLOCK;
 }
 
 #elif defined(__unix__) || defined(__APPLE__)
@@ -47,6 +48,7 @@ namespace tra::core
     constexpr int SHUTDOWN_BOTH = SHUT_RDWR;
     constexpr int SOCKET_NOT_CONNECTED = ENOTCONN;
     constexpr int SOCKET_CONNECTION_RESET = ECONNRESET;
+    constexpr int SOCKET_CONNECT_IN_PROGRESS = EINPROGRESS;
 }
 
 #endif
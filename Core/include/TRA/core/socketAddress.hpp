@@ -0,0 +1,129 @@
+#ifndef TRA_CORE_SOCKET_ADDRESS_HPP
+#define TRA_CORE_SOCKET_ADDRESS_HPP
+
+#include "TRA/export.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <functional>
+
+#include "TRA/errorCode.hpp"
+#include "networkInclude.hpp"
+
+namespace tra::core
+{
+    // IPv4 or IPv6 endpoint stored inline, so it can be copied, compared and
+    // hashed without touching the heap. Only the family, port and address bytes
+    // take part in equality; padding in the storage is ignored.
+    class SocketAddress
+    {
+    public:
+        TRA_API SocketAddress();
+        TRA_API SocketAddress(const sockaddr* _address, socklen_t _length);
+
+        TRA_API static ErrorCode fromString(const std::string& _address, uint16_t _port, SocketAddress& _outAddress);
+
+        TRA_API std::string toString() const;
+        TRA_API uint16_t getPort() const;
+        TRA_API void setPort(uint16_t _port);
+
+        sockaddr* data() { return reinterpret_cast<sockaddr*>(&m_storage); }
+        const sockaddr* data() const { return reinterpret_cast<const sockaddr*>(&m_storage); }
+        socklen_t getLength() const { return m_length; }
+        socklen_t getCapacity() const { return static_cast<socklen_t>(sizeof(m_storage)); }
+        int getFamily() const { return m_storage.ss_family; }
+        bool isValid() const { return m_storage.ss_family == AF_INET || m_storage.ss_family == AF_INET6; }
+
+        // Called after the kernel filled data() in place (recvfrom, recvmmsg, getpeername).
+        void setLength(socklen_t _length) { m_length = _length; }
+
+        bool operator==(const SocketAddress& _other) const
+        {
+            if (m_storage.ss_family != _other.m_storage.ss_family)
+            {
+                return false;
+            }
+
+            if (m_storage.ss_family == AF_INET)
+            {
+                const sockaddr_in& left = reinterpret_cast<const sockaddr_in&>(m_storage);
+                const sockaddr_in& right = reinterpret_cast<const sockaddr_in&>(_other.m_storage);
+                return left.sin_port == right.sin_port && left.sin_addr.s_addr == right.sin_addr.s_addr;
+            }
+
+            if (m_storage.ss_family == AF_INET6)
+            {
+                const sockaddr_in6& left = reinterpret_cast<const sockaddr_in6&>(m_storage);
+                const sockaddr_in6& right = reinterpret_cast<const sockaddr_in6&>(_other.m_storage);
+                return left.sin6_port == right.sin6_port && left.sin6_scope_id == right.sin6_scope_id
+                    && std::memcmp(&left.sin6_addr, &right.sin6_addr, sizeof(left.sin6_addr)) == 0;
+            }
+
+            return m_length == _other.m_length && std::memcmp(&m_storage, &_other.m_storage, m_length) == 0;
+        }
+
+        bool operator!=(const SocketAddress& _other) const
+        {
+            return !(*this == _other);
+        }
+
+        size_t hash() const
+        {
+            uint64_t hash = 0xcbf29ce484222325ull ^ m_storage.ss_family;
+
+            if (m_storage.ss_family == AF_INET)
+            {
+                const sockaddr_in& address = reinterpret_cast<const sockaddr_in&>(m_storage);
+                hash = mix(hash, (static_cast<uint64_t>(address.sin_addr.s_addr) << 16) | address.sin_port);
+            }
+            else if (m_storage.ss_family == AF_INET6)
+            {
+                const sockaddr_in6& address = reinterpret_cast<const sockaddr_in6&>(m_storage);
+                uint64_t words[2];
+                std::memcpy(words, &address.sin6_addr, sizeof(words));
+                hash = mix(hash, words[0]);
+                hash = mix(hash, words[1]);
+                hash = mix(hash, (static_cast<uint64_t>(address.sin6_scope_id) << 16) | address.sin6_port);
+            }
+
+            return static_cast<size_t>(hash);
+        }
+
+    private:
+        static uint64_t mix(uint64_t _hash, uint64_t _value)
+        {
+            _hash ^= _value + 0x9e3779b97f4a7c15ull + (_hash << 6) + (_hash >> 2);
+            _hash ^= _hash >> 33;
+            _hash *= 0xff51afd7ed558ccdull;
+            _hash ^= _hash >> 33;
+            return _hash;
+        }
+
+        sockaddr_storage m_storage;
+        socklen_t m_length;
+    };
+
+    struct SocketAddressHash
+    {
+        size_t operator()(const SocketAddress& _address) const
+        {
+            return _address.hash();
+        }
+    };
+}
+
+namespace std
+{
+    template<>
+    struct hash<tra::core::SocketAddress>
+    {
+        size_t operator()(const tra::core::SocketAddress& _address) const
+        {
+            return _address.hash();
+        }
+    };
+}
+
+#endif
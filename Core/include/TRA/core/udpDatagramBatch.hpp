@@ -0,0 +1,69 @@
+#ifndef TRA_CORE_UDP_DATAGRAM_BATCH_HPP
+#define TRA_CORE_UDP_DATAGRAM_BATCH_HPP
+
+#include "TRA/export.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "networkInclude.hpp"
+#include "socketAddress.hpp"
+
+#if defined(__linux__)
+#include <sys/uio.h>
+#endif
+
+namespace tra::core
+{
+    // One slot of a UdpDatagramBatch. m_data points into the batch storage and
+    // holds up to getSlotCapacity() bytes. A non-zero m_segmentSize means the slot
+    // carries several datagrams of that size back to back, the last one possibly
+    // shorter (GSO on send, GRO on receive). m_receiveDelayNs is how long the
+    // datagram waited in the kernel before receiveBatch, when kernel
+    // timestamping is enabled on the socket.
+    struct UdpDatagram
+    {
+        uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        SocketAddress m_address;
+        uint16_t m_segmentSize = 0;
+        uint64_t m_receiveDelayNs = 0;
+    };
+
+    class UdpDatagramBatch
+    {
+    public:
+        static constexpr size_t MAX_DATAGRAM_SIZE = 65535;
+        static constexpr size_t MAX_SEGMENTED_PAYLOAD = 65507;
+        static constexpr size_t MAX_SEGMENTS = 64;
+
+        TRA_API UdpDatagramBatch(size_t _slotCount, size_t _slotCapacity);
+
+        UdpDatagramBatch(const UdpDatagramBatch&) = delete;
+        UdpDatagramBatch& operator=(const UdpDatagramBatch&) = delete;
+
+        TRA_API UdpDatagram& operator[](size_t _index);
+        TRA_API const UdpDatagram& operator[](size_t _index) const;
+        TRA_API size_t getSlotCount() const;
+        TRA_API size_t getSlotCapacity() const;
+
+    private:
+        friend class UdpSocket;
+
+        std::vector<uint8_t> m_storage;
+        std::vector<UdpDatagram> m_slots;
+        size_t m_slotCapacity;
+
+#if defined(__linux__)
+        // Room for a UDP_GRO and an SCM_TIMESTAMPING message.
+        static constexpr size_t CONTROL_SIZE = 128;
+
+        std::vector<mmsghdr> m_headers;
+        std::vector<iovec> m_iovecs;
+        std::vector<uint8_t> m_control;
+#endif
+    };
+}
+
+#endif
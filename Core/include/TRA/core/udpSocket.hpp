@@ -9,6 +9,8 @@
 
 #include "TRA/errorCode.hpp"
 #include "networkInclude.hpp"
+#include "socketAddress.hpp"
+#include "udpDatagramBatch.hpp"
 
 namespace tra::core
 {
@@ -18,15 +20,26 @@ namespace tra::core
         TRA_API UdpSocket();
         TRA_API ~UdpSocket();
 
-        TRA_API static sockaddr* createSockAddr(const std::string& _address, uint16_t _port);
-
         TRA_API void closeSocket();
         TRA_API std::pair<ErrorCode, int> bindSocket(const uint16_t _port);
-        TRA_API std::pair<ErrorCode, int> sendDataTo(const void* _data, size_t _size, const sockaddr* _destAddr);
-        TRA_API std::pair<ErrorCode, int> receiveDataFrom(void* _buffer, size_t _size, sockaddr* _srcAddr);
+        TRA_API std::pair<ErrorCode, int> sendDataTo(const void* _data, size_t _size, const SocketAddress& _destAddr);
+        TRA_API std::pair<ErrorCode, int> receiveDataFrom(void* _buffer, size_t _size, SocketAddress& _outSrcAddr);
+        // A datagram the socket refuses is skipped and counted in _outDropped;
+        // the rest of the batch is still sent. Returns SocketSendFailed with the
+        // last error when any were dropped.
+        TRA_API std::pair<ErrorCode, int> sendBatch(UdpDatagramBatch& _batch, size_t _count, size_t& _outDropped);
+        TRA_API std::pair<ErrorCode, int> receiveBatch(UdpDatagramBatch& _batch, size_t _maxCount);
+        TRA_API std::pair<ErrorCode, int> setSegmentationOffload(bool _enabled);
+        TRA_API std::pair<ErrorCode, int> setReceiveOffload(bool _enabled);
+        // Linux SO_TIMESTAMPING software receive timestamps, reported per
+        // datagram by receiveBatch.
+        TRA_API std::pair<ErrorCode, int> setKernelTimestamping(bool _enabled);
         TRA_API std::pair<ErrorCode, int> setBlocking(bool _blocking);
         TRA_API std::pair<ErrorCode, uint16_t> getPort();
         TRA_API bool isBlocking();
+        TRA_API bool isSegmentationOffloadEnabled() const;
+        TRA_API bool isReceiveOffloadEnabled() const;
+        TRA_API bool isKernelTimestamping() const;
         TRA_API bool isOpen() const;
 
     private:
@@ -34,6 +47,9 @@ namespace tra::core
         mutable std::mutex m_mutex;
         uint16_t m_port;
         bool m_isBlocking;
+        bool m_segmentationOffload;
+        bool m_receiveOffload;
+        bool m_kernelTimestamping;
     };
 }
 
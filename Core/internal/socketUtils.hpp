@@ -6,15 +6,31 @@
 
 #include "TRA/errorCode.hpp"
 #include "TRA/core/networkInclude.hpp"
+#include "TRA/core/metrics.hpp"
 
 namespace tra::core
 {
+    // System call counters shared by every socket of one protocol, registered in
+    // the process registry.
+    struct SocketMetrics
+    {
+        Counter& m_sendCalls;
+        Counter& m_receiveCalls;
+        Counter& m_bytesSent;
+        Counter& m_bytesReceived;
+        Counter& m_wouldBlock;
+        Counter& m_errors;
+    };
+
     namespace SocketUtils
     {
         int getLastSocketError();
         bool isWouldBlockError(int _err);
         std::pair<ErrorCode, int> setBlocking(socket_t& _socket, bool _blocking);
         std::pair<ErrorCode, uint16_t> getSocketPort(socket_t& _socket);
+
+        SocketMetrics& getTcpMetrics();
+        SocketMetrics& getUdpMetrics();
     }
 }
 
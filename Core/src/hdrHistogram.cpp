@@ -0,0 +1,111 @@
+#include "TRA/core/hdrHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tra::core
+{
+    namespace
+    {
+        uint32_t floorLog2(uint64_t _value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<uint32_t>(63 - __builtin_clzll(_value));
+#else
+            uint32_t bits = 0;
+            while (_value >>= 1)
+            {
+                bits++;
+            }
+            return bits;
+#endif
+        }
+    }
+
+    HdrHistogram::HdrHistogram()
+        : m_counts(BUCKET_COUNT, 0), m_count(0), m_sum(0), m_min(UINT64_MAX), m_max(0)
+    {
+    }
+
+    size_t HdrHistogram::getBucketIndex(uint64_t _value)
+    {
+        if (_value < SUB_BUCKET_COUNT)
+        {
+            return static_cast<size_t>(_value);
+        }
+
+        uint32_t exponent = (std::min)(floorLog2(_value), MAX_EXPONENT);
+        uint32_t shift = exponent - (SUB_BUCKET_BITS - 1);
+        uint64_t subBucket = (std::min)(_value >> shift, SUB_BUCKET_COUNT - 1);
+
+        return static_cast<size_t>(SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF_COUNT + (subBucket - SUB_BUCKET_HALF_COUNT));
+    }
+
+    uint64_t HdrHistogram::getBucketUpperBound(size_t _index)
+    {
+        if (_index < SUB_BUCKET_COUNT)
+        {
+            return _index;
+        }
+
+        uint64_t offset = _index - SUB_BUCKET_COUNT;
+        uint32_t shift = static_cast<uint32_t>(offset / SUB_BUCKET_HALF_COUNT) + 1;
+        uint64_t subBucket = offset % SUB_BUCKET_HALF_COUNT + SUB_BUCKET_HALF_COUNT;
+
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+    void HdrHistogram::record(uint64_t _value)
+    {
+        m_counts[getBucketIndex(_value)]++;
+        m_count++;
+        m_sum += _value;
+        m_min = (std::min)(m_min, _value);
+        m_max = (std::max)(m_max, _value);
+    }
+
+    void HdrHistogram::merge(const HdrHistogram& _other)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            m_counts[i] += _other.m_counts[i];
+        }
+
+        m_count += _other.m_count;
+        m_sum += _other.m_sum;
+        m_min = (std::min)(m_min, _other.m_min);
+        m_max = (std::max)(m_max, _other.m_max);
+    }
+
+    void HdrHistogram::reset()
+    {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_count = 0;
+        m_sum = 0;
+        m_min = UINT64_MAX;
+        m_max = 0;
+    }
+
+    uint64_t HdrHistogram::getValueAtPercentile(double _percentile) const
+    {
+        if (m_count == 0)
+        {
+            return 0;
+        }
+
+        double fraction = (std::min)((std::max)(_percentile, 0.0), 100.0) / 100.0;
+        uint64_t target = (std::max)(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_count))), static_cast<uint64_t>(1));
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            cumulative += m_counts[i];
+            if (cumulative >= target)
+            {
+                return (std::min)(getBucketUpperBound(i), m_max);
+            }
+        }
+
+        return m_max;
+    }
+}
@@ -0,0 +1,367 @@
+#include "TRA/core/logger.hpp"
+
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+
+namespace tra::core
+{
+    namespace
+    {
+        constexpr size_t RING_CAPACITY = 4096;
+        constexpr uint32_t DEFAULT_RATE_LIMIT = 20;
+        constexpr int64_t RATE_WINDOW_MS = 1000;
+
+        struct alignas(64) RingSlot
+        {
+            std::atomic<size_t> m_sequence;
+            LogRecord m_record;
+        };
+
+        struct LoggerState
+        {
+            LoggerState()
+                : m_slots(RING_CAPACITY), m_enqueuePosition(0), m_dequeuePosition(0),
+                m_dropped(0), m_rateLimit(DEFAULT_RATE_LIMIT), m_stopped(false)
+            {
+                for (size_t i = 0; i < RING_CAPACITY; i++)
+                {
+                    m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            std::vector<RingSlot> m_slots;
+            alignas(64) std::atomic<size_t> m_enqueuePosition;
+            alignas(64) size_t m_dequeuePosition;
+            std::atomic<uint64_t> m_dropped;
+            std::atomic<uint32_t> m_rateLimit;
+            std::atomic<bool> m_stopped;
+
+            // Serializes consumers: the writer thread, flush() and the exit hook.
+            std::mutex m_drainMutex;
+            std::string m_line;
+        };
+
+        LoggerState& getState();
+
+        const char* levelPrefix(LogLevel _level)
+        {
+            switch (_level)
+            {
+            case LogLevel::Debug:
+                return "\033[34m[DEBUG]\033[0m ";
+            case LogLevel::Info:
+                return "\033[32m[INFO]\033[0m ";
+            default:
+                return "\033[31m[ERROR]\033[0m ";
+            }
+        }
+
+        // Formats one conversion. The length modifier written at the call site
+        // (including MSVC's I32/I64) is replaced by one matching the captured
+        // 64-bit value, so the output no longer depends on the platform's printf.
+        void appendConversion(std::string& _out, const std::string& _flags, char _conversion, const LogRecord& _record, uint8_t& _argIndex)
+        {
+            if (_argIndex >= _record.m_argCount)
+            {
+                _out += "<missing>";
+                return;
+            }
+
+            LogArgType type = _record.m_argTypes[_argIndex];
+            uint64_t value = _record.m_args[_argIndex];
+            _argIndex++;
+
+            char buffer[256];
+            std::string spec = "%" + _flags;
+            int written = 0;
+
+            switch (_conversion)
+            {
+            case 'd':
+            case 'i':
+                spec += "lld";
+                written = std::snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<long long>(value));
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                spec += "ll";
+                spec += _conversion;
+                written = std::snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<unsigned long long>(value));
+                break;
+            case 'c':
+                spec += 'c';
+                written = std::snprintf(buffer, sizeof(buffer), spec.c_str(), static_cast<int>(value));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+            {
+                double number;
+                if (type == LogArgType::Double)
+                {
+                    std::memcpy(&number, &value, sizeof(number));
+                }
+                else
+                {
+                    number = type == LogArgType::Signed ? static_cast<double>(static_cast<int64_t>(value)) : static_cast<double>(value);
+                }
+                spec += _conversion;
+                written = std::snprintf(buffer, sizeof(buffer), spec.c_str(), number);
+                break;
+            }
+            case 's':
+                if (type != LogArgType::String)
+                {
+                    _out += "<not a string>";
+                    return;
+                }
+                spec += 's';
+                written = std::snprintf(buffer, sizeof(buffer), spec.c_str(), _record.m_text + value);
+                break;
+            case 'p':
+                written = std::snprintf(buffer, sizeof(buffer), "%p", reinterpret_cast<void*>(static_cast<uintptr_t>(value)));
+                break;
+            default:
+                _out += spec;
+                _out += _conversion;
+                return;
+            }
+
+            if (written > 0)
+            {
+                _out.append(buffer, (std::min)(static_cast<size_t>(written), sizeof(buffer) - 1));
+            }
+        }
+
+        void formatRecord(std::string& _out, const LogRecord& _record)
+        {
+            _out += levelPrefix(_record.m_site->m_level);
+
+            uint8_t argIndex = 0;
+            const char* cursor = _record.m_site->m_format;
+            while (*cursor != '\0')
+            {
+                if (*cursor != '%')
+                {
+                    _out += *cursor++;
+                    continue;
+                }
+
+                cursor++;
+                if (*cursor == '%')
+                {
+                    _out += '%';
+                    cursor++;
+                    continue;
+                }
+
+                std::string flags;
+                while (*cursor != '\0' && std::strchr("-+ #0123456789.", *cursor) != nullptr)
+                {
+                    flags += *cursor++;
+                }
+
+                while (*cursor != '\0' && std::strchr("hlzjtLqI", *cursor) != nullptr)
+                {
+                    if (*cursor == 'I' && (std::strncmp(cursor, "I32", 3) == 0 || std::strncmp(cursor, "I64", 3) == 0))
+                    {
+                        cursor += 3;
+                        continue;
+                    }
+                    cursor++;
+                }
+
+                if (*cursor == '\0')
+                {
+                    break;
+                }
+
+                appendConversion(_out, flags, *cursor++, _record, argIndex);
+            }
+
+            if (_record.m_suppressed > 0)
+            {
+                _out += " (" + std::to_string(_record.m_suppressed) + " similar messages suppressed)";
+            }
+
+            _out += '\n';
+        }
+
+        void writeRecord(std::string& _line, const LogRecord& _record)
+        {
+            _line.clear();
+            formatRecord(_line, _record);
+
+            std::FILE* stream = _record.m_site->m_level == LogLevel::Debug ? stdout : stderr;
+            std::fwrite(_line.data(), 1, _line.size(), stream);
+        }
+
+        bool tryDequeue(LoggerState& _state, LogRecord& _outRecord)
+        {
+            RingSlot& slot = _state.m_slots[_state.m_dequeuePosition & (RING_CAPACITY - 1)];
+            size_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+            if (sequence != _state.m_dequeuePosition + 1)
+            {
+                return false;
+            }
+
+            _outRecord = slot.m_record;
+            slot.m_sequence.store(_state.m_dequeuePosition + RING_CAPACITY, std::memory_order_release);
+            _state.m_dequeuePosition++;
+            return true;
+        }
+
+        size_t drain(LoggerState& _state)
+        {
+            std::lock_guard<std::mutex> lock(_state.m_drainMutex);
+
+            size_t drained = 0;
+            LogRecord record;
+            while (tryDequeue(_state, record))
+            {
+                writeRecord(_state.m_line, record);
+                drained++;
+            }
+
+            uint64_t dropped = _state.m_dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0)
+            {
+                std::fprintf(stderr, "%sLogger: %llu records dropped, log ring was full.\n", levelPrefix(LogLevel::Error), static_cast<unsigned long long>(dropped));
+            }
+
+            if (drained > 0 || dropped > 0)
+            {
+                std::fflush(stdout);
+                std::fflush(stderr);
+            }
+
+            return drained;
+        }
+
+        void runWriter(LoggerState* _state)
+        {
+            while (!_state->m_stopped.load(std::memory_order_acquire))
+            {
+                if (drain(*_state) == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+        }
+
+        void stopAtExit()
+        {
+            LoggerState& state = getState();
+            state.m_stopped.store(true, std::memory_order_release);
+            drain(state);
+        }
+
+        // Never destroyed, so log calls made during static destruction still find
+        // it. After exit starts, records are written on the calling thread.
+        LoggerState& getState()
+        {
+            static LoggerState* state = []()
+            {
+                LoggerState* newState = new LoggerState();
+                std::thread(runWriter, newState).detach();
+                std::atexit(stopAtExit);
+                return newState;
+            }();
+
+            return *state;
+        }
+
+        int64_t nowMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    namespace Logger
+    {
+        bool admit(LogSite& _site, uint32_t& _outSuppressed)
+        {
+            uint32_t rateLimit = getState().m_rateLimit.load(std::memory_order_relaxed);
+            if (rateLimit != 0)
+            {
+                int64_t now = nowMs();
+                int64_t windowStart = _site.m_windowStartMs.load(std::memory_order_relaxed);
+                if (now - windowStart >= RATE_WINDOW_MS && _site.m_windowStartMs.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+                {
+                    _site.m_windowCount.store(0, std::memory_order_relaxed);
+                }
+
+                if (_site.m_windowCount.fetch_add(1, std::memory_order_relaxed) >= rateLimit)
+                {
+                    _site.m_suppressed.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            _outSuppressed = _site.m_suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        void submit(const LogRecord& _record)
+        {
+            LoggerState& state = getState();
+
+            if (state.m_stopped.load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock(state.m_drainMutex);
+                writeRecord(state.m_line, _record);
+                return;
+            }
+
+            size_t position = state.m_enqueuePosition.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                RingSlot& slot = state.m_slots[position & (RING_CAPACITY - 1)];
+                size_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+                intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+                if (difference == 0)
+                {
+                    if (state.m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.m_record = _record;
+                        slot.m_sequence.store(position + 1, std::memory_order_release);
+                        return;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    state.m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                else
+                {
+                    position = state.m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void setRateLimit(uint32_t _maxPerSitePerSecond)
+        {
+            getState().m_rateLimit.store(_maxPerSitePerSecond, std::memory_order_relaxed);
+        }
+
+        void flush()
+        {
+            drain(getState());
+        }
+    }
+}
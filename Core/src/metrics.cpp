@@ -0,0 +1,232 @@
+#include "TRA/core/metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace tra::core
+{
+    size_t getMetricStripe()
+    {
+        static std::atomic<size_t> nextStripe{ 0 };
+        thread_local size_t stripe = nextStripe.fetch_add(1, std::memory_order_relaxed) % METRIC_STRIPES;
+        return stripe;
+    }
+
+    namespace
+    {
+        const char* typeName(MetricType _type)
+        {
+            switch (_type)
+            {
+            case MetricType::Counter:
+                return "counter";
+            case MetricType::Gauge:
+                return "gauge";
+            default:
+                return "histogram";
+            }
+        }
+
+        void appendSeries(std::string& _out, const std::string& _name, const std::string& _labels, const std::string& _extraLabel, const std::string& _value)
+        {
+            _out += _name;
+            if (!_labels.empty() || !_extraLabel.empty())
+            {
+                _out += '{';
+                _out += _labels;
+                if (!_labels.empty() && !_extraLabel.empty())
+                {
+                    _out += ',';
+                }
+                _out += _extraLabel;
+                _out += '}';
+            }
+            _out += ' ';
+            _out += _value;
+            _out += '\n';
+        }
+    }
+
+    const MetricSample* MetricsSnapshot::find(const std::string& _name, const std::string& _labels) const
+    {
+        for (const MetricSample& sample : m_samples)
+        {
+            if (sample.m_name == _name && sample.m_labels == _labels)
+            {
+                return &sample;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::string MetricsSnapshot::toPrometheusText() const
+    {
+        std::vector<const MetricSample*> samples;
+        samples.reserve(m_samples.size());
+        for (const MetricSample& sample : m_samples)
+        {
+            samples.push_back(&sample);
+        }
+
+        // Series of one family must be contiguous under a single HELP/TYPE.
+        std::stable_sort(samples.begin(), samples.end(), [](const MetricSample* _left, const MetricSample* _right)
+            {
+                return _left->m_name < _right->m_name;
+            });
+
+        std::string text;
+        const std::string* previousName = nullptr;
+
+        for (const MetricSample* sample : samples)
+        {
+            if (previousName == nullptr || *previousName != sample->m_name)
+            {
+                text += "# HELP " + sample->m_name + " " + sample->m_help + "\n";
+                text += "# TYPE " + sample->m_name + " " + typeName(sample->m_type) + "\n";
+                previousName = &sample->m_name;
+            }
+
+            if (sample->m_type != MetricType::Histogram)
+            {
+                appendSeries(text, sample->m_name, sample->m_labels, std::string(), std::to_string(sample->m_value));
+                continue;
+            }
+
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < sample->m_buckets.size(); i++)
+            {
+                cumulative += sample->m_buckets[i];
+                std::string bound = i + 1 < sample->m_buckets.size() ? std::to_string(Histogram::getBucketUpperBound(i)) : std::string("+Inf");
+                appendSeries(text, sample->m_name + "_bucket", sample->m_labels, "le=\"" + bound + "\"", std::to_string(cumulative));
+            }
+
+            appendSeries(text, sample->m_name + "_sum", sample->m_labels, std::string(), std::to_string(sample->m_sum));
+            appendSeries(text, sample->m_name + "_count", sample->m_labels, std::string(), std::to_string(cumulative));
+        }
+
+        return text;
+    }
+
+    ErrorCode MetricsSnapshot::writeToFile(const std::string& _path) const
+    {
+        std::string temporaryPath = _path + ".tmp";
+        std::string text = toPrometheusText();
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return ErrorCode::MetricsWriteFailed;
+            }
+
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+            if (!file)
+            {
+                return ErrorCode::MetricsWriteFailed;
+            }
+        }
+
+#ifdef _WIN32
+        std::remove(_path.c_str());
+#endif
+        if (std::rename(temporaryPath.c_str(), _path.c_str()) != 0)
+        {
+            std::remove(temporaryPath.c_str());
+            return ErrorCode::MetricsWriteFailed;
+        }
+
+        return ErrorCode::Success;
+    }
+
+    MetricsRegistry::MetricsRegistry() = default;
+
+    MetricsRegistry::~MetricsRegistry() = default;
+
+    Counter& MetricsRegistry::counter(const std::string& _name, const std::string& _help, const std::string& _labels)
+    {
+        return *getOrCreate(_name, _help, _labels, MetricType::Counter).m_counter;
+    }
+
+    Gauge& MetricsRegistry::gauge(const std::string& _name, const std::string& _help, const std::string& _labels)
+    {
+        return *getOrCreate(_name, _help, _labels, MetricType::Gauge).m_gauge;
+    }
+
+    Histogram& MetricsRegistry::histogram(const std::string& _name, const std::string& _help, const std::string& _labels)
+    {
+        return *getOrCreate(_name, _help, _labels, MetricType::Histogram).m_histogram;
+    }
+
+    void MetricsRegistry::collect(MetricsSnapshot& _snapshot) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const std::unique_ptr<Entry>& entry : m_entries)
+        {
+            MetricSample sample;
+            sample.m_name = entry->m_name;
+            sample.m_help = entry->m_help;
+            sample.m_labels = entry->m_labels;
+            sample.m_type = entry->m_type;
+
+            switch (entry->m_type)
+            {
+            case MetricType::Counter:
+                sample.m_value = static_cast<int64_t>(entry->m_counter->read());
+                break;
+            case MetricType::Gauge:
+                sample.m_value = entry->m_gauge->read();
+                break;
+            case MetricType::Histogram:
+                entry->m_histogram->read(sample.m_buckets, sample.m_sum);
+                break;
+            }
+
+            _snapshot.m_samples.push_back(std::move(sample));
+        }
+    }
+
+    MetricsRegistry& MetricsRegistry::getProcessRegistry()
+    {
+        // Never destroyed: sockets closed during static destruction still count.
+        static MetricsRegistry* registry = new MetricsRegistry();
+        return *registry;
+    }
+
+    MetricsRegistry::Entry& MetricsRegistry::getOrCreate(const std::string& _name, const std::string& _help, const std::string& _labels, MetricType _type)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (std::unique_ptr<Entry>& entry : m_entries)
+        {
+            if (entry->m_name == _name && entry->m_labels == _labels && entry->m_type == _type)
+            {
+                return *entry;
+            }
+        }
+
+        std::unique_ptr<Entry> entry = std::make_unique<Entry>();
+        entry->m_name = _name;
+        entry->m_help = _help;
+        entry->m_labels = _labels;
+        entry->m_type = _type;
+
+        switch (_type)
+        {
+        case MetricType::Counter:
+            entry->m_counter = std::make_unique<Counter>();
+            break;
+        case MetricType::Gauge:
+            entry->m_gauge = std::make_unique<Gauge>();
+            break;
+        case MetricType::Histogram:
+            entry->m_histogram = std::make_unique<Histogram>();
+            break;
+        }
+
+        m_entries.push_back(std::move(entry));
+        return *m_entries.back();
+    }
+}
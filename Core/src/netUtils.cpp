@@ -20,5 +20,14 @@ namespace tra::core
 		{
 			return _port <= 65535;
 		}
+
+		bool isReusePortSupported()
+		{
+#if defined(SO_REUSEPORT)
+			return true;
+#else
+			return false;
+#endif
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "TRA/core/socketAddress.hpp"
+
+#include <algorithm>
+
+#include "TRA/debugUtils.hpp"
+
+namespace tra::core
+{
+    SocketAddress::SocketAddress()
+    {
+        std::memset(&m_storage, 0, sizeof(m_storage));
+        m_length = 0;
+    }
+
+    SocketAddress::SocketAddress(const sockaddr* _address, socklen_t _length)
+    {
+        std::memset(&m_storage, 0, sizeof(m_storage));
+        m_length = (std::min)(_length, static_cast<socklen_t>(sizeof(m_storage)));
+
+        if (_address != nullptr)
+        {
+            std::memcpy(&m_storage, _address, m_length);
+        }
+    }
+
+    ErrorCode SocketAddress::fromString(const std::string& _address, uint16_t _port, SocketAddress& _outAddress)
+    {
+        TRA_ASSERT_REF_PTR_OR_COPIABLE(_address);
+
+        _outAddress = SocketAddress();
+
+        sockaddr_in& address4 = reinterpret_cast<sockaddr_in&>(_outAddress.m_storage);
+        if (inet_pton(AF_INET, _address.c_str(), &address4.sin_addr) == 1)
+        {
+            address4.sin_family = AF_INET;
+            address4.sin_port = htons(_port);
+            _outAddress.m_length = sizeof(sockaddr_in);
+            return ErrorCode::Success;
+        }
+
+        _outAddress = SocketAddress();
+
+        sockaddr_in6& address6 = reinterpret_cast<sockaddr_in6&>(_outAddress.m_storage);
+        if (inet_pton(AF_INET6, _address.c_str(), &address6.sin6_addr) == 1)
+        {
+            address6.sin6_family = AF_INET6;
+            address6.sin6_port = htons(_port);
+            _outAddress.m_length = sizeof(sockaddr_in6);
+            return ErrorCode::Success;
+        }
+
+        _outAddress = SocketAddress();
+        return ErrorCode::InvalidIpAddress;
+    }
+
+    std::string SocketAddress::toString() const
+    {
+        char buffer[INET6_ADDRSTRLEN] = {};
+
+        if (m_storage.ss_family == AF_INET)
+        {
+            const sockaddr_in& address = reinterpret_cast<const sockaddr_in&>(m_storage);
+            inet_ntop(AF_INET, &address.sin_addr, buffer, sizeof(buffer));
+            return std::string(buffer) + ":" + std::to_string(ntohs(address.sin_port));
+        }
+
+        if (m_storage.ss_family == AF_INET6)
+        {
+            const sockaddr_in6& address = reinterpret_cast<const sockaddr_in6&>(m_storage);
+            inet_ntop(AF_INET6, &address.sin6_addr, buffer, sizeof(buffer));
+            return "[" + std::string(buffer) + "]:" + std::to_string(ntohs(address.sin6_port));
+        }
+
+        return std::string();
+    }
+
+    uint16_t SocketAddress::getPort() const
+    {
+        if (m_storage.ss_family == AF_INET)
+        {
+            return ntohs(reinterpret_cast<const sockaddr_in&>(m_storage).sin_port);
+        }
+
+        if (m_storage.ss_family == AF_INET6)
+        {
+            return ntohs(reinterpret_cast<const sockaddr_in6&>(m_storage).sin6_port);
+        }
+
+        return 0;
+    }
+
+    void SocketAddress::setPort(uint16_t _port)
+    {
+        if (m_storage.ss_family == AF_INET)
+        {
+            reinterpret_cast<sockaddr_in&>(m_storage).sin_port = htons(_port);
+        }
+        else if (m_storage.ss_family == AF_INET6)
+        {
+            reinterpret_cast<sockaddr_in6&>(m_storage).sin6_port = htons(_port);
+        }
+    }
+}
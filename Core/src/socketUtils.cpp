@@ -74,4 +74,34 @@ namespace tra::core
 
 		return { ErrorCode::SocketGetPortFailed, 0 };
 	}
-}
\ No newline at end of file
+
+	namespace
+	{
+		SocketMetrics makeSocketMetrics(const std::string& _protocol)
+		{
+			MetricsRegistry& registry = MetricsRegistry::getProcessRegistry();
+			std::string labels = "protocol=\"" + _protocol + "\"";
+
+			return SocketMetrics{
+				registry.counter("tra_socket_send_calls_total", "Send system calls.", labels),
+				registry.counter("tra_socket_receive_calls_total", "Receive system calls.", labels),
+				registry.counter("tra_socket_bytes_sent_total", "Bytes written to sockets.", labels),
+				registry.counter("tra_socket_bytes_received_total", "Bytes read from sockets.", labels),
+				registry.counter("tra_socket_would_block_total", "Socket calls that would have blocked.", labels),
+				registry.counter("tra_socket_errors_total", "Socket calls that failed.", labels)
+			};
+		}
+	}
+
+	SocketMetrics& SocketUtils::getTcpMetrics()
+	{
+		static SocketMetrics metrics = makeSocketMetrics("tcp");
+		return metrics;
+	}
+
+	SocketMetrics& SocketUtils::getUdpMetrics()
+	{
+		static SocketMetrics metrics = makeSocketMetrics("udp");
+		return metrics;
+	}
+}
@@ -2,19 +2,62 @@
 
 #include <limits>
 #include <cstdio>
+#include <algorithm>
+#include <chrono>
 
 #include "TRA/debugUtils.hpp"
 #include "socketUtils.hpp"
 
+#if !defined(_WIN32)
+#include <poll.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#endif
+
 #undef max
 
 namespace tra::core
 {
+	namespace
+	{
+		// Kernel timestamps are CLOCK_REALTIME, which is what system_clock reads.
+		uint64_t getRealtimeNs()
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+		}
+
+		uint64_t elapsedNs(uint64_t _fromNs, uint64_t _toNs)
+		{
+			return _toNs > _fromNs ? _toNs - _fromNs : 0;
+		}
+
+#if defined(__linux__)
+		constexpr size_t TIMESTAMP_CONTROL_SIZE = 256;
+
+		uint64_t toNs(const timespec& _time)
+		{
+			return static_cast<uint64_t>(_time.tv_sec) * 1000000000ull + static_cast<uint64_t>(_time.tv_nsec);
+		}
+
+		// Timestamp keys are 32 bit byte offsets and wrap every 4 GiB.
+		bool isKeyAtOrBefore(uint32_t _key, uint32_t _reference)
+		{
+			return static_cast<int32_t>(_key - _reference) <= 0;
+		}
+#endif
+	}
+
 	TcpSocket::TcpSocket()
 	{
 		m_socket = INVALID_SOCKET_FD;
 		m_port = 0;
 		m_isBlocking = true;
+		m_kernelTimestamping = false;
+		m_timestampedBytes = 0;
+		m_receiveDelayNs = 0;
 	}
 
 	TcpSocket::~TcpSocket()
@@ -53,7 +96,7 @@ namespace tra::core
 		}
 	}
 
-	std::pair<ErrorCode, int> TcpSocket::connectTo(const std::string& _address, uint16_t _port)
+	std::pair<ErrorCode, int> TcpSocket::connectTo(const std::string& _address, uint16_t _port, bool _nonBlocking)
 	{
 		TRA_ASSERT_REF_PTR_OR_COPIABLE(_address);
 
@@ -86,13 +129,29 @@ namespace tra::core
 				continue;
 			}
 
+			if (_nonBlocking && SocketUtils::setBlocking(m_socket, false).first != ErrorCode::Success)
+			{
+				CLOSE_SOCKET(m_socket);
+				m_socket = INVALID_SOCKET_FD;
+				continue;
+			}
+
 			iResult = connect(m_socket, rp->ai_addr, static_cast<int>(rp->ai_addrlen));
+			lastSocketError = SocketUtils::getLastSocketError();
 			if (iResult == 0)
 			{
 				freeaddrinfo(result);
+				m_isBlocking = !_nonBlocking;
 				return { ErrorCode::Success, 0 };
 			}
 
+			if (_nonBlocking && lastSocketError == SOCKET_CONNECT_IN_PROGRESS)
+			{
+				freeaddrinfo(result);
+				m_isBlocking = false;
+				return { ErrorCode::SocketConnectInProgress, 0 };
+			}
+
 			CLOSE_SOCKET(m_socket);
 			m_socket = INVALID_SOCKET_FD;
 		}
@@ -101,7 +160,55 @@ namespace tra::core
 		return { ErrorCode::SocketConnectFailed, 0 };
 	}
 
-	std::pair<ErrorCode, int> TcpSocket::bindSocket(uint16_t _port)
+	std::pair<ErrorCode, int> TcpSocket::finishConnect()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_socket == INVALID_SOCKET_FD)
+		{
+			return { ErrorCode::SocketNotOpen, 0 };
+		}
+
+#ifdef _WIN32
+		WSAPOLLFD pollDescriptor = {};
+		pollDescriptor.fd = m_socket;
+		pollDescriptor.events = POLLWRNORM;
+
+		int iResult = WSAPoll(&pollDescriptor, 1, 0);
+#else
+		pollfd pollDescriptor = {};
+		pollDescriptor.fd = m_socket;
+		pollDescriptor.events = POLLOUT;
+
+		int iResult = poll(&pollDescriptor, 1, 0);
+#endif
+		int lastSocketError = SocketUtils::getLastSocketError();
+		if (iResult < 0)
+		{
+			return { ErrorCode::SocketConnectFailed, lastSocketError };
+		}
+
+		if (iResult == 0)
+		{
+			return { ErrorCode::SocketConnectInProgress, 0 };
+		}
+
+		int socketError = 0;
+		socklen_t length = sizeof(socketError);
+		if (getsockopt(m_socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&socketError), &length) != 0)
+		{
+			return { ErrorCode::SocketConnectFailed, SocketUtils::getLastSocketError() };
+		}
+
+		if (socketError != 0)
+		{
+			return { ErrorCode::SocketConnectFailed, socketError };
+		}
+
+		return { ErrorCode::Success, 0 };
+	}
+
+	std::pair<ErrorCode, int> TcpSocket::bindSocket(uint16_t _port, bool _reusePort, bool _loopbackOnly)
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -114,14 +221,14 @@ namespace tra::core
 		hints.ai_family = AF_INET;
 		hints.ai_socktype = SOCK_STREAM;
 		hints.ai_protocol = IPPROTO_TCP;
-		hints.ai_flags = AI_PASSIVE;
+		hints.ai_flags = _loopbackOnly ? 0 : AI_PASSIVE;
 
 		addrinfo* result = nullptr;
 
 		char portStr[6];
 		snprintf(portStr, sizeof(portStr), "%u", _port);
 
-		int iResult = getaddrinfo(NULL, portStr, &hints, &result);
+		int iResult = getaddrinfo(_loopbackOnly ? "127.0.0.1" : NULL, portStr, &hints, &result);
 		int lastSocketError = SocketUtils::getLastSocketError();
 		if (iResult != 0 || result == nullptr)
 		{
@@ -136,10 +243,42 @@ namespace tra::core
 				continue;
 			}
 
+			if (_reusePort)
+			{
+#if defined(SO_REUSEPORT)
+				int enable = 1;
+				iResult = setsockopt(m_socket, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char*>(&enable), sizeof(enable));
+				lastSocketError = SocketUtils::getLastSocketError();
+				if (iResult != 0)
+				{
+					freeaddrinfo(result);
+					CLOSE_SOCKET(m_socket);
+					m_socket = INVALID_SOCKET_FD;
+					return { ErrorCode::SocketSetOptionFailed, lastSocketError };
+				}
+#else
+				freeaddrinfo(result);
+				CLOSE_SOCKET(m_socket);
+				m_socket = INVALID_SOCKET_FD;
+				return { ErrorCode::SocketOptionNotSupported, 0 };
+#endif
+			}
+
 			iResult = bind(m_socket, rp->ai_addr, static_cast<int>(rp->ai_addrlen));
 			if (iResult == 0)
 			{
 				freeaddrinfo(result);
+
+				std::pair<ErrorCode, uint16_t> portResult = SocketUtils::getSocketPort(m_socket);
+				if (portResult.first != ErrorCode::Success)
+				{
+					CLOSE_SOCKET(m_socket);
+					m_socket = INVALID_SOCKET_FD;
+					return portResult;
+				}
+
+				m_port = portResult.second;
+
 				return { ErrorCode::Success, 0 };
 			}
 
@@ -149,16 +288,6 @@ namespace tra::core
 
 		freeaddrinfo(result);
 
-		std::pair<ErrorCode, uint16_t> portResult = SocketUtils::getSocketPort(m_socket);
-		if (portResult.first != ErrorCode::Success)
-		{
-			CLOSE_SOCKET(m_socket);
-			m_socket = INVALID_SOCKET_FD;
-			return portResult;
-		}
-
-		m_port = portResult.second;
-
 		return { ErrorCode::SocketBindFailed, 0 };
 	}
 
@@ -182,7 +311,7 @@ namespace tra::core
 		return { ErrorCode::Success, 0 };
 	}
 
-	std::pair<ErrorCode, int> TcpSocket::acceptSocket(TcpSocket** _outClient)
+	std::pair<ErrorCode, int> TcpSocket::acceptSocket(TcpSocket** _outClient, bool _nonBlocking)
 	{
 		TRA_ASSERT_REF_PTR_OR_COPIABLE(_outClient);
 
@@ -193,7 +322,11 @@ namespace tra::core
 			return { ErrorCode::SocketNotOpen, 0 };
 		}
 
+#if defined(__linux__)
+		socket_t clientSocket = accept4(m_socket, NULL, NULL, _nonBlocking ? SOCK_NONBLOCK | SOCK_CLOEXEC : SOCK_CLOEXEC);
+#else
 		socket_t clientSocket = accept(m_socket, NULL, NULL);
+#endif
 		int lastSocketError = SocketUtils::getLastSocketError();
 		if (clientSocket == INVALID_SOCKET_FD)
 		{
@@ -205,12 +338,60 @@ namespace tra::core
 			return { ErrorCode::SocketAcceptFailed, lastSocketError };
 		}
 
+#if !defined(__linux__)
+		if (_nonBlocking)
+		{
+			std::pair<ErrorCode, int> setBlockingResult = SocketUtils::setBlocking(clientSocket, false);
+			if (setBlockingResult.first != ErrorCode::Success)
+			{
+				CLOSE_SOCKET(clientSocket);
+				return setBlockingResult;
+			}
+		}
+#endif
+
 		*_outClient = new TcpSocket;
 		(*_outClient)->m_socket = clientSocket;
+		(*_outClient)->m_isBlocking = !_nonBlocking;
 
 		return { ErrorCode::Success, 0 };
 	}
 
+	std::pair<ErrorCode, int> TcpSocket::waitReadable(uint32_t _timeoutMs)
+	{
+		socket_t socket = INVALID_SOCKET_FD;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			socket = m_socket;
+		}
+
+		if (socket == INVALID_SOCKET_FD)
+		{
+			return { ErrorCode::SocketNotOpen, 0 };
+		}
+
+#ifdef _WIN32
+		WSAPOLLFD pollDescriptor = {};
+		pollDescriptor.fd = socket;
+		pollDescriptor.events = POLLRDNORM;
+
+		int iResult = WSAPoll(&pollDescriptor, 1, static_cast<INT>(_timeoutMs));
+#else
+		pollfd pollDescriptor = {};
+		pollDescriptor.fd = socket;
+		pollDescriptor.events = POLLIN;
+
+		int iResult = poll(&pollDescriptor, 1, static_cast<int>(_timeoutMs));
+#endif
+		int lastSocketError = SocketUtils::getLastSocketError();
+		if (iResult < 0)
+		{
+			return { ErrorCode::SocketReceiveFailed, lastSocketError };
+		}
+
+		return { ErrorCode::Success, iResult > 0 ? 1 : 0 };
+	}
+
 	std::pair<ErrorCode, int> TcpSocket::sendData(const void* _data, size_t _size, int& _byteSent)
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
@@ -225,6 +406,12 @@ namespace tra::core
 			return { ErrorCode::SocketSendSizeTooLarge, 0 };
 		}
 
+		SocketMetrics& metrics = SocketUtils::getTcpMetrics();
+		metrics.m_sendCalls.add();
+
+		// The kernel stamps the send inside the call, so read the clock first.
+		uint64_t sendNs = m_kernelTimestamping ? getRealtimeNs() : 0;
+
 		_byteSent = send(m_socket, static_cast<const char*>(_data), static_cast<int>(_size), 0);
 		int lastSocketError = SocketUtils::getLastSocketError();
 		if (_byteSent == 0)
@@ -233,6 +420,16 @@ namespace tra::core
 		}
 		else if (_byteSent < 0)
 		{
+			_byteSent = 0;
+
+			if (SocketUtils::isWouldBlockError(lastSocketError))
+			{
+				metrics.m_wouldBlock.add();
+				return { ErrorCode::SocketWouldBlock, lastSocketError };
+			}
+
+			metrics.m_errors.add();
+
 			if (lastSocketError == SOCKET_CONNECTION_RESET)
 			{
 				return { ErrorCode::SocketConnectionClosed, 0 };
@@ -240,7 +437,22 @@ namespace tra::core
 
 			return { ErrorCode::SocketSendFailed, lastSocketError };
 		}
-		else if (_byteSent < _size)
+
+		metrics.m_bytesSent.add(static_cast<uint64_t>(_byteSent));
+
+		if (m_kernelTimestamping)
+		{
+			// With OPT_ID the kernel keys each send by the offset of its last
+			// byte since timestamping was enabled.
+			m_timestampedBytes += static_cast<uint32_t>(_byteSent);
+			if (m_pendingTransmits.size() >= MAX_PENDING_TRANSMITS)
+			{
+				m_pendingTransmits.pop_front();
+			}
+			m_pendingTransmits.push_back({ m_timestampedBytes - 1, sendNs, 0 });
+		}
+
+		if (_byteSent < _size)
 		{
 			return { ErrorCode::SocketSendPartial, 0 };
 		}
@@ -248,7 +460,7 @@ namespace tra::core
 		return { ErrorCode::Success, 0 };
 	}
 
-	std::pair<ErrorCode, int> TcpSocket::receiveData(std::vector<uint8_t>& _buffer)
+	std::pair<ErrorCode, int> TcpSocket::receiveData(std::vector<uint8_t>& _buffer, size_t _maxBytes)
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -260,13 +472,18 @@ namespace tra::core
 		_buffer.clear();
 		char buffer[4096];
 
-		while (true)
+		SocketMetrics& metrics = SocketUtils::getTcpMetrics();
+
+		while (_buffer.size() < _maxBytes)
 		{
-			int bytes = recv(m_socket, buffer, sizeof(buffer), 0);
+			size_t chunkSize = (std::min)(sizeof(buffer), _maxBytes - _buffer.size());
+			int bytes = m_kernelTimestamping ? receiveTimestamped(buffer, chunkSize) : recv(m_socket, buffer, static_cast<int>(chunkSize), 0);
 			int lastSocketError = SocketUtils::getLastSocketError();
+			metrics.m_receiveCalls.add();
 
 			if (bytes > 0)
 			{
+				metrics.m_bytesReceived.add(static_cast<uint64_t>(bytes));
 				_buffer.insert(_buffer.end(), buffer, buffer + bytes);
 			}
 			else if (bytes == 0)
@@ -277,9 +494,12 @@ namespace tra::core
 			{
 				if (SocketUtils::isWouldBlockError(lastSocketError))
 				{
+					metrics.m_wouldBlock.add();
 					return { ErrorCode::Success, 0 };
 				}
 
+				metrics.m_errors.add();
+
 				if (lastSocketError == SOCKET_CONNECTION_RESET)
 				{
 					return { ErrorCode::SocketConnectionClosed, 0 };
@@ -288,6 +508,8 @@ namespace tra::core
 				return { ErrorCode::SocketReceiveFailed, lastSocketError };
 			}
 		}
+
+		return { ErrorCode::Success, 0 };
 	}
 
 	std::pair<ErrorCode, int> TcpSocket::setBlocking(bool _blocking)
@@ -320,6 +542,27 @@ namespace tra::core
 		return { ErrorCode::Success, m_port };
 	}
 
+	std::pair<ErrorCode, int> TcpSocket::getPeerAddress(SocketAddress& _outAddress)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_socket == INVALID_SOCKET_FD)
+		{
+			return { ErrorCode::SocketNotOpen, 0 };
+		}
+
+		_outAddress = SocketAddress();
+		socklen_t addrLen = _outAddress.getCapacity();
+		if (getpeername(m_socket, _outAddress.data(), &addrLen) != 0)
+		{
+			return { ErrorCode::SocketGetPeerAddressFailed, SocketUtils::getLastSocketError() };
+		}
+
+		_outAddress.setLength(addrLen);
+
+		return { ErrorCode::Success, 0 };
+	}
+
 	bool TcpSocket::isBlocking() const
 	{
 		return m_isBlocking;
@@ -344,4 +587,175 @@ namespace tra::core
 
 		return getpeername(m_socket, (sockaddr*)&addr, &addrLen) == 0;
 	}
+
+	std::pair<ErrorCode, int> TcpSocket::setKernelTimestamping(bool _enabled)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_socket == INVALID_SOCKET_FD)
+		{
+			return { ErrorCode::SocketNotOpen, 0 };
+		}
+
+#if defined(__linux__) && defined(SO_TIMESTAMPING)
+		int flags = 0;
+		if (_enabled)
+		{
+			flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_ACK
+				| SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+		}
+
+		int iResult = setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags));
+		int lastSocketError = SocketUtils::getLastSocketError();
+		if (iResult != 0)
+		{
+			return { ErrorCode::SocketSetOptionFailed, lastSocketError };
+		}
+
+		m_kernelTimestamping = _enabled;
+		m_timestampedBytes = 0;
+		m_receiveDelayNs = 0;
+		m_pendingTransmits.clear();
+
+		return { ErrorCode::Success, 0 };
+#else
+		return { ErrorCode::SocketOptionNotSupported, 0 };
+#endif
+	}
+
+	bool TcpSocket::isKernelTimestamping() const
+	{
+		return m_kernelTimestamping;
+	}
+
+	std::pair<ErrorCode, int> TcpSocket::readKernelTimestamps(std::vector<TransmitTimestamp>& _outTransmits, uint64_t& _outReceiveDelayNs)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_socket == INVALID_SOCKET_FD)
+		{
+			return { ErrorCode::SocketNotOpen, 0 };
+		}
+
+		_outReceiveDelayNs = m_receiveDelayNs;
+		m_receiveDelayNs = 0;
+
+		int transmitCount = 0;
+
+#if defined(__linux__)
+		while (m_kernelTimestamping)
+		{
+			alignas(cmsghdr) char control[TIMESTAMP_CONTROL_SIZE];
+			msghdr message = {};
+			message.msg_control = control;
+			message.msg_controllen = sizeof(control);
+
+			int iResult = recvmsg(m_socket, &message, MSG_ERRQUEUE | MSG_DONTWAIT);
+			int lastSocketError = SocketUtils::getLastSocketError();
+			if (iResult < 0)
+			{
+				if (SocketUtils::isWouldBlockError(lastSocketError))
+				{
+					break;
+				}
+
+				return { ErrorCode::SocketReceiveFailed, lastSocketError };
+			}
+
+			const scm_timestamping* timestamps = nullptr;
+			const sock_extended_err* extendedError = nullptr;
+			for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+			{
+				if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING)
+				{
+					timestamps = reinterpret_cast<const scm_timestamping*>(CMSG_DATA(cmsg));
+				}
+				else if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+				{
+					extendedError = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+				}
+			}
+
+			if (timestamps == nullptr || extendedError == nullptr || extendedError->ee_origin != SO_EE_ORIGIN_TIMESTAMPING)
+			{
+				continue;
+			}
+
+			uint64_t stampNs = toNs(timestamps->ts[0]);
+			uint32_t key = extendedError->ee_data;
+
+			// Sends coalesced into one segment only get the timestamp of the
+			// last one, so every earlier pending send is covered by it too.
+			if (extendedError->ee_info == SCM_TSTAMP_SND)
+			{
+				for (PendingTransmit& pending : m_pendingTransmits)
+				{
+					if (!isKeyAtOrBefore(pending.m_key, key))
+					{
+						break;
+					}
+
+					if (pending.m_transmitNs == 0)
+					{
+						pending.m_transmitNs = stampNs;
+					}
+				}
+			}
+			else if (extendedError->ee_info == SCM_TSTAMP_ACK)
+			{
+				while (!m_pendingTransmits.empty() && isKeyAtOrBefore(m_pendingTransmits.front().m_key, key))
+				{
+					const PendingTransmit& pending = m_pendingTransmits.front();
+					if (pending.m_transmitNs != 0)
+					{
+						TransmitTimestamp transmit;
+						transmit.m_bufferedNs = elapsedNs(pending.m_sendNs, pending.m_transmitNs);
+						transmit.m_wireNs = elapsedNs(pending.m_transmitNs, stampNs);
+						_outTransmits.push_back(transmit);
+						transmitCount++;
+					}
+
+					m_pendingTransmits.pop_front();
+				}
+			}
+		}
+#endif
+
+		return { ErrorCode::Success, transmitCount };
+	}
+
+	int TcpSocket::receiveTimestamped(char* _buffer, size_t _size)
+	{
+#if defined(__linux__)
+		iovec vector;
+		vector.iov_base = _buffer;
+		vector.iov_len = _size;
+
+		alignas(cmsghdr) char control[TIMESTAMP_CONTROL_SIZE];
+		msghdr message = {};
+		message.msg_iov = &vector;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		int bytes = static_cast<int>(recvmsg(m_socket, &message, 0));
+		if (bytes <= 0)
+		{
+			return bytes;
+		}
+
+		for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+		{
+			if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING)
+			{
+				const scm_timestamping* timestamps = reinterpret_cast<const scm_timestamping*>(CMSG_DATA(cmsg));
+				m_receiveDelayNs = (std::max)(m_receiveDelayNs, elapsedNs(toNs(timestamps->ts[0]), getRealtimeNs()));
+			}
+		}
+
+		return bytes;
+#else
+		return recv(m_socket, _buffer, static_cast<int>(_size), 0);
+#endif
+	}
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "TRA/core/udpDatagramBatch.hpp"
+
+#include <algorithm>
+
+#include "TRA/debugUtils.hpp"
+
+namespace tra::core
+{
+    UdpDatagramBatch::UdpDatagramBatch(size_t _slotCount, size_t _slotCapacity)
+    {
+        m_slotCapacity = (std::min)(_slotCapacity, MAX_DATAGRAM_SIZE);
+        m_storage.resize(_slotCount * m_slotCapacity);
+        m_slots.resize(_slotCount);
+
+        for (size_t i = 0; i < _slotCount; i++)
+        {
+            m_slots[i].m_data = m_storage.data() + i * m_slotCapacity;
+        }
+
+#if defined(__linux__)
+        m_headers.resize(_slotCount);
+        m_iovecs.resize(_slotCount);
+        m_control.resize(_slotCount * CONTROL_SIZE);
+#endif
+    }
+
+    UdpDatagram& UdpDatagramBatch::operator[](size_t _index)
+    {
+        return m_slots[_index];
+    }
+
+    const UdpDatagram& UdpDatagramBatch::operator[](size_t _index) const
+    {
+        return m_slots[_index];
+    }
+
+    size_t UdpDatagramBatch::getSlotCount() const
+    {
+        return m_slots.size();
+    }
+
+    size_t UdpDatagramBatch::getSlotCapacity() const
+    {
+        return m_slotCapacity;
+    }
+}
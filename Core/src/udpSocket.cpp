@@ -1,10 +1,30 @@
 #include "TRA/core/udpSocket.hpp"
 
 #include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 #include "TRA/debugUtils.hpp"
 #include "socketUtils.hpp"
 
+#if defined(__linux__)
+#include <netinet/udp.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
 #undef max
 
 namespace tra::core
@@ -14,6 +34,9 @@ namespace tra::core
         m_socket = INVALID_SOCKET_FD;
 		m_port = 0;
 		m_isBlocking = true;
+		m_segmentationOffload = false;
+		m_receiveOffload = false;
+		m_kernelTimestamping = false;
     }
 
     UdpSocket::~UdpSocket()
@@ -21,18 +44,6 @@ namespace tra::core
         closeSocket();
     }
 
-    sockaddr* UdpSocket::createSockAddr(const std::string& _address, uint16_t _port)
-    {
-        TRA_ASSERT_REF_PTR_OR_COPIABLE(_address);
-
-        sockaddr_in* addr = new sockaddr_in;
-        addr->sin_family = AF_INET;
-        addr->sin_port = htons(_port);
-
-        inet_pton(AF_INET, _address.c_str(), &addr->sin_addr);
-        return (sockaddr*)addr;
-    }
-
     void UdpSocket::closeSocket()
     {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -42,6 +53,9 @@ namespace tra::core
             CLOSE_SOCKET(m_socket);
             m_socket = INVALID_SOCKET_FD;
         }
+
+        m_segmentationOffload = false;
+        m_receiveOffload = false;
     }
 
     std::pair<ErrorCode, int> UdpSocket::bindSocket(const uint16_t _port)
@@ -105,7 +119,7 @@ namespace tra::core
         return { ErrorCode::SocketBindFailed, 0 };
     }
 
-    std::pair<ErrorCode, int> UdpSocket::sendDataTo(const void* _data, size_t _size, const sockaddr* _destAddr)
+    std::pair<ErrorCode, int> UdpSocket::sendDataTo(const void* _data, size_t _size, const SocketAddress& _destAddr)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -119,19 +133,23 @@ namespace tra::core
             return { ErrorCode::SocketSendSizeTooLarge, 0 };
         }
 
-        socklen_t addrLen = sizeof(sockaddr_in);
+        SocketMetrics& metrics = SocketUtils::getUdpMetrics();
+        metrics.m_sendCalls.add();
 
-        int iResult = sendto(m_socket, static_cast<const char*>(_data), static_cast<int>(_size), 0, _destAddr, addrLen);
+        int iResult = sendto(m_socket, static_cast<const char*>(_data), static_cast<int>(_size), 0, _destAddr.data(), _destAddr.getLength());
         int lastSocketError = SocketUtils::getLastSocketError();
         if (iResult < 0)
         {
+            metrics.m_errors.add();
             return { ErrorCode::SocketSendFailed, lastSocketError };
         }
 
+        metrics.m_bytesSent.add(static_cast<uint64_t>(iResult));
+
         return { ErrorCode::Success, 0 };
     }
 
-    std::pair<ErrorCode, int> UdpSocket::receiveDataFrom(void* _buffer, size_t _size, sockaddr* _srcAddr)
+    std::pair<ErrorCode, int> UdpSocket::receiveDataFrom(void* _buffer, size_t _size, SocketAddress& _outSrcAddr)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -145,21 +163,391 @@ namespace tra::core
             return { ErrorCode::SocketReceiveSizeTooLarge, 0 };
         }
 
-        socklen_t addrLen = sizeof(sockaddr_in);
+        socklen_t addrLen = _outSrcAddr.getCapacity();
+
+        SocketMetrics& metrics = SocketUtils::getUdpMetrics();
+        metrics.m_receiveCalls.add();
+
+        int iResult = recvfrom(m_socket, static_cast<char*>(_buffer), static_cast<int>(_size), 0, _outSrcAddr.data(), &addrLen);
+        int lastSocketError = SocketUtils::getLastSocketError();
+        if (iResult < 0)
+        {
+            if (SocketUtils::isWouldBlockError(lastSocketError))
+            {
+                metrics.m_wouldBlock.add();
+                return { ErrorCode::SocketWouldBlock, 0 };
+            }
+
+            metrics.m_errors.add();
+            return { ErrorCode::SocketReceiveFailed, lastSocketError };
+        }
+
+        metrics.m_bytesReceived.add(static_cast<uint64_t>(iResult));
+        _outSrcAddr.setLength(addrLen);
+
+        return { ErrorCode::Success, iResult };
+    }
+
+    std::pair<ErrorCode, int> UdpSocket::sendBatch(UdpDatagramBatch& _batch, size_t _count, size_t& _outDropped)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        _outDropped = 0;
+
+        if (m_socket == INVALID_SOCKET_FD)
+        {
+            return { ErrorCode::SocketNotOpen, 0 };
+        }
+
+        _count = (std::min)(_count, _batch.getSlotCount());
+
+        SocketMetrics& metrics = SocketUtils::getUdpMetrics();
+        int lastDropError = 0;
+
+#if defined(__linux__)
+        for (size_t i = 0; i < _count; i++)
+        {
+            UdpDatagram& datagram = _batch.m_slots[i];
+            mmsghdr& header = _batch.m_headers[i];
+
+            _batch.m_iovecs[i].iov_base = datagram.m_data;
+            _batch.m_iovecs[i].iov_len = datagram.m_size;
+
+            header = {};
+            header.msg_hdr.msg_name = datagram.m_address.data();
+            header.msg_hdr.msg_namelen = datagram.m_address.getLength();
+            header.msg_hdr.msg_iov = &_batch.m_iovecs[i];
+            header.msg_hdr.msg_iovlen = 1;
+
+            if (m_segmentationOffload && datagram.m_segmentSize != 0 && datagram.m_size > datagram.m_segmentSize)
+            {
+                header.msg_hdr.msg_control = _batch.m_control.data() + i * UdpDatagramBatch::CONTROL_SIZE;
+                header.msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+                cmsghdr* control = CMSG_FIRSTHDR(&header.msg_hdr);
+                control->cmsg_level = SOL_UDP;
+                control->cmsg_type = UDP_SEGMENT;
+                control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                std::memcpy(CMSG_DATA(control), &datagram.m_segmentSize, sizeof(uint16_t));
+            }
+        }
+
+        size_t sent = 0;
+        while (sent < _count)
+        {
+            int iResult = sendmmsg(m_socket, _batch.m_headers.data() + sent, static_cast<unsigned int>(_count - sent), 0);
+            int lastSocketError = SocketUtils::getLastSocketError();
+            metrics.m_sendCalls.add();
+            if (iResult < 0)
+            {
+                if (lastSocketError == EINTR)
+                {
+                    continue;
+                }
+
+                if (SocketUtils::isWouldBlockError(lastSocketError))
+                {
+                    metrics.m_wouldBlock.add();
+                    return { ErrorCode::SocketWouldBlock, lastSocketError };
+                }
+
+                // sendmmsg reports the error of the first datagram it could
+                // not send; skip that one and carry on with the rest.
+                metrics.m_errors.add();
+                lastDropError = lastSocketError;
+                ++_outDropped;
+                ++sent;
+                continue;
+            }
+
+            uint64_t bytesSent = 0;
+            for (int i = 0; i < iResult; i++)
+            {
+                bytesSent += _batch.m_headers[sent + static_cast<size_t>(i)].msg_len;
+            }
+            metrics.m_bytesSent.add(bytesSent);
+
+            sent += static_cast<size_t>(iResult);
+        }
+#else
+        for (size_t i = 0; i < _count; i++)
+        {
+            const UdpDatagram& datagram = _batch.m_slots[i];
+            size_t segmentSize = datagram.m_segmentSize != 0 ? datagram.m_segmentSize : (std::max)(datagram.m_size, static_cast<size_t>(1));
+            size_t offset = 0;
+
+            do
+            {
+                size_t size = (std::min)(segmentSize, datagram.m_size - offset);
 
-        int iResult = recvfrom(m_socket, static_cast<char*>(_buffer), static_cast<int>(_size), 0, _srcAddr, &addrLen);
+                int iResult = sendto(m_socket, reinterpret_cast<const char*>(datagram.m_data + offset), static_cast<int>(size), 0, datagram.m_address.data(), datagram.m_address.getLength());
+                int lastSocketError = SocketUtils::getLastSocketError();
+                metrics.m_sendCalls.add();
+                if (iResult < 0)
+                {
+                    if (SocketUtils::isWouldBlockError(lastSocketError))
+                    {
+                        metrics.m_wouldBlock.add();
+                        return { ErrorCode::SocketWouldBlock, lastSocketError };
+                    }
+
+                    metrics.m_errors.add();
+                    lastDropError = lastSocketError;
+                    ++_outDropped;
+                    break;
+                }
+
+                metrics.m_bytesSent.add(static_cast<uint64_t>(iResult));
+
+                offset += segmentSize;
+            } while (offset < datagram.m_size);
+        }
+#endif
+
+        if (_outDropped > 0)
+        {
+            return { ErrorCode::SocketSendFailed, lastDropError };
+        }
+
+        return { ErrorCode::Success, static_cast<int>(_count) };
+    }
+
+    std::pair<ErrorCode, int> UdpSocket::receiveBatch(UdpDatagramBatch& _batch, size_t _maxCount)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_socket == INVALID_SOCKET_FD)
+        {
+            return { ErrorCode::SocketNotOpen, 0 };
+        }
+
+        size_t count = (std::min)(_maxCount, _batch.getSlotCount());
+        if (count == 0)
+        {
+            return { ErrorCode::Success, 0 };
+        }
+
+        SocketMetrics& metrics = SocketUtils::getUdpMetrics();
+
+#if defined(__linux__)
+        for (size_t i = 0; i < count; i++)
+        {
+            UdpDatagram& datagram = _batch.m_slots[i];
+            mmsghdr& header = _batch.m_headers[i];
+
+            _batch.m_iovecs[i].iov_base = datagram.m_data;
+            _batch.m_iovecs[i].iov_len = _batch.m_slotCapacity;
+
+            header = {};
+            header.msg_hdr.msg_name = datagram.m_address.data();
+            header.msg_hdr.msg_namelen = datagram.m_address.getCapacity();
+            header.msg_hdr.msg_iov = &_batch.m_iovecs[i];
+            header.msg_hdr.msg_iovlen = 1;
+
+            if (m_receiveOffload || m_kernelTimestamping)
+            {
+                header.msg_hdr.msg_control = _batch.m_control.data() + i * UdpDatagramBatch::CONTROL_SIZE;
+                header.msg_hdr.msg_controllen = UdpDatagramBatch::CONTROL_SIZE;
+            }
+        }
+
+        int iResult = recvmmsg(m_socket, _batch.m_headers.data(), static_cast<unsigned int>(count), MSG_WAITFORONE, nullptr);
         int lastSocketError = SocketUtils::getLastSocketError();
+        metrics.m_receiveCalls.add();
         if (iResult < 0)
         {
             if (SocketUtils::isWouldBlockError(lastSocketError))
             {
+                metrics.m_wouldBlock.add();
                 return { ErrorCode::SocketWouldBlock, 0 };
             }
 
+            metrics.m_errors.add();
             return { ErrorCode::SocketReceiveFailed, lastSocketError };
         }
 
+        // Kernel timestamps are CLOCK_REALTIME, which is what system_clock reads.
+        uint64_t nowNs = 0;
+        if (m_kernelTimestamping)
+        {
+            nowNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        uint64_t bytesReceived = 0;
+        for (int i = 0; i < iResult; i++)
+        {
+            UdpDatagram& datagram = _batch.m_slots[i];
+            mmsghdr& header = _batch.m_headers[i];
+
+            datagram.m_size = header.msg_len;
+            bytesReceived += header.msg_len;
+            datagram.m_address.setLength(header.msg_hdr.msg_namelen);
+            datagram.m_segmentSize = 0;
+            datagram.m_receiveDelayNs = 0;
+
+            if (!m_receiveOffload && !m_kernelTimestamping)
+            {
+                continue;
+            }
+
+            for (cmsghdr* control = CMSG_FIRSTHDR(&header.msg_hdr); control != nullptr; control = CMSG_NXTHDR(&header.msg_hdr, control))
+            {
+                if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO)
+                {
+                    int segmentSize = 0;
+                    std::memcpy(&segmentSize, CMSG_DATA(control), sizeof(int));
+                    datagram.m_segmentSize = static_cast<uint16_t>(segmentSize);
+                }
+                else if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPING)
+                {
+                    scm_timestamping timestamps;
+                    std::memcpy(&timestamps, CMSG_DATA(control), sizeof(timestamps));
+                    uint64_t receivedNs = static_cast<uint64_t>(timestamps.ts[0].tv_sec) * 1000000000ull + static_cast<uint64_t>(timestamps.ts[0].tv_nsec);
+                    datagram.m_receiveDelayNs = nowNs > receivedNs ? nowNs - receivedNs : 0;
+                }
+            }
+        }
+
+        metrics.m_bytesReceived.add(bytesReceived);
+
+        return { ErrorCode::Success, iResult };
+#else
+        size_t received = 0;
+        while (received < count)
+        {
+            UdpDatagram& datagram = _batch.m_slots[received];
+            socklen_t addrLen = datagram.m_address.getCapacity();
+
+            int iResult = recvfrom(m_socket, reinterpret_cast<char*>(datagram.m_data), static_cast<int>(_batch.m_slotCapacity), 0,
+                datagram.m_address.data(), &addrLen);
+            int lastSocketError = SocketUtils::getLastSocketError();
+            metrics.m_receiveCalls.add();
+            if (iResult < 0)
+            {
+                if (received > 0 || SocketUtils::isWouldBlockError(lastSocketError))
+                {
+                    metrics.m_wouldBlock.add();
+                    break;
+                }
+
+                metrics.m_errors.add();
+                return { ErrorCode::SocketReceiveFailed, lastSocketError };
+            }
+
+            metrics.m_bytesReceived.add(static_cast<uint64_t>(iResult));
+
+            datagram.m_size = static_cast<size_t>(iResult);
+            datagram.m_address.setLength(addrLen);
+            datagram.m_segmentSize = 0;
+            datagram.m_receiveDelayNs = 0;
+            ++received;
+
+            if (m_isBlocking)
+            {
+                break;
+            }
+        }
+
+        if (received == 0)
+        {
+            return { ErrorCode::SocketWouldBlock, 0 };
+        }
+
+        return { ErrorCode::Success, static_cast<int>(received) };
+#endif
+    }
+
+    std::pair<ErrorCode, int> UdpSocket::setSegmentationOffload(bool _enabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_socket == INVALID_SOCKET_FD)
+        {
+            return { ErrorCode::SocketNotOpen, 0 };
+        }
+
+#if defined(__linux__)
+        if (_enabled)
+        {
+            int segmentSize = 0;
+            int iResult = setsockopt(m_socket, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize));
+            int lastSocketError = SocketUtils::getLastSocketError();
+            if (iResult != 0)
+            {
+                return { ErrorCode::SocketOptionNotSupported, lastSocketError };
+            }
+        }
+
+        m_segmentationOffload = _enabled;
+        return { ErrorCode::Success, 0 };
+#else
+        if (_enabled)
+        {
+            return { ErrorCode::SocketOptionNotSupported, 0 };
+        }
+
+        return { ErrorCode::Success, 0 };
+#endif
+    }
+
+    std::pair<ErrorCode, int> UdpSocket::setReceiveOffload(bool _enabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_socket == INVALID_SOCKET_FD)
+        {
+            return { ErrorCode::SocketNotOpen, 0 };
+        }
+
+#if defined(__linux__)
+        int value = _enabled ? 1 : 0;
+        int iResult = setsockopt(m_socket, SOL_UDP, UDP_GRO, &value, sizeof(value));
+        int lastSocketError = SocketUtils::getLastSocketError();
+        if (iResult != 0)
+        {
+            return { _enabled ? ErrorCode::SocketOptionNotSupported : ErrorCode::SocketSetOptionFailed, lastSocketError };
+        }
+
+        m_receiveOffload = _enabled;
+        return { ErrorCode::Success, 0 };
+#else
+        if (_enabled)
+        {
+            return { ErrorCode::SocketOptionNotSupported, 0 };
+        }
+
         return { ErrorCode::Success, 0 };
+#endif
+    }
+
+    std::pair<ErrorCode, int> UdpSocket::setKernelTimestamping(bool _enabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_socket == INVALID_SOCKET_FD)
+        {
+            return { ErrorCode::SocketNotOpen, 0 };
+        }
+
+#if defined(__linux__) && defined(SO_TIMESTAMPING)
+        int flags = _enabled ? SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE : 0;
+        int iResult = setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags));
+        int lastSocketError = SocketUtils::getLastSocketError();
+        if (iResult != 0)
+        {
+            return { ErrorCode::SocketSetOptionFailed, lastSocketError };
+        }
+
+        m_kernelTimestamping = _enabled;
+        return { ErrorCode::Success, 0 };
+#else
+        if (_enabled)
+        {
+            return { ErrorCode::SocketOptionNotSupported, 0 };
+        }
+
+        return { ErrorCode::Success, 0 };
+#endif
     }
 
     std::pair<ErrorCode, int> UdpSocket::setBlocking(bool _blocking)
@@ -171,7 +559,13 @@ namespace tra::core
             return { ErrorCode::SocketNotOpen, 0 };
         }
 
-        return SocketUtils::setBlocking(m_socket, _blocking);
+        std::pair<ErrorCode, int> result = SocketUtils::setBlocking(m_socket, _blocking);
+        if (result.first == ErrorCode::Success)
+        {
+            m_isBlocking = _blocking;
+        }
+
+        return result;
     }
 
     std::pair<ErrorCode, uint16_t> UdpSocket::getPort()
@@ -198,6 +592,21 @@ namespace tra::core
         return m_isBlocking;
     }
 
+    bool UdpSocket::isSegmentationOffloadEnabled() const
+    {
+        return m_segmentationOffload;
+    }
+
+    bool UdpSocket::isReceiveOffloadEnabled() const
+    {
+        return m_receiveOffload;
+    }
+
+    bool UdpSocket::isKernelTimestamping() const
+    {
+        return m_kernelTimestamping;
+    }
+
     bool UdpSocket::isOpen() const
     {
         return m_socket != INVALID_SOCKET_FD;
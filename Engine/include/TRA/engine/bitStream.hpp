@@ -0,0 +1,43 @@
+#ifndef TRA_ENGINE_BIT_STREAM_HPP
+#define TRA_ENGINE_BIT_STREAM_HPP
+
+#include "TRA/export.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace tra::engine
+{
+	class BitWriter
+	{
+	public:
+		TRA_API explicit BitWriter(std::vector<uint8_t>& _data);
+
+		TRA_API void writeBits(uint64_t _value, uint32_t _bitCount);
+		TRA_API std::vector<uint8_t>& alignedBytes();
+		TRA_API void flush();
+
+	private:
+		std::vector<uint8_t>& m_data;
+		uint64_t m_scratch;
+		uint32_t m_scratchBits;
+	};
+
+	class BitReader
+	{
+	public:
+		TRA_API BitReader(const std::vector<uint8_t>& _data, size_t& _offset);
+
+		TRA_API uint64_t readBits(uint32_t _bitCount);
+		TRA_API size_t& alignedOffset();
+		TRA_API const std::vector<uint8_t>& data() const;
+
+	private:
+		const std::vector<uint8_t>& m_data;
+		size_t& m_offset;
+		uint32_t m_bitOffset;
+	};
+}
+
+#endif
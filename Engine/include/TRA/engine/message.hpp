@@ -3,28 +3,49 @@
 
 #include "TRA/export.hpp"
 #include "TRA/debugUtils.hpp"
+#include "TRA/engine/endian.hpp"
+#include "TRA/engine/varint.hpp"
+#include "TRA/engine/bitStream.hpp"
+#include "TRA/engine/quantization.hpp"
 
 #include <string>
 #include <map>
+#include <array>
 #include <vector>
 #include <variant>
 #include <memory>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <algorithm>
+#include <stdexcept>
+#include <type_traits>
 
 namespace tra::engine
 {
-	using FieldValue = std::variant<int, float, std::string>;
-	using SerializerFunc = std::function<void(const void*, std::vector<uint8_t>&)>;
-	using DeserializerFunc = std::function<void(const void*, const std::vector<uint8_t>&, size_t&)>;
+	using FieldValue = std::variant<bool, int8_t, int16_t, int32_t, int64_t, uint8_t, uint16_t, uint32_t, uint64_t,
+		float, double, std::string>;
+	using SerializerFunc = std::function<void(const void*, BitWriter&)>;
+	using DeserializerFunc = std::function<void(const void*, BitReader&)>;
+
+	enum class FieldEncoding
+	{
+		Fixed = 0,
+		Varint
+	};
 
 	struct TRA_API Message
 	{
 	public:
 		virtual ~Message() = default;
 		virtual std::string getType() const = 0;
+		virtual uint32_t getTypeId() const = 0;
 		virtual std::vector<uint8_t> serialize() const = 0;
+		virtual bool isDroppable() const { return false; }
+		virtual bool isCoalescable() const { return false; }
+		virtual uint64_t getCoalesceKey() const { return 0; }
+		// Engine control messages, kept out of the per type statistics.
+		virtual bool isInternal() const { return false; }
 
 		static std::map<uint32_t, std::vector<std::pair<std::string, std::pair<size_t, SerializerFunc>>>>& getSerializers();
 		static std::map<uint32_t, std::vector<std::pair<std::string, std::pair<size_t, DeserializerFunc>>>>& getDeserializers();
@@ -37,39 +58,491 @@ namespace tra::engine
         TRA_API void registerMessageType(const uint32_t _id,
 			std::unique_ptr<Message>(*_creator)(const std::vector<uint8_t>&));
 
-        TRA_API void serializeField(std::vector<uint8_t>& _data, int _value);
-        TRA_API void serializeField(std::vector<uint8_t>& _data, float _value);
+		template<typename T>
+		inline constexpr bool IsTrivialField_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+		template<typename T>
+		inline constexpr bool IsNestedMessage_v = std::is_base_of_v<Message, T>;
+
+		inline void checkFieldBounds(const std::vector<uint8_t>& _data, size_t _offset, size_t _size)
+		{
+			if (_offset > _data.size() || _size > _data.size() - _offset)
+			{
+				throw std::runtime_error("Field out of range");
+			}
+		}
+
+		template<typename T>
+		std::enable_if_t<IsTrivialField_v<T>> serializeField(std::vector<uint8_t>& _data, T _value);
+        TRA_API void serializeField(std::vector<uint8_t>& _data, bool _value);
         TRA_API void serializeField(std::vector<uint8_t>& _data, const std::string& _value);
+        TRA_API void serializeField(std::vector<uint8_t>& _data, const std::vector<bool>& _value);
+		template<typename T, size_t N>
+		void serializeField(std::vector<uint8_t>& _data, const std::array<T, N>& _value);
+		template<size_t N>
+		void serializeField(std::vector<uint8_t>& _data, const std::array<bool, N>& _value);
+		template<typename T>
+		void serializeField(std::vector<uint8_t>& _data, const std::vector<T>& _value);
+		template<typename T>
+		std::enable_if_t<IsNestedMessage_v<T>> serializeField(std::vector<uint8_t>& _data, const T& _value);
+
+		template<typename T>
+		std::enable_if_t<IsTrivialField_v<T>> deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, T& _value);
+        TRA_API void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, bool& _value);
+        TRA_API void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::string& _value);
+        TRA_API void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::vector<bool>& _value);
+		template<typename T, size_t N>
+		void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::array<T, N>& _value);
+		template<size_t N>
+		void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::array<bool, N>& _value);
+		template<typename T>
+		void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::vector<T>& _value);
+		template<typename T>
+		std::enable_if_t<IsNestedMessage_v<T>> deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, T& _value);
+
+		template<typename Container>
+		void serializeBoolBits(std::vector<uint8_t>& _data, const Container& _value, size_t _count)
+		{
+			size_t first = _data.size();
+			_data.resize(first + (_count + 7) / 8, 0);
+			for (size_t i = 0; i < _count; i++)
+			{
+				if (_value[i])
+				{
+					_data[first + i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+				}
+			}
+		}
+
+		template<typename Container>
+		void deserializeBoolBits(const std::vector<uint8_t>& _data, size_t& _offset, Container& _value, size_t _count)
+		{
+			size_t byteCount = (_count + 7) / 8;
+			checkFieldBounds(_data, _offset, byteCount);
+			for (size_t i = 0; i < _count; i++)
+			{
+				_value[i] = (_data[_offset + i / 8] >> (i % 8)) & 1u;
+			}
+			_offset += byteCount;
+		}
 
 		template<typename T>
+		void serializeTrivialRange(std::vector<uint8_t>& _data, const T* _values, size_t _count)
+		{
+			if constexpr (Endian::IsMemcpyCompatible_v<T>)
+			{
+				_data.insert(_data.end(), reinterpret_cast<const uint8_t*>(_values),
+					reinterpret_cast<const uint8_t*>(_values) + sizeof(T) * _count);
+			}
+			else
+			{
+				size_t offset = _data.size();
+				_data.resize(offset + Endian::wireSize<T>() * _count);
+				for (size_t i = 0; i < _count; i++)
+				{
+					Endian::storeLittle(_data.data() + offset + i * Endian::wireSize<T>(), _values[i]);
+				}
+			}
+		}
+
+		template<typename T>
+		void deserializeTrivialRange(const std::vector<uint8_t>& _data, size_t& _offset, T* _values, size_t _count)
+		{
+			checkFieldBounds(_data, _offset, Endian::wireSize<T>() * _count);
+
+			if constexpr (Endian::IsMemcpyCompatible_v<T>)
+			{
+				std::memcpy(_values, _data.data() + _offset, sizeof(T) * _count);
+			}
+			else
+			{
+				for (size_t i = 0; i < _count; i++)
+				{
+					_values[i] = Endian::loadLittle<T>(_data.data() + _offset + i * Endian::wireSize<T>());
+				}
+			}
+
+			_offset += Endian::wireSize<T>() * _count;
+		}
+
+		template<typename T>
+		std::enable_if_t<IsTrivialField_v<T>> serializeField(std::vector<uint8_t>& _data, T _value)
+		{
+			Endian::appendLittle(_data, _value);
+		}
+
+		template<typename T, size_t N>
+		void serializeField(std::vector<uint8_t>& _data, const std::array<T, N>& _value)
+		{
+			if constexpr (IsTrivialField_v<T>)
+			{
+				serializeTrivialRange(_data, _value.data(), N);
+			}
+			else
+			{
+				for (const T& element : _value)
+				{
+					serializeField(_data, element);
+				}
+			}
+		}
+
+		template<size_t N>
+		void serializeField(std::vector<uint8_t>& _data, const std::array<bool, N>& _value)
+		{
+			serializeBoolBits(_data, _value, N);
+		}
+
+		template<typename T>
+		void serializeField(std::vector<uint8_t>& _data, const std::vector<T>& _value)
+		{
+			serializeField(_data, static_cast<uint32_t>(_value.size()));
+
+			if constexpr (IsTrivialField_v<T>)
+			{
+				serializeTrivialRange(_data, _value.data(), _value.size());
+			}
+			else
+			{
+				for (const T& element : _value)
+				{
+					serializeField(_data, element);
+				}
+			}
+		}
+
+		template<typename T>
+		std::enable_if_t<IsNestedMessage_v<T>> serializeField(std::vector<uint8_t>& _data, const T& _value)
+		{
+			auto& serializers = Message::getSerializers();
+			auto it = serializers.find(T::MESSAGE_TYPE_ID);
+			if (it == serializers.end())
+			{
+				return;
+			}
+
+			BitWriter writer(_data);
+			for (const auto& [fieldName, fieldData] : it->second)
+			{
+				fieldData.second(&_value, writer);
+			}
+			writer.flush();
+		}
+
+		template<typename T>
+		std::enable_if_t<IsTrivialField_v<T>> deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, T& _value)
+		{
+			deserializeTrivialRange(_data, _offset, &_value, 1);
+		}
+
+		template<typename T, size_t N>
+		void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::array<T, N>& _value)
+		{
+			if constexpr (IsTrivialField_v<T>)
+			{
+				deserializeTrivialRange(_data, _offset, _value.data(), N);
+			}
+			else
+			{
+				for (T& element : _value)
+				{
+					deserializeField(_data, _offset, element);
+				}
+			}
+		}
+
+		template<size_t N>
+		void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::array<bool, N>& _value)
+		{
+			deserializeBoolBits(_data, _offset, _value, N);
+		}
+
+		template<typename T>
+		void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::vector<T>& _value)
+		{
+			uint32_t size = 0;
+			deserializeField(_data, _offset, size);
+
+			if constexpr (IsTrivialField_v<T>)
+			{
+				checkFieldBounds(_data, _offset, Endian::wireSize<T>() * static_cast<size_t>(size));
+				_value.resize(size);
+				deserializeTrivialRange(_data, _offset, _value.data(), _value.size());
+			}
+			else
+			{
+				_value.clear();
+				_value.reserve(std::min(static_cast<size_t>(size), _data.size() - _offset));
+				for (uint32_t i = 0; i < size; i++)
+				{
+					deserializeField(_data, _offset, _value.emplace_back());
+				}
+			}
+		}
+
+		template<typename T>
+		std::enable_if_t<IsNestedMessage_v<T>> deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, T& _value)
+		{
+			auto& deserializers = Message::getDeserializers();
+			auto it = deserializers.find(T::MESSAGE_TYPE_ID);
+			if (it == deserializers.end())
+			{
+				return;
+			}
+
+			BitReader reader(_data, _offset);
+			for (const auto& [fieldName, fieldData] : it->second)
+			{
+				fieldData.second(&_value, reader);
+			}
+			reader.alignedOffset();
+		}
+
+		template<typename T>
+		struct IsStdVector : std::false_type {};
+
+		template<typename T>
+		struct IsStdVector<std::vector<T>> : std::true_type {};
+
+		template<typename T>
+		inline constexpr bool IsVarintField_v = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+		template<typename T>
+		inline constexpr bool IsFixedFallbackField_v = !IsVarintField_v<T> && !IsStdVector<T>::value && !std::is_same_v<T, std::string>;
+
+		template<typename T>
+		uint64_t toVarintBits(T _value)
+		{
+			if constexpr (std::is_signed_v<T>)
+			{
+				return zigZagEncode(static_cast<int64_t>(_value));
+			}
+			else
+			{
+				return static_cast<uint64_t>(_value);
+			}
+		}
+
+		template<typename T>
+		T fromVarintBits(uint64_t _value)
+		{
+			if constexpr (std::is_signed_v<T>)
+			{
+				return static_cast<T>(zigZagDecode(_value));
+			}
+			else
+			{
+				return static_cast<T>(_value);
+			}
+		}
+
+		template<typename T>
+		std::enable_if_t<IsVarintField_v<T>> serializeVarintField(std::vector<uint8_t>& _data, T _value)
+		{
+			writeVarint(_data, toVarintBits(_value));
+		}
+
+		inline void serializeVarintField(std::vector<uint8_t>& _data, const std::string& _value)
+		{
+			writeVarint(_data, _value.size());
+			_data.insert(_data.end(), _value.begin(), _value.end());
+		}
+
+		template<typename T>
+		std::enable_if_t<IsFixedFallbackField_v<T>> serializeVarintField(std::vector<uint8_t>& _data, const T& _value)
+		{
+			serializeField(_data, _value);
+		}
+
+		template<typename T>
+		void serializeVarintField(std::vector<uint8_t>& _data, const std::vector<T>& _value)
+		{
+			writeVarint(_data, _value.size());
+
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				serializeBoolBits(_data, _value, _value.size());
+			}
+			else
+			{
+				for (const T& element : _value)
+				{
+					serializeVarintField(_data, element);
+				}
+			}
+		}
+
+		template<typename T>
+		std::enable_if_t<IsVarintField_v<T>> deserializeVarintField(const std::vector<uint8_t>& _data, size_t& _offset, T& _value)
+		{
+			_value = fromVarintBits<T>(readVarint(_data, _offset));
+		}
+
+		inline void deserializeVarintField(const std::vector<uint8_t>& _data, size_t& _offset, std::string& _value)
+		{
+			uint64_t size = readVarint(_data, _offset);
+			checkFieldBounds(_data, _offset, static_cast<size_t>(size));
+			_value.assign(reinterpret_cast<const char*>(_data.data() + _offset), static_cast<size_t>(size));
+			_offset += static_cast<size_t>(size);
+		}
+
+		template<typename T>
+		std::enable_if_t<IsFixedFallbackField_v<T>> deserializeVarintField(const std::vector<uint8_t>& _data, size_t& _offset, T& _value)
+		{
+			deserializeField(_data, _offset, _value);
+		}
+
+		template<typename T>
+		void deserializeVarintField(const std::vector<uint8_t>& _data, size_t& _offset, std::vector<T>& _value)
+		{
+			uint64_t size = readVarint(_data, _offset);
+			if (size > _data.size() - _offset && !std::is_same_v<T, bool>)
+			{
+				throw std::runtime_error("Field out of range");
+			}
+
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				checkFieldBounds(_data, _offset, (static_cast<size_t>(size) + 7) / 8);
+				_value.assign(static_cast<size_t>(size), false);
+				deserializeBoolBits(_data, _offset, _value, _value.size());
+			}
+			else if constexpr (IsVarintField_v<T>)
+			{
+				_value.resize(static_cast<size_t>(size));
+
+				uint64_t decoded[64];
+				for (size_t first = 0; first < _value.size(); first += 64)
+				{
+					size_t count = std::min<size_t>(64, _value.size() - first);
+					size_t consumed = 0;
+					if (!decodeVarintRun(_data.data() + _offset, _data.size() - _offset, consumed, decoded, count))
+					{
+						throw std::runtime_error("Varint out of range");
+					}
+
+					for (size_t i = 0; i < count; i++)
+					{
+						_value[first + i] = fromVarintBits<T>(decoded[i]);
+					}
+
+					_offset += consumed;
+				}
+			}
+			else
+			{
+				_value.clear();
+				_value.reserve(static_cast<size_t>(size));
+				for (uint64_t i = 0; i < size; i++)
+				{
+					deserializeVarintField(_data, _offset, _value.emplace_back());
+				}
+			}
+		}
+
+		template<typename T, FieldEncoding Encoding = FieldEncoding::Fixed>
 		void registerSerializer(const uint32_t _messageId, const std::string& _fieldName, size_t _fieldOffset)
 		{
 			auto& serializers = Message::getSerializers();
-			serializers[_messageId].emplace_back(_fieldName, std::make_pair(_fieldOffset, [_fieldOffset](const void* base, std::vector<uint8_t>& data) {
+			serializers[_messageId].emplace_back(_fieldName, std::make_pair(_fieldOffset, [_fieldOffset](const void* base, BitWriter& writer) {
 				const T* field = reinterpret_cast<const T*>(static_cast<const char*>(base) + _fieldOffset);
-				serializeField(data, *field);
+				if constexpr (Encoding == FieldEncoding::Varint)
+				{
+					serializeVarintField(writer.alignedBytes(), *field);
+				}
+				else
+				{
+					serializeField(writer.alignedBytes(), *field);
+				}
 				}));
 		}
 
-        TRA_API void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, int& _value);
-        TRA_API void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, float& _value);
-        TRA_API void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::string& _value);
-
-		template<typename T>
+		template<typename T, FieldEncoding Encoding = FieldEncoding::Fixed>
 		void registerDeserializer(const uint32_t _messageId, const std::string& _fieldName, size_t _fieldOffset)
 		{
 			auto& deserializers = Message::getDeserializers();
 			deserializers[_messageId].emplace_back(_fieldName, std::make_pair(_fieldOffset,
-				[_fieldOffset](const void* base, const std::vector<uint8_t>& data, size_t& offset) {
+				[_fieldOffset](const void* base, BitReader& reader) {
 					T* field = reinterpret_cast<T*>(static_cast<char*>(const_cast<void*>(base)) + _fieldOffset);
-					deserializeField(data, offset, *field);
+					if constexpr (Encoding == FieldEncoding::Varint)
+					{
+						deserializeVarintField(reader.data(), reader.alignedOffset(), *field);
+					}
+					else
+					{
+						deserializeField(reader.data(), reader.alignedOffset(), *field);
+					}
 				}));
 		}
+
+		template<typename T>
+		void registerBitField(const uint32_t _messageId, const std::string& _fieldName, size_t _fieldOffset,
+			std::function<uint64_t(const T&)> _encode, std::function<T(uint64_t)> _decode, uint32_t _bitCount)
+		{
+			Message::getSerializers()[_messageId].emplace_back(_fieldName, std::make_pair(_fieldOffset,
+				[_fieldOffset, _encode, _bitCount](const void* base, BitWriter& writer) {
+					const T* field = reinterpret_cast<const T*>(static_cast<const char*>(base) + _fieldOffset);
+					writer.writeBits(_encode(*field), _bitCount);
+				}));
+
+			Message::getDeserializers()[_messageId].emplace_back(_fieldName, std::make_pair(_fieldOffset,
+				[_fieldOffset, _decode, _bitCount](const void* base, BitReader& reader) {
+					T* field = reinterpret_cast<T*>(static_cast<char*>(const_cast<void*>(base)) + _fieldOffset);
+					*field = _decode(reader.readBits(_bitCount));
+				}));
+		}
+
+		inline void registerQuantizedFloatField(const uint32_t _messageId, const std::string& _fieldName, size_t _fieldOffset,
+			float _min, float _max, float _precision)
+		{
+			uint32_t bitCount = Quantization::quantizedFloatBits(_min, _max, _precision);
+			if (bitCount == 0 || bitCount > Quantization::MAX_FIELD_BITS)
+			{
+				throw std::invalid_argument("Quantized float field " + _fieldName + " needs 1 to 64 bits");
+			}
+
+			registerBitField<float>(_messageId, _fieldName, _fieldOffset,
+				[_min, _max, _precision](const float& value) { return Quantization::quantizeFloat(value, _min, _max, _precision); },
+				[_min, _max, _precision](uint64_t value) { return Quantization::dequantizeFloat(value, _min, _max, _precision); },
+				bitCount);
+		}
+
+		template<typename T>
+		void registerBoundedIntField(const uint32_t _messageId, const std::string& _fieldName, size_t _fieldOffset, int64_t _min, int64_t _max)
+		{
+			static_assert(std::is_integral_v<T>, "Bounded fields must be integers");
+
+			if (_min > _max)
+			{
+				throw std::invalid_argument("Bounded field " + _fieldName + " has min above max");
+			}
+
+			// Unsigned so a full int64_t range does not overflow; it still fits 64 bits.
+			uint32_t bitCount = Quantization::bitsRequired(static_cast<uint64_t>(_max) - static_cast<uint64_t>(_min));
+
+			registerBitField<T>(_messageId, _fieldName, _fieldOffset,
+				[_min, _max](const T& value) { return static_cast<uint64_t>(std::clamp<int64_t>(static_cast<int64_t>(value), _min, _max)) - static_cast<uint64_t>(_min); },
+				[_min, _max](uint64_t value) { return static_cast<T>(std::min<int64_t>(static_cast<int64_t>(value + static_cast<uint64_t>(_min)), _max)); },
+				bitCount);
+		}
+
+		template<uint32_t ComponentBits>
+		void registerQuaternionField(const uint32_t _messageId, const std::string& _fieldName, size_t _fieldOffset)
+		{
+			static_assert(ComponentBits >= 1 && ComponentBits <= Quantization::MAX_QUATERNION_COMPONENT_BITS,
+				"Quaternion fields take 1 to 20 bits per component");
+
+			registerBitField<Quaternion>(_messageId, _fieldName, _fieldOffset,
+				[](const Quaternion& value) { return Quantization::encodeQuaternion(value, ComponentBits); },
+				[](uint64_t value) { return Quantization::decodeQuaternion(value, ComponentBits); },
+				2 + 3 * ComponentBits);
+		}
 	}
 }
 
 #define DECLARE_MESSAGE_BEGIN(MessageType) \
 namespace tra::message { \
+    using namespace ::tra::engine; \
     struct MessageType : public Message \
     { \
     public: \
@@ -77,7 +550,7 @@ namespace tra::message { \
         inline static uint32_t MESSAGE_TYPE_ID = internal::hashTypeName(MESSAGE_TYPE_NAME); \
         using CurrentMessageType = MessageType;
 
-#define FIELD(type, name) \
+#define TRA_DECLARE_FIELD_WITH(type, name, ...) \
     type name; \
     private: \
         struct name##_Registrar \
@@ -85,44 +558,83 @@ namespace tra::message { \
             name##_Registrar() \
             { \
                 const auto offset = reinterpret_cast<size_t>(&(static_cast<CurrentMessageType*>(nullptr)->name)); \
-                internal::registerSerializer<type>(MESSAGE_TYPE_ID, #name, offset); \
-                internal::registerDeserializer<type>(MESSAGE_TYPE_ID, #name, offset); \
+                __VA_ARGS__; \
             } \
         }; \
         inline static name##_Registrar name##_reg; \
     public: \
 
+#define TRA_DECLARE_FIELD(type, name, encoding) \
+    TRA_DECLARE_FIELD_WITH(type, name, \
+        internal::registerSerializer<type, encoding>(MESSAGE_TYPE_ID, #name, offset); \
+        internal::registerDeserializer<type, encoding>(MESSAGE_TYPE_ID, #name, offset))
+
+#define FIELD(type, name) \
+    TRA_DECLARE_FIELD(type, name, FieldEncoding::Fixed)
+
+#define FIELD_VARINT(type, name) \
+    TRA_DECLARE_FIELD(type, name, FieldEncoding::Varint)
+
+#define FIELD_ARRAY(type, size, name) \
+    using name##_ArrayType = std::array<type, size>; \
+    FIELD(name##_ArrayType, name)
+
+#define FIELD_QUANTIZED_FLOAT(name, min, max, precision) \
+    TRA_DECLARE_FIELD_WITH(float, name, \
+        internal::registerQuantizedFloatField(MESSAGE_TYPE_ID, #name, offset, min, max, precision))
+
+#define FIELD_BOUNDED_INT(type, name, min, max) \
+    TRA_DECLARE_FIELD_WITH(type, name, \
+        internal::registerBoundedIntField<type>(MESSAGE_TYPE_ID, #name, offset, min, max))
+
+#define FIELD_QUATERNION(name, componentBits) \
+    TRA_DECLARE_FIELD_WITH(Quaternion, name, \
+        internal::registerQuaternionField<componentBits>(MESSAGE_TYPE_ID, #name, offset))
+
+#define MESSAGE_DROPPABLE() \
+        bool isDroppable() const override { return true; }
+
+#define MESSAGE_COALESCE() \
+        bool isCoalescable() const override { return true; }
+
+#define MESSAGE_COALESCE_BY(name) \
+        MESSAGE_COALESCE() \
+        uint64_t getCoalesceKey() const override { return static_cast<uint64_t>(name); }
+
+#define MESSAGE_INTERNAL() \
+        bool isInternal() const override { return true; }
+
 #define DECLARE_MESSAGE_END() \
         std::string getType() const override { return MESSAGE_TYPE_NAME; } \
+        uint32_t getTypeId() const override { return MESSAGE_TYPE_ID; } \
         std::vector<uint8_t> serialize() const override \
         { \
             std::vector<uint8_t> data; \
-            uint32_t typeId = MESSAGE_TYPE_ID; \
-            data.insert(data.end(), \
-                reinterpret_cast<const uint8_t*>(&typeId), \
-                reinterpret_cast<const uint8_t*>(&typeId) + sizeof(typeId)); \
             auto& serializers = getSerializers(); \
             auto it = serializers.find(MESSAGE_TYPE_ID); \
             if (it != serializers.end()) \
             { \
+                BitWriter writer(data); \
                 for (const auto& [fieldName, fieldData] : it->second) \
                 { \
-                    fieldData.second(this, data); \
+                    fieldData.second(this, writer); \
                 } \
+                writer.flush(); \
             } \
             return data; \
         } \
         static std::unique_ptr<Message> createFromBytes(const std::vector<uint8_t>& _payload) \
         { \
             std::unique_ptr<CurrentMessageType> message = std::make_unique<CurrentMessageType>(); \
-            size_t offset = sizeof(uint32_t); \
+            size_t offset = 0; \
             auto& deserializers = getDeserializers(); \
             auto it = deserializers.find(MESSAGE_TYPE_ID); \
             if (it != deserializers.end()) \
             { \
+                BitReader reader(_payload, offset); \
                 for (const auto& [fieldName, fieldData] : it->second) \
                 { \
-                    fieldData.second(message.get(), _payload, offset); \
+                    fieldData.second(message.get(), reader); \
                 } \
             } \
             return message; \
@@ -13,6 +13,7 @@
 
 #include "TRA/errorCode.hpp"
 #include "TRA/debugUtils.hpp"
+#include "TRA/engine/tickProfiler.hpp"
 
 namespace tra::engine
 {
@@ -72,10 +73,10 @@ namespace tra::engine
 		}
 	};
 
-	class NetworkEcs
+	class TRA_API NetworkEcs
 	{
 	public:
-		NetworkEcs() = default;
+		NetworkEcs();
 		~NetworkEcs() = default;
 
 		EntityId createEntity();
@@ -88,6 +89,8 @@ namespace tra::engine
 		void beginUpdate();
 		void endUpdate();
 
+		TickProfiler& getProfiler() { return m_profiler; }
+
 		template<typename ComponentType>
 		ErrorCode addComponentToEntity(EntityId _entityId, std::shared_ptr<ComponentType> _component)
 		{
@@ -190,6 +193,11 @@ namespace tra::engine
 		std::vector<std::shared_ptr<INetworkSystem>> m_beginUpdateSystems;
 		std::vector<std::shared_ptr<INetworkSystem>> m_endUpdateSystems;
 
+		TickProfiler m_profiler;
+		std::vector<size_t> m_beginUpdateSlots;
+		std::vector<size_t> m_endUpdateSlots;
+		size_t m_destroyEntitiesSlot;
+
 		template<typename ComponentType>
 		std::weak_ptr<SparseSet<ComponentType>> getOrCreateComponentStore()
 		{
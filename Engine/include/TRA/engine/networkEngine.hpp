@@ -8,17 +8,82 @@
 #include "TRA/errorCode.hpp"
 #include "TRA/core/tcpSocket.hpp"
 #include "TRA/core/udpSocket.hpp"
+#include "TRA/core/metrics.hpp"
 
 #include "TRA/engine/networkEcs.hpp"
+#include "TRA/engine/networkEngineConfig.hpp"
+#include "TRA/engine/udpChannel.hpp"
 
 namespace tra::engine
 {
 	struct Message;
+	struct MigratedConnection;
+	struct EngineMetrics;
+
+	struct ReceiveQueueDepth
+	{
+		size_t m_bufferedBytes = 0;
+		size_t m_deficit = 0;
+		uint32_t m_deferredTicks = 0;
+	};
+
+	// Lifetime totals of one TCP connection plus its current queue sizes.
+	struct ConnectionStats
+	{
+		uint64_t m_bytesSent = 0;
+		uint64_t m_bytesReceived = 0;
+		uint64_t m_messagesSent = 0;
+		uint64_t m_messagesReceived = 0;
+		uint64_t m_partialSends = 0;
+		uint64_t m_deserializeFailures = 0;
+		size_t m_sendQueueBytes = 0;
+		size_t m_receiveBufferedBytes = 0;
+
+		// Filled once timestamped frames have flowed both ways, see
+		// NetworkEngineConfig::m_latencyTimestamps.
+		bool m_clockSynchronized = false;
+		int64_t m_clockOffsetNs = 0;
+		uint64_t m_roundTripNs = 0;
+
+		// Smoothed kernel timestamps, see NetworkEngineConfig::m_kernelTimestamps:
+		// send call to leaving the stack, leaving the stack to the peer's ACK,
+		// and received data waiting to be read.
+		uint64_t m_kernelSendDelayNs = 0;
+		uint64_t m_wireRoundTripNs = 0;
+		uint64_t m_kernelReceiveDelayNs = 0;
+	};
+
+	struct LatencySummary
+	{
+		uint64_t m_count = 0;
+		uint64_t m_minNs = 0;
+		uint64_t m_p50Ns = 0;
+		uint64_t m_p90Ns = 0;
+		uint64_t m_p99Ns = 0;
+		uint64_t m_p999Ns = 0;
+		uint64_t m_maxNs = 0;
+	};
+
+	// TCP latency of one message type, split by stage:
+	// - queue: sendTcpMessage to the first byte written, on the sender.
+	// - network: first byte written to the frame being read, skew corrected.
+	// - receive: frame read to decoded and handed to getTcpMessages.
+	// - endToEnd: sendTcpMessage on the peer to decoded here, skew corrected.
+	// Queue is recorded by the sending engine, the others by the receiving one.
+	// Engine control messages (heartbeats, the UDP handshake) are left out.
+	struct MessageLatency
+	{
+		std::string m_messageType;
+		LatencySummary m_queue;
+		LatencySummary m_network;
+		LatencySummary m_receive;
+		LatencySummary m_endToEnd;
+	};
 
 	class NetworkEngine
 	{
 	public:
-		TRA_API NetworkEngine();
+		TRA_API NetworkEngine(const NetworkEngineConfig& _config = NetworkEngineConfig());
 		TRA_API ~NetworkEngine();
 
 		TRA_API ErrorCode startTcpListenOnPort(uint16_t _port, bool _blocking);
@@ -37,9 +102,45 @@ namespace tra::engine
 
 		TRA_API ErrorCode sendTcpMessage(EntityId _entityId, std::shared_ptr<Message> _message);
 		TRA_API std::vector<std::shared_ptr<Message>> getTcpMessages(EntityId _entityId, const std::string& _messageType);
+		TRA_API std::pair<ErrorCode, ReceiveQueueDepth> getReceiveQueueDepth(EntityId _entityId);
+		TRA_API std::pair<ErrorCode, ConnectionStats> getConnectionStats(EntityId _entityId);
+
+		// Refused with UdpMessageTooLarge when the message does not fit in one
+		// datagram of m_udpMaxPacketSize, as UDP messages are never fragmented.
+		TRA_API ErrorCode sendUdpMessage(EntityId _entityId, std::shared_ptr<Message> _message, UdpChannel _channel);
+		TRA_API std::vector<std::shared_ptr<Message>> getUdpMessages(EntityId _entityId, const std::string& _messageType);
+		TRA_API bool isUdpConnected(EntityId _entityId);
+
+		TRA_API std::pair<ErrorCode, std::shared_ptr<MigratedConnection>> detachConnection(EntityId _entityId);
+		TRA_API std::pair<ErrorCode, EntityId> attachConnection(std::shared_ptr<MigratedConnection> _connection);
+
+		TRA_API core::MetricsSnapshot getMetricsSnapshot();
+		TRA_API ErrorCode dumpMetrics(const std::string& _path);
+
+		// Serves the Prometheus text over HTTP on 127.0.0.1:_port, answered from
+		// beginUpdate.
+		TRA_API ErrorCode startMetricsEndpoint(uint16_t _port);
+		TRA_API ErrorCode stopMetricsEndpoint();
+
+		TRA_API std::vector<MessageLatency> getMessageLatencies() const;
+		TRA_API void resetMessageLatencies();
+
+		TRA_API std::vector<SystemTiming> getTickProfile() const;
+		TRA_API void startTickTrace(size_t _maxEvents = 1 << 20);
+		TRA_API void stopTickTrace();
+		TRA_API ErrorCode writeTickTrace(const std::string& _path) const;
+
+		// Records every TCP frame received, as it was on the wire, to _path
+		// until stopCapture, for TrafficReplayer to feed back through the
+		// decoder.
+		TRA_API ErrorCode startCapture(const std::string& _path);
+		TRA_API ErrorCode stopCapture();
 
 		TRA_API EntityId getSelfEntityId();
 
+		TRA_API const NetworkEngineConfig& getConfig() const;
+		TRA_API void setConfig(const NetworkEngineConfig& _config);
+
 		template<typename ComponentType>
 		ErrorCode addComponentToEntity(EntityId _entityId, std::shared_ptr<ComponentType> _component)
 		{
@@ -65,10 +166,13 @@ namespace tra::engine
 		}
 
 	private:
-		core::UdpSocket* m_udpSocket;
+		NetworkEngineConfig m_config;
 
 		NetworkEcs* m_networkEcs;
 
+		core::MetricsRegistry* m_metricsRegistry;
+		EngineMetrics* m_metrics;
+
 		EntityId m_selfEntityId;
 	};
 }
@@ -0,0 +1,35 @@
+#ifndef TRA_ENGINE_QUANTIZATION_HPP
+#define TRA_ENGINE_QUANTIZATION_HPP
+
+#include "TRA/export.hpp"
+
+#include <cstdint>
+
+namespace tra::engine
+{
+	struct Quaternion
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+		float w = 1.0f;
+	};
+
+	namespace Quantization
+	{
+		// Bit fields travel as one uint64_t; a quaternion needs 2 + 3 * componentBits.
+		constexpr uint32_t MAX_FIELD_BITS = 64;
+		constexpr uint32_t MAX_QUATERNION_COMPONENT_BITS = 20;
+
+		TRA_API uint32_t bitsRequired(uint64_t _maxValue);
+
+		TRA_API uint64_t quantizeFloat(float _value, float _min, float _max, float _precision);
+		TRA_API float dequantizeFloat(uint64_t _value, float _min, float _max, float _precision);
+		TRA_API uint32_t quantizedFloatBits(float _min, float _max, float _precision);
+
+		TRA_API uint64_t encodeQuaternion(const Quaternion& _value, uint32_t _componentBits);
+		TRA_API Quaternion decodeQuaternion(uint64_t _value, uint32_t _componentBits);
+	}
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef TRA_ENGINE_TICK_PROFILER_HPP
+#define TRA_ENGINE_TICK_PROFILER_HPP
+
+#include "TRA/export.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "TRA/errorCode.hpp"
+
+namespace tra::engine
+{
+	enum class TickPhase : uint8_t
+	{
+		BeginUpdate,
+		EndUpdate
+	};
+
+	// Rolling timings of one system (or of a whole phase) over the last
+	// TickProfiler::WINDOW_SIZE ticks, in nanoseconds.
+	struct SystemTiming
+	{
+		std::string m_name;
+		TickPhase m_phase = TickPhase::BeginUpdate;
+		uint64_t m_samples = 0;
+		uint64_t m_lastNs = 0;
+		uint64_t m_p50Ns = 0;
+		uint64_t m_p99Ns = 0;
+		uint64_t m_maxNs = 0;
+	};
+
+	// Times every system update of a NetworkEcs. Recording is two clock reads
+	// and a ring write per system; percentiles are only computed when asked
+	// for. While a trace is running each span is also kept, up to a fixed
+	// number of events, for export to the Chrome trace-event format.
+	class TickProfiler
+	{
+	public:
+		static constexpr size_t WINDOW_SIZE = 1024;
+
+		// Slot of the timing that spans a whole beginUpdate or endUpdate.
+		static constexpr size_t BEGIN_UPDATE_SLOT = 0;
+		static constexpr size_t END_UPDATE_SLOT = 1;
+
+		TickProfiler();
+
+		static uint64_t now()
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+		size_t addSlot(const char* _name, TickPhase _phase);
+
+		bool isEnabled() const { return m_enabled; }
+		void setEnabled(bool _enabled) { m_enabled = _enabled; }
+
+		void record(size_t _slot, uint64_t _startNs, uint64_t _endNs);
+
+		std::vector<SystemTiming> getTimings() const;
+
+		void startTrace(size_t _maxEvents);
+		void stopTrace();
+		bool isTracing() const { return m_tracing; }
+
+		// Writes the spans captured so far as Chrome trace-event JSON, which
+		// chrome://tracing and Perfetto open directly.
+		ErrorCode writeChromeTrace(const std::string& _path) const;
+
+	private:
+		struct Slot
+		{
+			const char* m_name;
+			TickPhase m_phase;
+			uint64_t m_samples = 0;
+			std::vector<uint64_t> m_window;
+		};
+
+		struct TraceEvent
+		{
+			uint32_t m_slot;
+			uint64_t m_startNs;
+			uint64_t m_durationNs;
+		};
+
+		std::vector<Slot> m_slots;
+		bool m_enabled;
+
+		bool m_tracing;
+		size_t m_maxTraceEvents;
+		uint64_t m_traceStartNs;
+		std::vector<TraceEvent> m_traceEvents;
+	};
+
+	// Records the time from construction to destruction into one slot.
+	class ScopedTickTimer
+	{
+	public:
+		ScopedTickTimer(TickProfiler& _profiler, size_t _slot)
+			: m_profiler(_profiler), m_slot(_slot), m_startNs(_profiler.isEnabled() ? TickProfiler::now() : 0)
+		{
+		}
+
+		~ScopedTickTimer()
+		{
+			if (m_profiler.isEnabled() && m_startNs != 0)
+			{
+				m_profiler.record(m_slot, m_startNs, TickProfiler::now());
+			}
+		}
+
+		ScopedTickTimer(const ScopedTickTimer&) = delete;
+		ScopedTickTimer& operator=(const ScopedTickTimer&) = delete;
+
+	private:
+		TickProfiler& m_profiler;
+		size_t m_slot;
+		uint64_t m_startNs;
+	};
+}
+
+#endif
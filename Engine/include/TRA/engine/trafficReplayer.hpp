@@ -0,0 +1,112 @@
+#ifndef TRA_ENGINE_TRAFFIC_REPLAYER_HPP
+#define TRA_ENGINE_TRAFFIC_REPLAYER_HPP
+
+#include "TRA/export.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TRA/errorCode.hpp"
+#include "TRA/core/metrics.hpp"
+
+#include "TRA/engine/networkEcs.hpp"
+#include "TRA/engine/networkEngineConfig.hpp"
+
+namespace tra::engine
+{
+	struct Message;
+	struct EngineMetrics;
+	struct ReceiveTcpMessageSystem;
+	struct ReceiveTcpMessageComponent;
+	class TrafficCaptureReader;
+	struct CaptureRecord;
+
+	enum class ReplaySpeed
+	{
+		// Ticks are spaced as they were captured.
+		Original,
+		// Ticks follow each other without waiting.
+		Max
+	};
+
+	struct ReplayStats
+	{
+		uint64_t m_ticks = 0;
+		uint64_t m_frames = 0;
+		uint64_t m_bytes = 0;
+		uint64_t m_messages = 0;
+		uint64_t m_connections = 0;
+		// Time spent in the decoder, and the span of the capture replayed.
+		uint64_t m_decodeNs = 0;
+		uint64_t m_captureNs = 0;
+	};
+
+	// Feeds a capture written by NetworkEngine::startCapture through the TCP
+	// receive system, without sockets, so decoder and handler changes can be
+	// measured against recorded traffic. Frames recorded in the same tick are
+	// decoded in the same step. Only message types registered in this process
+	// are decoded, others are skipped as the engine would.
+	class TrafficReplayer
+	{
+	public:
+		TRA_API TrafficReplayer(const NetworkEngineConfig& _config = NetworkEngineConfig());
+		TRA_API ~TrafficReplayer();
+
+		TrafficReplayer(const TrafficReplayer&) = delete;
+		TrafficReplayer& operator=(const TrafficReplayer&) = delete;
+
+		TRA_API ErrorCode open(const std::string& _path);
+
+		// Decodes the next captured tick. Returns false once the capture is
+		// exhausted and every frame has been decoded.
+		TRA_API bool step(ReplaySpeed _speed);
+		// Back to the start of the capture with fresh connections and stats.
+		TRA_API void rewind();
+
+		// One entity per captured connection. A connection whose frames were
+		// dropped from the capture continues on a new entity.
+		TRA_API std::vector<EntityId> getConnectionIds() const;
+		// The messages decoded for _entityId by the last step.
+		TRA_API std::vector<std::shared_ptr<Message>> getTcpMessages(EntityId _entityId, const std::string& _messageType);
+
+		TRA_API const ReplayStats& getStats() const;
+		TRA_API core::MetricsSnapshot getMetricsSnapshot();
+
+	private:
+		void feedRecord();
+		void destroyConnections();
+
+		NetworkEngineConfig m_config;
+
+		NetworkEcs* m_networkEcs;
+		core::MetricsRegistry* m_metricsRegistry;
+		EngineMetrics* m_metrics;
+		ReceiveTcpMessageSystem* m_receiveSystem;
+		TrafficCaptureReader* m_reader;
+
+		struct ReplayConnection
+		{
+			EntityId m_entityId = 0;
+			std::shared_ptr<ReceiveTcpMessageComponent> m_component;
+			uint16_t m_nextSequence = 0;
+		};
+
+		// Captured entity id to the replay connection carrying it.
+		std::unordered_map<EntityId, ReplayConnection> m_connections;
+		std::vector<EntityId> m_connectionIds;
+
+		// The first record not yet fed, read ahead to find where a tick ends.
+		CaptureRecord* m_record;
+		bool m_hasRecord;
+		// Where the capture's first tick was replayed, and when.
+		uint64_t m_firstTickNs;
+		uint64_t m_replayStartNs;
+
+		ReplayStats m_stats;
+	};
+}
+
+#endif
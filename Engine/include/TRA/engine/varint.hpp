@@ -0,0 +1,60 @@
+#ifndef TRA_ENGINE_VARINT_HPP
+#define TRA_ENGINE_VARINT_HPP
+
+#include "TRA/export.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+namespace tra::engine::internal
+{
+	constexpr size_t MAX_VARINT_SIZE = 10;
+
+	constexpr uint64_t zigZagEncode(int64_t _value)
+	{
+		return (static_cast<uint64_t>(_value) << 1) ^ static_cast<uint64_t>(_value >> 63);
+	}
+
+	constexpr int64_t zigZagDecode(uint64_t _value)
+	{
+		return static_cast<int64_t>(_value >> 1) ^ -static_cast<int64_t>(_value & 1);
+	}
+
+	inline void writeVarint(std::vector<uint8_t>& _data, uint64_t _value)
+	{
+		while (_value >= 0x80)
+		{
+			_data.push_back(static_cast<uint8_t>(_value | 0x80));
+			_value >>= 7;
+		}
+
+		_data.push_back(static_cast<uint8_t>(_value));
+	}
+
+	inline uint64_t readVarint(const std::vector<uint8_t>& _data, size_t& _offset)
+	{
+		uint64_t value = 0;
+		for (size_t i = 0; i < MAX_VARINT_SIZE; i++)
+		{
+			if (_offset >= _data.size())
+			{
+				throw std::runtime_error("Varint out of range");
+			}
+
+			uint8_t byte = _data[_offset++];
+			value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+			if ((byte & 0x80) == 0)
+			{
+				return value;
+			}
+		}
+
+		throw std::runtime_error("Varint too long");
+	}
+
+	TRA_API bool decodeVarintRun(const uint8_t* _data, size_t _size, size_t& _consumed, uint64_t* _out, size_t _count);
+}
+
+#endif
@@ -3,11 +3,29 @@
 
 #include "iNetworkSystem.hpp"
 
+#include <vector>
+
+#include "TRA/core/tcpSocket.hpp"
+#include "TRA/engine/networkEngineConfig.hpp"
+
+#include "engineMetrics.hpp"
+
 namespace tra::engine
 {
 	struct AcceptConnectionSystem : INetworkSystem
 	{
+		AcceptConnectionSystem(const NetworkEngineConfig& _config, EngineMetrics& _metrics) : m_config(_config), m_metrics(_metrics) {}
+
 		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "AcceptConnectionSystem"; }
+
+	private:
+		bool registerConnection(NetworkEcs* _ecs, EntityId _listenEntityId, core::TcpSocket* _clientSocket);
+
+		const NetworkEngineConfig& m_config;
+		EngineMetrics& m_metrics;
+
+		std::vector<core::TcpSocket*> m_acceptedSockets;
 	};
 }
 
@@ -0,0 +1,33 @@
+#ifndef TRA_ENGINE_CONNECTION_TIMEOUT_COMPONENT_HPP
+#define TRA_ENGINE_CONNECTION_TIMEOUT_COMPONENT_HPP
+
+#include "TRA/engine/INetworkComponent.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "latencyTracker.hpp"
+#include "timerWheel.hpp"
+
+namespace tra::engine
+{
+	// Liveness deadlines are checked to within this.
+	constexpr uint64_t CONNECTION_TIMER_RESOLUTION_NS = 10'000'000;
+
+	// On the self entity: one timer per connection, keyed by entity id.
+	struct ConnectionTimersComponent : public INetworkComponent
+	{
+		TimerWheel m_wheel{ CONNECTION_TIMER_RESOLUTION_NS, getLatencyClockNs() };
+	};
+
+	// A connection's pending timer. It fires at the earliest deadline, which
+	// is only checked then, so traffic costs nothing until the timer is due.
+	struct ConnectionTimeoutComponent : public INetworkComponent
+	{
+		TimerWheel::TimerId m_timer = TimerWheel::INVALID_TIMER;
+		// When the connection was made or attached.
+		uint64_t m_armedNs = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TRA_ENGINE_CONNECTION_TIMEOUT_SYSTEM_HPP
+#define TRA_ENGINE_CONNECTION_TIMEOUT_SYSTEM_HPP
+
+#include "iNetworkSystem.hpp"
+
+#include <vector>
+
+#include "TRA/engine/networkEngineConfig.hpp"
+
+#include "engineMetrics.hpp"
+#include "timerWheel.hpp"
+
+namespace tra::engine
+{
+	struct SendTcpMessageComponent;
+
+	// Starts the heartbeat, idle and handshake deadlines of a connection just
+	// made or attached, on the wheel of the ConnectionTimersComponent of
+	// _selfEntityId. Does nothing while they are all off.
+	void armConnectionTimeouts(NetworkEcs* _ecs, const NetworkEngineConfig& _config, EngineMetrics& _metrics, EntityId _selfEntityId,
+		EntityId _entityId, SendTcpMessageComponent& _sendMessageComponent);
+
+	// Runs after the TCP receive, so a connection is only timed out once what
+	// arrived this tick has been accounted for.
+	struct ConnectionTimeoutSystem : public INetworkSystem
+	{
+		ConnectionTimeoutSystem(const NetworkEngineConfig& _config, EngineMetrics& _metrics) : m_config(_config), m_metrics(_metrics) {}
+
+		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "ConnectionTimeoutSystem"; }
+
+	private:
+		void expire(NetworkEcs* _ecs, TimerWheel& _wheel, EntityId _entityId, uint64_t _nowNs);
+
+		const NetworkEngineConfig& m_config;
+		EngineMetrics& m_metrics;
+
+		std::vector<uint64_t> m_expired;
+	};
+}
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef TRA_ENGINE_DESTROY_COMPONENT_TAG_HPP
 #define TRA_ENGINE_DESTROY_COMPONENT_TAG_HPP
 
-#include "TRA/engine/iNetworkComponent.hpp"
+#include "TRA/engine/INetworkComponent.hpp"
 
 namespace tra::engine
 {
@@ -8,6 +8,7 @@ namespace tra::engine
 	struct DisconnectSystem : INetworkSystem
 	{
 		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "DisconnectSystem"; }
 	};
 }
 
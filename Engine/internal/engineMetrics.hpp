@@ -0,0 +1,56 @@
+#ifndef TRA_ENGINE_ENGINE_METRICS_HPP
+#define TRA_ENGINE_ENGINE_METRICS_HPP
+
+#include "TRA/core/metrics.hpp"
+
+#include "latencyTracker.hpp"
+
+namespace tra::engine
+{
+	// Handles into one engine's registry, resolved once so systems update them
+	// without lookups.
+	struct EngineMetrics
+	{
+		explicit EngineMetrics(core::MetricsRegistry& _registry);
+
+		// The engine's metrics followed by the process-wide socket metrics.
+		void collect(core::MetricsSnapshot& _snapshot) const;
+
+		core::MetricsRegistry& m_registry;
+
+		core::Counter& m_tcpMessagesSent;
+		core::Counter& m_tcpMessagesReceived;
+		core::Counter& m_tcpBytesSent;
+		core::Counter& m_tcpBytesReceived;
+		core::Counter& m_tcpPartialSends;
+		core::Counter& m_tcpFramesDropped;
+		core::Counter& m_tcpProtocolErrors;
+		core::Counter& m_tcpDeserializeFailures;
+		core::Counter& m_udpDeserializeFailures;
+		core::Counter& m_acceptedConnections;
+		core::Counter& m_acceptFailures;
+		core::Counter& m_conditionerDatagramsDropped;
+		core::Counter& m_conditionerDatagramsDuplicated;
+		core::Counter& m_captureFrames;
+		core::Counter& m_captureDroppedFrames;
+		core::Counter& m_heartbeatsSent;
+		core::Counter& m_idleTimeouts;
+		core::Counter& m_handshakeTimeouts;
+
+		core::Gauge& m_tcpConnections;
+		core::Gauge& m_tcpSendQueueBytes;
+		core::Gauge& m_tcpReceiveBufferedBytes;
+		core::Gauge& m_tcpConditionerQueuedBytes;
+		core::Gauge& m_udpConditionerQueuedBytes;
+
+		core::Histogram& m_tcpFrameSize;
+		core::Histogram& m_tcpKernelSendDelay;
+		core::Histogram& m_tcpWireRoundTrip;
+		core::Histogram& m_tcpKernelReceiveDelay;
+		core::Histogram& m_udpKernelReceiveDelay;
+
+		LatencyTracker m_latency;
+	};
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef TRA_ENGINE_HEARTBEAT_MESSAGE_HPP
+#define TRA_ENGINE_HEARTBEAT_MESSAGE_HPP
+
+#include "TRA/engine/message.hpp"
+
+DECLARE_MESSAGE_BEGIN(TraHeartbeat)
+MESSAGE_COALESCE()
+MESSAGE_INTERNAL()
+DECLARE_MESSAGE_END()
+
+#endif
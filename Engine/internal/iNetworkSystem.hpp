@@ -12,6 +12,9 @@ namespace tra::engine
 	{
 		virtual ~INetworkSystem() = default;
 		virtual void update(NetworkEcs* _ecs) = 0;
+
+		// Stable name used by the tick profiler and in trace captures.
+		virtual const char* getName() const = 0;
 	};
 }
 
@@ -0,0 +1,100 @@
+#ifndef TRA_ENGINE_LATENCY_TRACKER_HPP
+#define TRA_ENGINE_LATENCY_TRACKER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TRA/core/hdrHistogram.hpp"
+
+namespace tra::engine
+{
+	struct Message;
+	struct MessageLatency;
+
+	inline uint64_t getLatencyClockNs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Estimates the offset between the peer's monotonic clock and ours from
+	// echoed timestamps. Like the NTP clock filter, it trusts the sample with
+	// the smallest round trip among the recent ones, since that one had the
+	// least queueing to make the path asymmetric.
+	class ClockSkewEstimator
+	{
+	public:
+		static constexpr size_t WINDOW_SIZE = 16;
+
+		// _offsetNs is peer clock minus local clock.
+		void addSample(uint64_t _roundTripNs, int64_t _offsetNs)
+		{
+			m_window[m_samples % WINDOW_SIZE] = { _roundTripNs, _offsetNs };
+			m_samples++;
+
+			size_t count = m_samples < WINDOW_SIZE ? m_samples : WINDOW_SIZE;
+			size_t best = 0;
+			for (size_t i = 1; i < count; i++)
+			{
+				if (m_window[i].m_roundTripNs < m_window[best].m_roundTripNs)
+				{
+					best = i;
+				}
+			}
+
+			m_roundTripNs = m_window[best].m_roundTripNs;
+			m_offsetNs = m_window[best].m_offsetNs;
+		}
+
+		bool isSynchronized() const { return m_samples > 0; }
+		int64_t getOffsetNs() const { return m_offsetNs; }
+		uint64_t getRoundTripNs() const { return m_roundTripNs; }
+
+		// Converts a peer timestamp to the local clock.
+		uint64_t toLocal(uint64_t _peerNs) const { return static_cast<uint64_t>(static_cast<int64_t>(_peerNs) - m_offsetNs); }
+
+	private:
+		struct Sample
+		{
+			uint64_t m_roundTripNs;
+			int64_t m_offsetNs;
+		};
+
+		Sample m_window[WINDOW_SIZE] = {};
+		size_t m_samples = 0;
+		uint64_t m_roundTripNs = 0;
+		int64_t m_offsetNs = 0;
+	};
+
+	// Per message type latency histograms of the TCP path, see MessageLatency.
+	class LatencyTracker
+	{
+	public:
+		enum class Stage
+		{
+			Queue,
+			Network,
+			Receive,
+			EndToEnd,
+			Count
+		};
+
+		void record(const Message& _message, Stage _stage, uint64_t _valueNs);
+		void reset();
+
+		std::vector<MessageLatency> getLatencies() const;
+
+	private:
+		struct TypeLatency
+		{
+			std::string m_name;
+			core::HdrHistogram m_stages[static_cast<size_t>(Stage::Count)];
+		};
+
+		std::unordered_map<uint32_t, TypeLatency> m_types;
+	};
+}
+
+#endif
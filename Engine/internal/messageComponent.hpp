@@ -2,27 +2,114 @@
 #define TRA_ENGINE_MESSAGE_COMPONENT_HPP
 
 #include <vector>
+#include <deque>
+#include <memory>
 #include <cstdint>
 #include <unordered_map>
 
-#include "TRA/engine/iNetworkComponent.hpp"
+#include "TRA/engine/INetworkComponent.hpp"
+
+#include "latencyTracker.hpp"
+#include "networkConditioner.hpp"
 
 namespace tra::engine
 {
 	using EntityId = uint32_t;
 	struct Message;
 
+	struct CoalesceKey
+	{
+		uint32_t m_typeId = 0;
+		uint64_t m_userKey = 0;
+
+		bool operator==(const CoalesceKey& _other) const
+		{
+			return m_typeId == _other.m_typeId && m_userKey == _other.m_userKey;
+		}
+	};
+
+	struct CoalesceKeyHash
+	{
+		size_t operator()(const CoalesceKey& _key) const
+		{
+			return std::hash<uint64_t>()(_key.m_userKey * 0x9E3779B97F4A7C15ull ^ _key.m_typeId);
+		}
+	};
+
+	struct QueuedTcpFrame
+	{
+		std::vector<uint8_t> m_data;
+		uint32_t m_typeId = 0;
+		bool m_droppable = false;
+		bool m_coalescable = false;
+		CoalesceKey m_coalesceKey;
+		bool m_timestamped = false;
+		uint64_t m_enqueuedNs = 0;
+		std::shared_ptr<Message> m_message;
+	};
+
+	struct PendingTcpMessage
+	{
+		std::shared_ptr<Message> m_message;
+		uint64_t m_enqueuedNs = 0;
+	};
+
 	struct SendTcpMessageComponent : public INetworkComponent
 	{
-		std::vector<std::shared_ptr<Message>> m_messagesToSend;
-		std::vector<std::vector<uint8_t>> m_serializedToSend;
+		std::vector<PendingTcpMessage> m_messagesToSend;
+		std::unordered_map<CoalesceKey, size_t, CoalesceKeyHash> m_pendingCoalesced;
+		std::deque<QueuedTcpFrame> m_serializedToSend;
+		std::unordered_map<CoalesceKey, QueuedTcpFrame*, CoalesceKeyHash> m_queuedCoalesced;
 		int m_lastMessageByteSent;
+		size_t m_queuedBytes = 0;
+		uint32_t m_ticksAboveHighWatermark = 0;
+		bool m_congested = false;
+		uint16_t m_nextSequence = 0;
+
+		uint64_t m_bytesSent = 0;
+		uint64_t m_messagesSent = 0;
+		uint64_t m_partialSends = 0;
+
+		// Kernel timestamps, smoothed like TCP's SRTT (1/8 gain).
+		uint64_t m_kernelSendDelayNs = 0;
+		uint64_t m_wireRoundTripNs = 0;
+		bool m_kernelSendDelayed = false;
+
+		// When messages were last queued, kept while heartbeats are on.
+		uint64_t m_lastQueuedNs = 0;
 	};
 
 	struct ReceiveTcpMessageComponent : public INetworkComponent
 	{
 		std::unordered_map<std::string, std::vector<std::shared_ptr<Message>>> m_receivedMessages;
 		std::vector<uint8_t> m_receivedBuffer;
+		size_t m_readOffset = 0;
+		size_t m_deficit = 0;
+		uint32_t m_deferredTicks = 0;
+		uint16_t m_nextSequence = 0;
+
+		uint64_t m_bytesReceived = 0;
+		uint64_t m_messagesReceived = 0;
+		uint64_t m_deserializeFailures = 0;
+
+		// Latency timestamps: when bytes were last read, the newest peer send
+		// time to echo back and when it was read, and the peer clock estimate.
+		uint64_t m_lastReadNs = 0;
+		uint64_t m_echoPeerNs = 0;
+		uint64_t m_echoReadNs = 0;
+		ClockSkewEstimator m_clockSkew;
+
+		uint64_t m_kernelReceiveDelayNs = 0;
+
+		// The simulated inbound link, once conditioning is on. A peer that
+		// closes is only disconnected when the link has drained.
+		std::unique_ptr<NetworkConditioner> m_conditioner;
+		bool m_peerClosed = false;
+
+		// Liveness: when bytes were last received, and whether a whole frame
+		// has been, which completes the handshake.
+		uint64_t m_lastReceiveNs = 0;
+		bool m_frameReceived = false;
 	};
 }
 
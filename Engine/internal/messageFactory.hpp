@@ -17,10 +17,11 @@ namespace tra::engine
 
         static void registerMessage(const uint32_t _id, Creator _creator);
         static std::vector<uint8_t> serialize(const Message& _message);
-        static std::unique_ptr<Message> deserialize(const std::vector<uint8_t>& _payload);
+        static std::unique_ptr<Message> deserialize(const uint32_t _typeId, const std::vector<uint8_t>& _payload);
+        static bool isRegistered(const uint32_t _typeId);
 
     private:
-        static std::unordered_map<uint32_t, Creator> m_registry;
+        static std::unordered_map<uint32_t, Creator>& getRegistry();
     };
 }
 
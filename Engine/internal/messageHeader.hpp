@@ -3,14 +3,52 @@
 
 #include <variant>
 #include <string>
+#include <cstdint>
+#include <cstddef>
 #include <unordered_map>
 
 namespace tra::engine
 {
+    enum MessageFlags : uint8_t
+    {
+        MessageFlagNone = 0,
+        MessageFlagCompressed = 1 << 0,
+        MessageFlagFragmented = 1 << 1,
+        MessageFlagInternal = 1 << 2,
+        MessageFlagTimestamped = 1 << 3
+    };
+
+    constexpr uint8_t MESSAGE_HEADER_VERSION = 1;
+    constexpr uint8_t MESSAGE_FLAGS_MASK = 0x0F;
+    constexpr uint8_t MESSAGE_CHANNEL_SHIFT = 4;
+    constexpr uint8_t MESSAGE_MAX_CHANNEL = 0x0F;
+
     struct MessageHeader
     {
-        uint32_t size;
+        uint8_t version = MESSAGE_HEADER_VERSION;
+        uint8_t flags = MessageFlagNone;
+        uint8_t channel = 0;
+        uint16_t sequence = 0;
+        uint32_t typeId = 0;
+        uint32_t size = 0;
     };
+
+    constexpr size_t MESSAGE_HEADER_SEQUENCE_OFFSET = 2;
+    constexpr size_t MESSAGE_HEADER_WIRE_SIZE = sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint32_t);
+
+    // Optional extension leading the payload of a MessageFlagTimestamped
+    // frame, counted in MessageHeader::size. Times are the sender's monotonic
+    // clock in nanoseconds; echo carries back the last sendNs received from
+    // the peer and how long it was held, for round trip and skew estimation.
+    struct MessageTimestamp
+    {
+        uint64_t sendNs = 0;
+        uint32_t queuedNs = 0;
+        uint64_t echoNs = 0;
+        uint32_t echoHoldNs = 0;
+    };
+
+    constexpr size_t MESSAGE_TIMESTAMP_WIRE_SIZE = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,18 +1,26 @@
 #ifndef TRA_ENGINE_MESSAGE_SERIALIZER_HPP
 #define TRA_ENGINE_MESSAGE_SERIALIZER_HPP
 
+#include "TRA/export.hpp"
+
 #include "messageFactory.hpp"
 
 namespace tra::engine
 {
-    class MessageSerializer
+    // Exported for the benchmarks in Bench/.
+    class TRA_API MessageSerializer
     {
     public:
         static std::vector<uint8_t> serializePayload(const Message& _message);
-        static std::unique_ptr<Message> deserializePayload(const std::vector<uint8_t>& _payload);
-        static std::vector<uint8_t> serializeForNetwork(const std::vector<uint8_t>& _payload, bool _internal = false);
-		static bool getPayloadFromNetworkBuffer(const std::vector<uint8_t>& _buffer, std::vector<uint8_t>& _outPayload, size_t& _outConsumedBytes);
+        static std::unique_ptr<Message> deserializePayload(uint32_t _typeId, const std::vector<uint8_t>& _payload);
+        static std::vector<uint8_t> serializeForNetwork(MessageHeader _header, const std::vector<uint8_t>& _payload, bool _timestamped = false);
+        static void writeSequence(std::vector<uint8_t>& _frame, uint16_t _sequence);
+        static void writeTimestamp(std::vector<uint8_t>& _frame, const MessageTimestamp& _timestamp);
+        static MessageTimestamp readTimestamp(const uint8_t* _data);
+        static bool readHeader(const std::vector<uint8_t>& _buffer, size_t _offset, MessageHeader& _outHeader);
+		static bool getPayloadFromNetworkBuffer(const std::vector<uint8_t>& _buffer, MessageHeader& _outHeader,
+			std::vector<uint8_t>& _outPayload, size_t& _outConsumedBytes);
     };    
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -3,16 +3,96 @@
 
 #include "iNetworkSystem.hpp"
 
+#include <vector>
+#include <memory>
+
+#include "TRA/core/tcpSocket.hpp"
+
+#include "TRA/engine/networkEngineConfig.hpp"
+
+#include "messageHeader.hpp"
+#include "engineMetrics.hpp"
+
 namespace tra::engine
 {
+	struct SendTcpMessageComponent;
+	struct QueuedTcpFrame;
+	struct ReceiveTcpMessageComponent;
+	struct Message;
+	class TrafficCaptureWriter;
+
 	struct SendTcpMessageSystem : public INetworkSystem
 	{
+		SendTcpMessageSystem(const NetworkEngineConfig& _config, EngineMetrics& _metrics) : m_config(_config), m_metrics(_metrics) {}
+
 		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "SendTcpMessageSystem"; }
+
+	private:
+		void stampFrame(QueuedTcpFrame& _frame, const ReceiveTcpMessageComponent* _receiveComponent);
+		void readKernelTimestamps(NetworkEcs* _ecs, EntityId _entityId, core::TcpSocket& _socket, SendTcpMessageComponent& _component);
+		void enqueueFrame(SendTcpMessageComponent& _component, QueuedTcpFrame&& _frame);
+		void rebuildCoalesceIndex(SendTcpMessageComponent& _component);
+		void updateCongestion(NetworkEcs* _ecs, EntityId _entityId, SendTcpMessageComponent& _component);
+		void dropOldest(SendTcpMessageComponent& _component);
+		void coalesce(SendTcpMessageComponent& _component);
+
+		const NetworkEngineConfig& m_config;
+		EngineMetrics& m_metrics;
+
+		std::vector<core::TransmitTimestamp> m_transmitTimestamps;
 	};
 
 	struct ReceiveTcpMessageSystem : public INetworkSystem
 	{
+		ReceiveTcpMessageSystem(const NetworkEngineConfig& _config, EngineMetrics& _metrics) : m_config(_config), m_metrics(_metrics) {}
+
 		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "ReceiveTcpMessageSystem"; }
+
+		// Decodes what is already in the receive buffers, without reading from
+		// sockets, under the same budgets as update. Used to replay captures.
+		void decodeBuffered(NetworkEcs* _ecs);
+		// Whether the budgets left complete frames for the next call.
+		bool hasPendingFrames() const { return !m_pendingConnections.empty(); }
+
+	private:
+		enum class FrameStatus
+		{
+			Incomplete,
+			Ready,
+			Invalid
+		};
+
+		struct PendingConnection
+		{
+			EntityId m_entityId;
+			std::shared_ptr<ReceiveTcpMessageComponent> m_component;
+		};
+
+		void readConnections(NetworkEcs* _ecs);
+		void decodeConnections(NetworkEcs* _ecs);
+		void compactBuffer(ReceiveTcpMessageComponent& _component);
+		void queueIfReady(NetworkEcs* _ecs, EntityId _entityId, const std::shared_ptr<ReceiveTcpMessageComponent>& _component);
+		void captureFrame(EntityId _entityId, const ReceiveTcpMessageComponent& _component, const MessageHeader& _header);
+
+		FrameStatus peekFrame(NetworkEcs* _ecs, EntityId _entityId, const ReceiveTcpMessageComponent& _component, MessageHeader& _outHeader) const;
+		void consumeFrame(EntityId _entityId, ReceiveTcpMessageComponent& _component, const MessageHeader& _header);
+		void updateClockSkew(ReceiveTcpMessageComponent& _component, const MessageTimestamp& _timestamp);
+		void recordLatency(const ReceiveTcpMessageComponent& _component, const MessageTimestamp& _timestamp, const Message& _message);
+
+		const NetworkEngineConfig& m_config;
+		EngineMetrics& m_metrics;
+
+		std::vector<PendingConnection> m_pendingConnections;
+		size_t m_nextStartIndex = 0;
+
+		std::vector<uint8_t> m_newReceivedBuffer;
+		std::vector<uint8_t> m_payload;
+
+		// Set for the tick while NetworkEngine::startCapture is recording.
+		TrafficCaptureWriter* m_capture = nullptr;
+		uint64_t m_captureNowNs = 0;
 	};
 }
 
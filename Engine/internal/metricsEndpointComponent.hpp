@@ -0,0 +1,51 @@
+#ifndef TRA_ENGINE_METRICS_ENDPOINT_COMPONENT_HPP
+#define TRA_ENGINE_METRICS_ENDPOINT_COMPONENT_HPP
+
+#include "TRA/engine/INetworkComponent.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "TRA/core/tcpSocket.hpp"
+
+namespace tra::engine
+{
+	// A scrape in progress. Its socket is non-blocking, so the request and
+	// the response move on a little each tick until done or past the deadline.
+	struct MetricsScrapeClient
+	{
+		core::TcpSocket* m_tcpSocket = nullptr;
+		std::vector<uint8_t> m_request;
+		std::string m_response;
+		size_t m_sentBytes = 0;
+		bool m_responding = false;
+		uint64_t m_deadlineNs = 0;
+	};
+
+	struct MetricsEndpointComponent : public INetworkComponent
+	{
+		core::TcpSocket* m_tcpSocket;
+		std::vector<MetricsScrapeClient> m_clients;
+
+		MetricsEndpointComponent() : m_tcpSocket(nullptr) {}
+
+		~MetricsEndpointComponent()
+		{
+			for (MetricsScrapeClient& client : m_clients)
+			{
+				client.m_tcpSocket->closeSocket();
+				delete client.m_tcpSocket;
+			}
+
+			if (m_tcpSocket)
+			{
+				m_tcpSocket->shutdownSocket();
+				m_tcpSocket->closeSocket();
+				delete m_tcpSocket;
+			}
+		}
+	};
+}
+
+#endif
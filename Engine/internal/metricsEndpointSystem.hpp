@@ -0,0 +1,36 @@
+#ifndef TRA_ENGINE_METRICS_ENDPOINT_SYSTEM_HPP
+#define TRA_ENGINE_METRICS_ENDPOINT_SYSTEM_HPP
+
+#include "iNetworkSystem.hpp"
+
+#include <vector>
+#include <cstdint>
+
+#include "engineMetrics.hpp"
+#include "metricsEndpointComponent.hpp"
+
+namespace tra::engine
+{
+	// Answers every connection on the metrics endpoint with one HTTP/1.0
+	// response holding the Prometheus text, then closes it. Scrape sockets
+	// never block the tick: each is read and written as far as it allows,
+	// and dropped if it has not finished by its deadline.
+	struct MetricsEndpointSystem : public INetworkSystem
+	{
+		explicit MetricsEndpointSystem(EngineMetrics& _metrics) : m_metrics(_metrics) {}
+
+		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "MetricsEndpointSystem"; }
+
+	private:
+		void acceptClients(MetricsEndpointComponent& _component, uint64_t _nowNs);
+		// Returns false once the client is done with, served or not.
+		bool serve(MetricsScrapeClient& _client);
+
+		EngineMetrics& m_metrics;
+
+		std::vector<uint8_t> m_received;
+	};
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef TRA_ENGINE_MIGRATED_CONNECTION_HPP
+#define TRA_ENGINE_MIGRATED_CONNECTION_HPP
+
+#include <memory>
+
+#include "TRA/core/tcpSocket.hpp"
+
+#include "messageComponent.hpp"
+
+namespace tra::engine
+{
+	// A TCP connection taken out of one NetworkEngine so another one can adopt
+	// it. The message components travel with the socket so partially read or
+	// queued frames survive the move. The UDP session does not: the adopting
+	// engine issues a fresh token and the peer handshakes again.
+	struct MigratedConnection
+	{
+		core::TcpSocket* m_tcpSocket = nullptr;
+		std::shared_ptr<SendTcpMessageComponent> m_sendMessageComponent;
+		std::shared_ptr<ReceiveTcpMessageComponent> m_receiveMessageComponent;
+
+		~MigratedConnection()
+		{
+			if (m_tcpSocket)
+			{
+				m_tcpSocket->shutdownSocket();
+				m_tcpSocket->closeSocket();
+				delete m_tcpSocket;
+			}
+		}
+	};
+}
+
+#endif
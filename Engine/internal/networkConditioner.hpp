@@ -0,0 +1,75 @@
+#ifndef TRA_ENGINE_NETWORK_CONDITIONER_HPP
+#define TRA_ENGINE_NETWORK_CONDITIONER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "TRA/engine/networkEngineConfig.hpp"
+
+namespace tra::engine
+{
+	// One inbound link of NetworkConditionerConfig: data pushed as it is read
+	// from a socket comes back out once it would have crossed the link. The
+	// link is a bottleneck of the configured bandwidth followed by the delay
+	// and jitter. A conditioner is used either as a TCP stream or for the
+	// datagrams of one UDP peer, not both.
+	class NetworkConditioner
+	{
+	public:
+		// _stream picks this link's random stream from the configured seed.
+		NetworkConditioner(const NetworkConditionerConfig& _config, uint64_t _stream);
+
+		// Bytes keep their order and are never lost. The caller reads at most
+		// getFreeBytes() from the socket, so the link never overflows.
+		void pushStream(const std::vector<uint8_t>& _data, uint64_t _nowNs);
+		// Appends up to _maxBytes that are due by _nowNs.
+		void popStream(std::vector<uint8_t>& _outData, size_t _maxBytes, uint64_t _nowNs);
+
+		// Returns how many copies were queued: 0 if lost or the link is full,
+		// 2 if duplicated.
+		uint32_t pushDatagram(const uint8_t* _data, size_t _size, uint64_t _nowNs);
+		// The next datagram due by _nowNs, in release order.
+		bool popDatagram(std::vector<uint8_t>& _outData, uint64_t _nowNs);
+
+		size_t getQueuedBytes() const { return m_queuedBytes; }
+		size_t getFreeBytes() const { return m_queuedBytes < m_config.m_maxQueuedBytes ? m_config.m_maxQueuedBytes - m_queuedBytes : 0; }
+		bool isEmpty() const { return m_queuedBytes == 0; }
+		uint64_t getLastPushNs() const { return m_lastPushNs; }
+
+	private:
+		struct Packet
+		{
+			uint64_t m_releaseNs = 0;
+			uint64_t m_order = 0;
+			std::vector<uint8_t> m_data;
+			size_t m_offset = 0;
+		};
+
+		// SplitMix64, so a seed gives the same stream on every platform.
+		uint64_t nextRandom();
+		double nextUnit();
+
+		// When _size bytes offered at _nowNs have crossed the link, with
+		// _random choosing the jitter.
+		uint64_t transmit(size_t _size, uint64_t _nowNs, uint64_t _random);
+		void queueDatagram(const uint8_t* _data, size_t _size, uint64_t _releaseNs);
+
+		// A copy, since a migrated connection takes its link to another engine.
+		NetworkConditionerConfig m_config;
+		uint64_t m_randomState;
+
+		uint64_t m_linkFreeNs;
+		uint64_t m_lastReleaseNs;
+		uint64_t m_lastPushNs;
+		uint64_t m_nextOrder;
+		size_t m_queuedBytes;
+
+		std::deque<Packet> m_stream;
+		// Min-heap on release time, ties in push order.
+		std::vector<Packet> m_datagrams;
+	};
+}
+
+#endif
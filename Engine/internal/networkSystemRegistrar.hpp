@@ -4,9 +4,12 @@
 namespace tra::engine
 {
 	class NetworkEcs;
+	struct NetworkEngineConfig;
+	struct EngineMetrics;
+
 	namespace NetworkSystemRegistrar
 	{
-		void registerNetworkSystems(NetworkEcs* _networkEcs);
+		void registerNetworkSystems(NetworkEcs* _networkEcs, const NetworkEngineConfig& _config, EngineMetrics& _metrics);
 	}
 }
 
@@ -1,9 +1,12 @@
 #ifndef TRA_ENGINE_SOCKET_COMPONENT_HPP
 #define TRA_ENGINE_SOCKET_COMPONENT_HPP
 
-#include "TRA/engine/iNetworkComponent.hpp"
+#include "TRA/engine/INetworkComponent.hpp"
 
 #include "TRA/core/tcpSocket.hpp"
+#include "TRA/core/udpSocket.hpp"
+
+#include "tcpAcceptorPool.hpp"
 
 namespace tra::engine
 {
@@ -24,6 +27,22 @@ namespace tra::engine
 		}
 	};
 
+	struct TcpAcceptorPoolComponent : public INetworkComponent
+	{
+		TcpAcceptorPool* m_acceptorPool;
+
+		TcpAcceptorPoolComponent() : m_acceptorPool(nullptr) {}
+
+		~TcpAcceptorPoolComponent()
+		{
+			if (m_acceptorPool)
+			{
+				m_acceptorPool->stop();
+				delete m_acceptorPool;
+			}
+		}
+	};
+
 	struct TcpConnectSocketComponent : public INetworkComponent
 	{
 		core::TcpSocket* m_tcpSocket;
@@ -40,6 +59,22 @@ namespace tra::engine
 			}
 		}
 	};
+
+	struct UdpSocketComponent : public INetworkComponent
+	{
+		core::UdpSocket* m_udpSocket;
+
+		UdpSocketComponent() : m_udpSocket(nullptr) {}
+
+		~UdpSocketComponent()
+		{
+			if (m_udpSocket)
+			{
+				m_udpSocket->closeSocket();
+				delete m_udpSocket;
+			}
+		}
+	};
 }
 
 #endif
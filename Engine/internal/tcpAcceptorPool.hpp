@@ -0,0 +1,47 @@
+#ifndef TRA_ENGINE_TCP_ACCEPTOR_POOL_HPP
+#define TRA_ENGINE_TCP_ACCEPTOR_POOL_HPP
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#include "TRA/errorCode.hpp"
+#include "TRA/core/tcpSocket.hpp"
+
+namespace tra::engine
+{
+	// N listen sockets bound to the same port with SO_REUSEPORT, each drained by
+	// its own thread. The kernel spreads incoming connections across them, and
+	// accepted sockets are handed to the game thread through a locked queue.
+	class TcpAcceptorPool
+	{
+	public:
+		TcpAcceptorPool() = default;
+		~TcpAcceptorPool();
+
+		TcpAcceptorPool(const TcpAcceptorPool&) = delete;
+		TcpAcceptorPool& operator=(const TcpAcceptorPool&) = delete;
+
+		ErrorCode start(uint16_t _port, uint32_t _threadCount);
+		void stop();
+
+		size_t drain(std::vector<core::TcpSocket*>& _outSockets, size_t _maxSockets);
+
+	private:
+		static constexpr uint32_t WAIT_TIMEOUT_MS = 100;
+
+		void run(core::TcpSocket* _listenSocket);
+
+		std::vector<core::TcpSocket*> m_listenSockets;
+		std::vector<std::thread> m_threads;
+		std::atomic<bool> m_running{ false };
+
+		std::mutex m_mutex;
+		std::deque<core::TcpSocket*> m_acceptedSockets;
+	};
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef TRA_ENGINE_TIMER_WHEEL_HPP
+#define TRA_ENGINE_TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace tra::engine
+{
+	// Hierarchical timing wheel: LEVELS wheels of SLOTS slots, each slot of a
+	// level spanning a whole turn of the level below. Timers are intrusive
+	// list nodes, so scheduling and cancelling are O(1), and advancing costs
+	// the ticks passed plus the timers that expire or cascade down a level,
+	// however many are scheduled.
+	class TimerWheel
+	{
+	public:
+		using TimerId = uint32_t;
+		static constexpr TimerId INVALID_TIMER = 0xFFFFFFFFu;
+
+		static constexpr uint32_t LEVEL_BITS = 6;
+		static constexpr uint32_t SLOTS = 1u << LEVEL_BITS;
+		static constexpr uint32_t LEVELS = 4;
+
+		TimerWheel(uint64_t _resolutionNs, uint64_t _nowNs);
+
+		// Timers beyond the wheel's span, SLOTS^LEVELS resolutions, fire at
+		// its edge instead.
+		TimerId schedule(uint64_t _deadlineNs, uint64_t _payload);
+		void cancel(TimerId _timer);
+
+		// Appends the payloads of the timers due by _nowNs and releases them.
+		void advance(uint64_t _nowNs, std::vector<uint64_t>& _outExpired);
+
+		size_t size() const { return m_size; }
+
+	private:
+		struct Node
+		{
+			uint64_t m_deadlineTick = 0;
+			uint64_t m_payload = 0;
+			TimerId m_prev = INVALID_TIMER;
+			TimerId m_next = INVALID_TIMER;
+			uint32_t m_slot = 0;
+			bool m_active = false;
+		};
+
+		uint64_t toTick(uint64_t _ns) const;
+		void link(TimerId _timer);
+		void unlink(TimerId _timer);
+		// Re-links the timers of one slot, which moves them down a level.
+		uint32_t cascade(uint32_t _level);
+
+		uint64_t m_resolutionNs;
+		uint64_t m_startNs;
+		// The next tick advance will expire.
+		uint64_t m_nextTick;
+
+		std::array<TimerId, SLOTS * LEVELS> m_slots;
+		std::vector<Node> m_nodes;
+		TimerId m_freeList;
+		size_t m_size;
+	};
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef TRA_ENGINE_TRAFFIC_CAPTURE_HPP
+#define TRA_ENGINE_TRAFFIC_CAPTURE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TRA/errorCode.hpp"
+
+namespace tra::engine
+{
+	using EntityId = uint32_t;
+
+	// Capture file layout, little endian:
+	//   header: "TRACAPT" and a NUL, uint32 version, uint32 reserved,
+	//           uint64 wall clock at the start in ns since the Unix epoch.
+	//   record: varint ns since the start, varint entity id, varint frame
+	//           size, then the frame as it was on the wire, header included.
+	// Every frame has a header, so a record of size 0 marks the end. That is
+	// also what the zeroed tail of a file left by a crash reads as.
+	constexpr char CAPTURE_MAGIC[8] = { 'T', 'R', 'A', 'C', 'A', 'P', 'T', '\0' };
+	constexpr uint32_t CAPTURE_VERSION = 1;
+	constexpr size_t CAPTURE_FILE_HEADER_SIZE = 24;
+
+	struct CaptureRecord
+	{
+		uint64_t m_timestampNs = 0;
+		EntityId m_entityId = 0;
+		const uint8_t* m_frame = nullptr;
+		size_t m_size = 0;
+	};
+
+	// Appends records to a capture file through a memory mapping. The tick
+	// thread encodes into a chunk that flush() hands over once per tick; a
+	// background thread copies the chunks into the mapping and grows the
+	// file as needed, so the tick never waits on the disk.
+	class TrafficCaptureWriter
+	{
+	public:
+		TrafficCaptureWriter();
+		~TrafficCaptureWriter();
+
+		TrafficCaptureWriter(const TrafficCaptureWriter&) = delete;
+		TrafficCaptureWriter& operator=(const TrafficCaptureWriter&) = delete;
+
+		ErrorCode open(const std::string& _path, size_t _maxQueuedBytes);
+		// Writes out what is queued and truncates the file to its records.
+		ErrorCode close();
+
+		// Tick thread only. Returns false if the frame was dropped, because the
+		// writer is more than the configured bytes behind or has failed.
+		bool record(EntityId _entityId, const uint8_t* _frame, size_t _size, uint64_t _nowNs);
+		void flush();
+
+	private:
+		void run();
+		bool reserve(size_t _length);
+		bool mapFile(size_t _capacity);
+		void unmapFile();
+
+		uint64_t m_startNs;
+		size_t m_maxQueuedBytes;
+		std::vector<uint8_t> m_chunk;
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::deque<std::vector<uint8_t>> m_pending;
+		std::vector<std::vector<uint8_t>> m_spareChunks;
+		bool m_stopping;
+		std::atomic<size_t> m_queuedBytes;
+		std::atomic<bool> m_failed;
+
+		// Owned by the writer thread once it runs.
+#ifdef _WIN32
+		void* m_file;
+		void* m_mapping;
+#else
+		int m_file;
+#endif
+		uint8_t* m_map;
+		size_t m_capacity;
+		size_t m_length;
+	};
+
+	// Reads a whole capture into memory, so replaying it does not measure
+	// the disk.
+	class TrafficCaptureReader
+	{
+	public:
+		TrafficCaptureReader();
+
+		ErrorCode open(const std::string& _path);
+
+		// False at the end of the capture or at a truncated record.
+		bool next(CaptureRecord& _outRecord);
+		void rewind();
+
+		uint64_t getStartUnixNs() const { return m_startUnixNs; }
+
+	private:
+		std::vector<uint8_t> m_data;
+		size_t m_offset;
+		uint64_t m_startUnixNs;
+	};
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef TRA_ENGINE_TRAFFIC_CAPTURE_COMPONENT_HPP
+#define TRA_ENGINE_TRAFFIC_CAPTURE_COMPONENT_HPP
+
+#include "TRA/engine/INetworkComponent.hpp"
+
+#include <memory>
+
+#include "trafficCapture.hpp"
+
+namespace tra::engine
+{
+	// On the self entity while NetworkEngine::startCapture is recording. The
+	// writer is closed, and the file completed, when the component goes.
+	struct TrafficCaptureComponent : public INetworkComponent
+	{
+		std::unique_ptr<TrafficCaptureWriter> m_writer;
+	};
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef TRA_ENGINE_UDP_COMPONENT_HPP
+#define TRA_ENGINE_UDP_COMPONENT_HPP
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <unordered_map>
+
+#include "TRA/core/socketAddress.hpp"
+#include "TRA/engine/INetworkComponent.hpp"
+#include "TRA/engine/udpChannel.hpp"
+
+#include "udpPacket.hpp"
+#include "udpPeerTable.hpp"
+
+namespace tra::engine
+{
+	using EntityId = uint32_t;
+	using UdpClock = std::chrono::steady_clock;
+	struct Message;
+
+	struct UdpPeerTableComponent : public INetworkComponent
+	{
+		UdpPeerTable m_peers;
+		std::unordered_map<uint64_t, EntityId> m_tokens;
+		uint64_t m_cookieKey[2] = {};
+		std::mt19937_64 m_tokenGenerator{ std::random_device{}() };
+	};
+
+	struct UdpSentPacket
+	{
+		uint16_t m_sequence = 0;
+		bool m_valid = false;
+		UdpClock::time_point m_sentAt;
+		std::vector<uint16_t> m_reliableSequences;
+	};
+
+	struct UdpReliableMessage
+	{
+		uint16_t m_sequence = 0;
+		uint32_t m_typeId = 0;
+		std::vector<uint8_t> m_payload;
+		UdpClock::time_point m_lastSent;
+		bool m_sent = false;
+		bool m_acked = false;
+	};
+
+	// Serialized when queued, so a message that cannot fit in a datagram is
+	// refused to the caller rather than stalling the channel.
+	struct UdpQueuedMessage
+	{
+		UdpChannel m_channel = UdpChannel::Unreliable;
+		uint32_t m_typeId = 0;
+		std::vector<uint8_t> m_payload;
+	};
+
+	struct UdpReceivedEntry
+	{
+		uint32_t m_typeId = 0;
+		std::vector<uint8_t> m_payload;
+	};
+
+	struct UdpConnectionComponent : public INetworkComponent
+	{
+		uint64_t m_token = 0;
+		core::SocketAddress m_peerAddress;
+		bool m_bound = false;
+		bool m_initiator = false;
+		UdpClock::time_point m_lastHandshakeSent;
+
+		std::vector<UdpQueuedMessage> m_messagesToSend;
+		std::unordered_map<std::string, std::vector<std::shared_ptr<Message>>> m_receivedMessages;
+
+		uint16_t m_nextPacketSequence = 0;
+		uint16_t m_remoteSequence = 0;
+		uint32_t m_remoteAckBits = 0;
+		bool m_hasRemoteSequence = false;
+		bool m_ackPending = false;
+		std::array<UdpSentPacket, UDP_SENT_PACKET_HISTORY> m_sentPackets;
+
+		double m_smoothedRtt = 0.0;
+		double m_rttVariance = 0.0;
+		double m_retransmitTimeout = 0.0;
+		bool m_hasRttSample = false;
+
+		uint16_t m_nextSequencedSequence = 0;
+		uint16_t m_lastSequencedReceived = 0;
+		bool m_hasSequencedReceived = false;
+
+		uint16_t m_nextReliableSequence = 0;
+		std::deque<UdpReliableMessage> m_reliableToSend;
+
+		uint16_t m_nextExpectedReliable = 0;
+		std::unordered_map<uint16_t, UdpReceivedEntry> m_reorderBuffer;
+	};
+}
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TRA_ENGINE_UDP_HANDSHAKE_MESSAGE_HPP
+#define TRA_ENGINE_UDP_HANDSHAKE_MESSAGE_HPP
+
+#include "TRA/engine/message.hpp"
+
+DECLARE_MESSAGE_BEGIN(TraUdpHandshake)
+FIELD(uint64_t, token)
+FIELD(uint16_t, port)
+MESSAGE_INTERNAL()
+DECLARE_MESSAGE_END()
+
+#endif
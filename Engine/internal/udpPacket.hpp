@@ -0,0 +1,38 @@
+#ifndef TRA_ENGINE_UDP_PACKET_HPP
+#define TRA_ENGINE_UDP_PACKET_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace tra::engine
+{
+	enum class UdpPacketType : uint8_t
+	{
+		Handshake = 1,
+		HandshakeAck = 2,
+		Data = 3,
+		HandshakeChallenge = 4,
+		HandshakeResponse = 5
+	};
+
+	constexpr uint8_t UDP_PACKET_VERSION = 1;
+
+	// version, type, token
+	constexpr size_t UDP_HANDSHAKE_PACKET_SIZE = sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint64_t);
+	// version, type, token, cookie
+	constexpr size_t UDP_CHALLENGE_PACKET_SIZE = UDP_HANDSHAKE_PACKET_SIZE + sizeof(uint64_t);
+	// version, type, sequence, ack, ack bits
+	constexpr size_t UDP_DATA_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint32_t);
+	// channel, channel sequence, type id, payload size
+	constexpr size_t UDP_ENTRY_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint16_t);
+
+	constexpr size_t UDP_SENT_PACKET_HISTORY = 1024;
+	constexpr uint16_t UDP_REORDER_WINDOW = 1024;
+
+	inline bool sequenceGreaterThan(uint16_t _a, uint16_t _b)
+	{
+		return ((_a > _b) && (_a - _b <= 32768)) || ((_a < _b) && (_b - _a > 32768));
+	}
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TRA_ENGINE_UDP_PEER_TABLE_HPP
+#define TRA_ENGINE_UDP_PEER_TABLE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "TRA/core/socketAddress.hpp"
+
+namespace tra::engine
+{
+	using EntityId = uint32_t;
+
+	// Open-addressing map from a datagram's source address to its connection
+	// entity. Linear probing with backward-shift deletion, so there are no
+	// tombstones. Datagrams in a batch tend to come from the same peer, so the
+	// last resolved slot is checked before hashing.
+	class UdpPeerTable
+	{
+	public:
+		UdpPeerTable();
+
+		bool find(const core::SocketAddress& _address, EntityId& _outEntityId);
+		void insert(const core::SocketAddress& _address, EntityId _entityId);
+		bool erase(const core::SocketAddress& _address);
+		void clear();
+		size_t size() const;
+
+	private:
+		static constexpr size_t INITIAL_CAPACITY = 64;
+		static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+		struct Entry
+		{
+			core::SocketAddress m_address;
+			EntityId m_entityId = 0;
+		};
+
+		static uint64_t hashOf(const core::SocketAddress& _address);
+		size_t findSlot(const core::SocketAddress& _address, uint64_t _hash) const;
+		void grow();
+
+		// 0 marks an empty slot; stored hashes always have the top bit set.
+		std::vector<uint64_t> m_hashes;
+		std::vector<Entry> m_entries;
+		size_t m_mask;
+		size_t m_size;
+		size_t m_lastHit;
+	};
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef TRA_ENGINE_UDP_SYSTEM_HPP
+#define TRA_ENGINE_UDP_SYSTEM_HPP
+
+#include "iNetworkSystem.hpp"
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "TRA/core/udpSocket.hpp"
+#include "TRA/engine/networkEngineConfig.hpp"
+
+#include "udpComponent.hpp"
+#include "engineMetrics.hpp"
+#include "networkConditioner.hpp"
+
+namespace tra::engine
+{
+	struct SendTcpMessageComponent;
+
+	// Hands a new TCP connection its UDP token, sent over TCP with the local UDP
+	// port, when _listenEntityId owns a UDP socket.
+	void issueUdpHandshake(NetworkEcs* _ecs, EntityId _listenEntityId, EntityId _entityId, SendTcpMessageComponent& _sendMessageComponent);
+	void releaseUdpConnection(NetworkEcs* _ecs, EntityId _entityId);
+
+	struct UdpHandshakeSystem : public INetworkSystem
+	{
+		explicit UdpHandshakeSystem(const NetworkEngineConfig& _config) : m_config(_config) {}
+
+		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "UdpHandshakeSystem"; }
+
+	private:
+		const NetworkEngineConfig& m_config;
+	};
+
+	struct ReceiveUdpMessageSystem : public INetworkSystem
+	{
+		ReceiveUdpMessageSystem(const NetworkEngineConfig& _config, EngineMetrics& _metrics) : m_config(_config), m_metrics(_metrics) {}
+
+		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "ReceiveUdpMessageSystem"; }
+
+	private:
+		void handleDatagram(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable, const core::SocketAddress& _address,
+			const uint8_t* _data, size_t _size);
+		void handleHandshake(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable, const core::SocketAddress& _address, uint64_t _token);
+		void handleChallenge(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable, const core::SocketAddress& _address,
+			uint64_t _token, uint64_t _cookie);
+		void handleResponse(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable, const core::SocketAddress& _address,
+			uint64_t _token, uint64_t _cookie);
+		void handleHandshakeAck(NetworkEcs* _ecs, UdpPeerTableComponent& _peerTable, const core::SocketAddress& _address, uint64_t _token);
+		void handleData(UdpConnectionComponent& _connection, const uint8_t* _data, size_t _size);
+
+		void processAck(UdpConnectionComponent& _connection, uint16_t _ack, uint32_t _ackBits);
+		void deliver(UdpConnectionComponent& _connection, uint32_t _typeId, const uint8_t* _payload, size_t _size);
+
+		void conditionDatagram(const core::SocketAddress& _address, const uint8_t* _data, size_t _size, uint64_t _nowNs);
+		void releaseConditioned(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable, uint64_t _nowNs);
+
+		const NetworkEngineConfig& m_config;
+		EngineMetrics& m_metrics;
+
+		std::unique_ptr<core::UdpDatagramBatch> m_batch;
+
+		// One simulated link per source address, numbered in the order the
+		// peers were first seen so a seed replays the same way.
+		std::unordered_map<core::SocketAddress, std::unique_ptr<NetworkConditioner>> m_conditionedPeers;
+		uint64_t m_conditionedPeerCount = 0;
+		std::vector<uint8_t> m_conditionedDatagram;
+	};
+
+	struct SendUdpMessageSystem : public INetworkSystem
+	{
+		explicit SendUdpMessageSystem(const NetworkEngineConfig& _config) : m_config(_config) {}
+
+		void update(NetworkEcs* _ecs) override;
+		const char* getName() const override { return "SendUdpMessageSystem"; }
+
+	private:
+		void beginPacket();
+		bool appendEntry(core::UdpSocket& _socket, UdpConnectionComponent& _connection, UdpChannel _channel, uint16_t _sequence,
+			uint32_t _typeId, const std::vector<uint8_t>& _payload);
+		void flushPacket(core::UdpSocket& _socket, UdpConnectionComponent& _connection);
+		void queueDatagram(core::UdpSocket& _socket, const UdpConnectionComponent& _connection);
+		void flushBatch(core::UdpSocket& _socket);
+
+		const NetworkEngineConfig& m_config;
+
+		std::unique_ptr<core::UdpDatagramBatch> m_batch;
+		size_t m_batchCount = 0;
+		const UdpConnectionComponent* m_batchConnection = nullptr;
+
+		std::vector<uint8_t> m_packet;
+		std::vector<uint16_t> m_packetReliableSequences;
+		size_t m_packetEntries = 0;
+	};
+}
+
+#endif
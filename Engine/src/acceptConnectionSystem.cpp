@@ -1,7 +1,5 @@
 #include "acceptConnectionSystem.hpp"
 
-#define MAX_ACCEPTED_CONNECTIONS_PAR_TICK 32
-
 #include "TRA/debugUtils.hpp"
 
 #include "TRA/core/tcpSocket.hpp"
@@ -15,12 +13,14 @@
 
 #include "socketComponent.hpp"
 #include "messageComponent.hpp"
+#include "udpSystem.hpp"
+#include "connectionTimeoutSystem.hpp"
 
 namespace tra::engine
 {
 	void AcceptConnectionSystem::update(NetworkEcs* _ecs)
 	{
-		uint8_t acceptedConnections = 0;
+		uint32_t acceptedConnections = 0;
 
 		EntityId querryEntityid = 0;
 		std::shared_ptr<NewConnectionComponentTag> newConnectionComponent = nullptr;
@@ -39,14 +39,7 @@ namespace tra::engine
 		}
 
 		std::shared_ptr<TcpListenSocketComponent> tcpListenSocketComponent = nullptr;
-
 		core::TcpSocket* clientSocket = nullptr;
-		EntityId newEntityId = 0;
-		ErrorCode errorCode = ErrorCode::Success;
-		std::shared_ptr<NetworkRootComponentTag> networkRootComponentTag = nullptr;
-		std::shared_ptr<TcpConnectSocketComponent> tcpSocketComponent = nullptr;
-		std::shared_ptr<SendTcpMessageComponent> sendMessageComponent = nullptr;
-		std::shared_ptr<ReceiveTcpMessageComponent> receiveMessageComponent = nullptr;
 
 		for (auto queryResult : _ecs->query<TcpListenSocketComponent>())
 		{
@@ -54,84 +47,112 @@ namespace tra::engine
 			tcpListenSocketComponent = std::get<1>(queryResult);
 
 			acceptedConnections = 0;
-			while (acceptedConnections < MAX_ACCEPTED_CONNECTIONS_PAR_TICK)
+			while (acceptedConnections < m_config.m_maxAcceptedConnectionsPerTick)
 			{
 				clientSocket = nullptr;
-				std::pair<ErrorCode, int> intPairResult = tcpListenSocketComponent->m_tcpSocket->acceptSocket(&clientSocket);
+				std::pair<ErrorCode, int> intPairResult = tcpListenSocketComponent->m_tcpSocket->acceptSocket(&clientSocket, true);
 				if (intPairResult.first == ErrorCode::SocketWouldBlock)
 				{
 					break;
 				}
 				else if (intPairResult.first != ErrorCode::Success)
 				{
+					m_metrics.m_acceptFailures.add();
 					TRA_ERROR_LOG("AcceptConnectionSystem::update: Failed to accept new connection on entity %I32u, ErrorCode: %d, Last socket error: %d",
 						querryEntityid, static_cast<int>(intPairResult.first), static_cast<int>(intPairResult.second));
 					break;
 				}
 
-				auto setblockingResult = clientSocket->setBlocking(false);
-				if (setblockingResult.first != ErrorCode::Success)
-				{
-					TRA_ERROR_LOG("AcceptConnectionSystem::update: Failed to set non-blocking mode on accepted socket. ErrorCode: %d, Last socket error: %d",
-						static_cast<int>(setblockingResult.first), static_cast<int>(setblockingResult.second));
-					clientSocket->closeSocket();
-					delete clientSocket;
-					continue;
-				}
+				registerConnection(_ecs, querryEntityid, clientSocket);
+				acceptedConnections++;
+			}
+		}
 
-				newEntityId = _ecs->createEntity();
-
-				TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<NetworkRootComponentTag>(), {
-					clientSocket->closeSocket();
-					delete clientSocket;
-					_ecs->destroyEntity(newEntityId);
-					continue;
-					});
-
-				tcpSocketComponent = std::make_shared<TcpConnectSocketComponent>();
-				tcpSocketComponent->m_tcpSocket = clientSocket;
-				TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, tcpSocketComponent, {
-					clientSocket->closeSocket();
-					delete clientSocket;
-					_ecs->destroyEntity(newEntityId);
-					continue;
-					});
-
-				TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<ReceiveTcpMessageComponent>(), {
-					clientSocket->closeSocket();
-					delete clientSocket;
-					_ecs->destroyEntity(newEntityId);
-					continue;
-					});
-
-				sendMessageComponent = std::make_shared<SendTcpMessageComponent>();
-				sendMessageComponent->m_lastMessageByteSent = 0;
-				TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, sendMessageComponent, {
-					clientSocket->closeSocket();
-					delete clientSocket;
-					_ecs->destroyEntity(newEntityId);
-					continue;
-					});
-
-				TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<NewConnectionComponentTag>(), {
-					clientSocket->closeSocket();
-					delete clientSocket;
-					_ecs->destroyEntity(newEntityId);
-					continue;
-					});
-
-				TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<ConnectedComponentTag>(), {
-					clientSocket->closeSocket();
-					delete clientSocket;
-					_ecs->destroyEntity(newEntityId);
-					continue;
-					});
-
-				tcpSocketComponent.reset();
+		std::shared_ptr<TcpAcceptorPoolComponent> tcpAcceptorPoolComponent = nullptr;
 
-				acceptedConnections++;
-				TRA_INFO_LOG("NetworkEngine: Accepted new TCP connection. Entity ID: %I32u", newEntityId);
+		for (auto queryResult : _ecs->query<TcpAcceptorPoolComponent>())
+		{
+			querryEntityid = std::get<0>(queryResult);
+			tcpAcceptorPoolComponent = std::get<1>(queryResult);
+
+			m_acceptedSockets.clear();
+			tcpAcceptorPoolComponent->m_acceptorPool->drain(m_acceptedSockets, m_config.m_maxAcceptedConnectionsPerTick);
+
+			for (core::TcpSocket* acceptedSocket : m_acceptedSockets)
+			{
+				registerConnection(_ecs, querryEntityid, acceptedSocket);
 			}
 		}
 	}
-}
\ No newline at end of file
+
+	bool AcceptConnectionSystem::registerConnection(NetworkEcs* _ecs, EntityId _listenEntityId, core::TcpSocket* _clientSocket)
+	{
+		core::TcpSocket* clientSocket = _clientSocket;
+		EntityId newEntityId = _ecs->createEntity();
+		std::shared_ptr<TcpConnectSocketComponent> tcpSocketComponent = nullptr;
+		std::shared_ptr<SendTcpMessageComponent> sendMessageComponent = nullptr;
+
+		if (m_config.m_kernelTimestamps)
+		{
+			std::pair<ErrorCode, int> timestampResult = clientSocket->setKernelTimestamping(true);
+			if (timestampResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("AcceptConnectionSystem: TCP kernel timestamps unavailable. Last socket error: %d", timestampResult.second);
+			}
+		}
+
+		TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<NetworkRootComponentTag>(), {
+			clientSocket->closeSocket();
+			delete clientSocket;
+			_ecs->destroyEntity(newEntityId);
+			return false;
+			});
+
+		tcpSocketComponent = std::make_shared<TcpConnectSocketComponent>();
+		tcpSocketComponent->m_tcpSocket = clientSocket;
+		TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, tcpSocketComponent, {
+			clientSocket->closeSocket();
+			delete clientSocket;
+			_ecs->destroyEntity(newEntityId);
+			return false;
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<ReceiveTcpMessageComponent>(), {
+			clientSocket->closeSocket();
+			delete clientSocket;
+			_ecs->destroyEntity(newEntityId);
+			return false;
+			});
+
+		sendMessageComponent = std::make_shared<SendTcpMessageComponent>();
+		sendMessageComponent->m_lastMessageByteSent = 0;
+		TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, sendMessageComponent, {
+			clientSocket->closeSocket();
+			delete clientSocket;
+			_ecs->destroyEntity(newEntityId);
+			return false;
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<NewConnectionComponentTag>(), {
+			clientSocket->closeSocket();
+			delete clientSocket;
+			_ecs->destroyEntity(newEntityId);
+			return false;
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(_ecs, newEntityId, std::make_shared<ConnectedComponentTag>(), {
+			clientSocket->closeSocket();
+			delete clientSocket;
+			_ecs->destroyEntity(newEntityId);
+			return false;
+			});
+
+		issueUdpHandshake(_ecs, _listenEntityId, newEntityId, *sendMessageComponent);
+		armConnectionTimeouts(_ecs, m_config, m_metrics, _listenEntityId, newEntityId, *sendMessageComponent);
+
+		m_metrics.m_acceptedConnections.add();
+
+		TRA_INFO_LOG("NetworkEngine: Accepted new TCP connection. Entity ID: %I32u", newEntityId);
+		return true;
+	}
+}
@@ -0,0 +1,104 @@
+#include "TRA/engine/bitStream.hpp"
+
+#include <stdexcept>
+
+namespace tra::engine
+{
+	BitWriter::BitWriter(std::vector<uint8_t>& _data) : m_data(_data)
+	{
+		m_scratch = 0;
+		m_scratchBits = 0;
+	}
+
+	void BitWriter::writeBits(uint64_t _value, uint32_t _bitCount)
+	{
+		if (_bitCount > 32)
+		{
+			writeBits(_value & 0xFFFFFFFFull, 32);
+			writeBits(_value >> 32, _bitCount - 32);
+			return;
+		}
+
+		if (_bitCount < 32)
+		{
+			_value &= (1ull << _bitCount) - 1;
+		}
+
+		m_scratch |= _value << m_scratchBits;
+		m_scratchBits += _bitCount;
+
+		while (m_scratchBits >= 8)
+		{
+			m_data.push_back(static_cast<uint8_t>(m_scratch));
+			m_scratch >>= 8;
+			m_scratchBits -= 8;
+		}
+	}
+
+	std::vector<uint8_t>& BitWriter::alignedBytes()
+	{
+		flush();
+		return m_data;
+	}
+
+	void BitWriter::flush()
+	{
+		if (m_scratchBits > 0)
+		{
+			m_data.push_back(static_cast<uint8_t>(m_scratch));
+			m_scratch = 0;
+			m_scratchBits = 0;
+		}
+	}
+
+	BitReader::BitReader(const std::vector<uint8_t>& _data, size_t& _offset) : m_data(_data), m_offset(_offset)
+	{
+		m_bitOffset = 0;
+	}
+
+	uint64_t BitReader::readBits(uint32_t _bitCount)
+	{
+		uint64_t value = 0;
+		uint32_t bitsRead = 0;
+
+		while (bitsRead < _bitCount)
+		{
+			if (m_offset >= m_data.size())
+			{
+				throw std::runtime_error("Bit field out of range");
+			}
+
+			uint32_t available = 8 - m_bitOffset;
+			uint32_t count = _bitCount - bitsRead < available ? _bitCount - bitsRead : available;
+			uint64_t bits = (static_cast<uint64_t>(m_data[m_offset]) >> m_bitOffset) & ((1ull << count) - 1);
+
+			value |= bits << bitsRead;
+			bitsRead += count;
+			m_bitOffset += count;
+
+			if (m_bitOffset == 8)
+			{
+				m_bitOffset = 0;
+				++m_offset;
+			}
+		}
+
+		return value;
+	}
+
+	size_t& BitReader::alignedOffset()
+	{
+		if (m_bitOffset != 0)
+		{
+			m_bitOffset = 0;
+			++m_offset;
+		}
+
+		return m_offset;
+	}
+
+	const std::vector<uint8_t>& BitReader::data() const
+	{
+		return m_data;
+	}
+}
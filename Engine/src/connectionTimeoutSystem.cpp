@@ -0,0 +1,187 @@
+#include "connectionTimeoutSystem.hpp"
+
+#include <algorithm>
+
+#include "TRA/engine/networkEcs.hpp"
+#include "TRA/engine/networkEcsUtils.hpp"
+
+#include "connectionTimeoutComponent.hpp"
+#include "heartbeatMessage.hpp"
+#include "messageComponent.hpp"
+#include "pendingDisconnectComponent.hpp"
+#include "socketComponent.hpp"
+
+namespace tra::engine
+{
+	namespace
+	{
+		constexpr uint64_t NS_PER_MS = 1'000'000;
+
+		bool isLivenessEnabled(const NetworkEngineConfig& _config)
+		{
+			return _config.m_heartbeatIntervalMs > 0 || _config.m_idleTimeoutMs > 0 || _config.m_handshakeTimeoutMs > 0;
+		}
+
+		void queueHeartbeat(EngineMetrics& _metrics, SendTcpMessageComponent& _sendMessageComponent, uint64_t _nowNs)
+		{
+			_sendMessageComponent.m_messagesToSend.push_back({ std::make_shared<message::TraHeartbeat>(), _nowNs });
+			_sendMessageComponent.m_lastQueuedNs = _nowNs;
+			_metrics.m_heartbeatsSent.add();
+		}
+
+		uint64_t getNextDeadline(const NetworkEngineConfig& _config, const ConnectionTimeoutComponent& _timeout,
+			const ReceiveTcpMessageComponent& _receiveMessageComponent, const SendTcpMessageComponent& _sendMessageComponent)
+		{
+			uint64_t deadlineNs = UINT64_MAX;
+
+			if (_config.m_handshakeTimeoutMs > 0 && !_receiveMessageComponent.m_frameReceived)
+			{
+				deadlineNs = (std::min)(deadlineNs, _timeout.m_armedNs + _config.m_handshakeTimeoutMs * NS_PER_MS);
+			}
+
+			if (_config.m_idleTimeoutMs > 0)
+			{
+				uint64_t lastReceiveNs = (std::max)(_receiveMessageComponent.m_lastReceiveNs, _timeout.m_armedNs);
+				deadlineNs = (std::min)(deadlineNs, lastReceiveNs + _config.m_idleTimeoutMs * NS_PER_MS);
+			}
+
+			if (_config.m_heartbeatIntervalMs > 0)
+			{
+				uint64_t lastQueuedNs = (std::max)(_sendMessageComponent.m_lastQueuedNs, _timeout.m_armedNs);
+				deadlineNs = (std::min)(deadlineNs, lastQueuedNs + _config.m_heartbeatIntervalMs * NS_PER_MS);
+			}
+
+			return deadlineNs;
+		}
+	}
+
+	void armConnectionTimeouts(NetworkEcs* _ecs, const NetworkEngineConfig& _config, EngineMetrics& _metrics, EntityId _selfEntityId,
+		EntityId _entityId, SendTcpMessageComponent& _sendMessageComponent)
+	{
+		if (!isLivenessEnabled(_config))
+		{
+			return;
+		}
+
+		auto getTimersResult = _ecs->getComponentOfEntity<ConnectionTimersComponent>(_selfEntityId);
+		std::shared_ptr<ConnectionTimersComponent> connectionTimersComponent = getTimersResult.second.lock();
+		if (!connectionTimersComponent)
+		{
+			return;
+		}
+
+		// The client's self entity is connected again on reconnect.
+		std::shared_ptr<ConnectionTimeoutComponent> connectionTimeoutComponent = nullptr;
+		if (_ecs->hasComponent<ConnectionTimeoutComponent>(_entityId))
+		{
+			connectionTimeoutComponent = _ecs->getComponentOfEntity<ConnectionTimeoutComponent>(_entityId).second.lock();
+			connectionTimersComponent->m_wheel.cancel(connectionTimeoutComponent->m_timer);
+		}
+		else
+		{
+			connectionTimeoutComponent = std::make_shared<ConnectionTimeoutComponent>();
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, connectionTimeoutComponent, { return; });
+		}
+
+		uint64_t nowNs = getLatencyClockNs();
+		connectionTimeoutComponent->m_armedNs = nowNs;
+
+		if (_config.m_heartbeatIntervalMs > 0)
+		{
+			queueHeartbeat(_metrics, _sendMessageComponent, nowNs);
+		}
+
+		// Whichever deadline is nearest; the rest are worked out when it fires.
+		uint32_t firstMs = UINT32_MAX;
+		for (uint32_t periodMs : { _config.m_heartbeatIntervalMs, _config.m_idleTimeoutMs, _config.m_handshakeTimeoutMs })
+		{
+			if (periodMs > 0)
+			{
+				firstMs = (std::min)(firstMs, periodMs);
+			}
+		}
+
+		connectionTimeoutComponent->m_timer = connectionTimersComponent->m_wheel.schedule(nowNs + firstMs * NS_PER_MS, _entityId);
+	}
+
+	void ConnectionTimeoutSystem::update(NetworkEcs* _ecs)
+	{
+		if (!isLivenessEnabled(m_config))
+		{
+			return;
+		}
+
+		for (auto queryResult : _ecs->query<ConnectionTimersComponent>())
+		{
+			TimerWheel& wheel = std::get<1>(queryResult)->m_wheel;
+			uint64_t nowNs = getLatencyClockNs();
+
+			m_expired.clear();
+			wheel.advance(nowNs, m_expired);
+
+			for (uint64_t payload : m_expired)
+			{
+				expire(_ecs, wheel, static_cast<EntityId>(payload), nowNs);
+			}
+		}
+	}
+
+	void ConnectionTimeoutSystem::expire(NetworkEcs* _ecs, TimerWheel& _wheel, EntityId _entityId, uint64_t _nowNs)
+	{
+		if (!_ecs->hasComponent<ConnectionTimeoutComponent>(_entityId))
+		{
+			return;
+		}
+
+		std::shared_ptr<ConnectionTimeoutComponent> connectionTimeoutComponent = _ecs->getComponentOfEntity<ConnectionTimeoutComponent>(_entityId).second.lock();
+		connectionTimeoutComponent->m_timer = TimerWheel::INVALID_TIMER;
+
+		// Gone or going: the timer stops here.
+		std::shared_ptr<ReceiveTcpMessageComponent> receiveTcpMessageComponent = _ecs->getComponentOfEntity<ReceiveTcpMessageComponent>(_entityId).second.lock();
+		std::shared_ptr<SendTcpMessageComponent> sendTcpMessageComponent = _ecs->getComponentOfEntity<SendTcpMessageComponent>(_entityId).second.lock();
+		if (!receiveTcpMessageComponent || !sendTcpMessageComponent || !_ecs->hasComponent<TcpConnectSocketComponent>(_entityId)
+			|| _ecs->hasComponent<PendingDisconnectComponentTag>(_entityId))
+		{
+			_ecs->removeComponentFromEntity<ConnectionTimeoutComponent>(_entityId);
+			return;
+		}
+
+		if (m_config.m_handshakeTimeoutMs > 0 && !receiveTcpMessageComponent->m_frameReceived
+			&& _nowNs >= connectionTimeoutComponent->m_armedNs + m_config.m_handshakeTimeoutMs * NS_PER_MS)
+		{
+			TRA_INFO_LOG("ConnectionTimeoutSystem: Entity ID: %I32u sent no frame within %u ms, disconnecting.", _entityId, m_config.m_handshakeTimeoutMs);
+			m_metrics.m_handshakeTimeouts.add();
+
+			_ecs->removeComponentFromEntity<ConnectionTimeoutComponent>(_entityId);
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+			return;
+		}
+
+		uint64_t lastReceiveNs = (std::max)(receiveTcpMessageComponent->m_lastReceiveNs, connectionTimeoutComponent->m_armedNs);
+		if (m_config.m_idleTimeoutMs > 0 && _nowNs >= lastReceiveNs + m_config.m_idleTimeoutMs * NS_PER_MS)
+		{
+			TRA_INFO_LOG("ConnectionTimeoutSystem: Entity ID: %I32u received nothing for %u ms, disconnecting.", _entityId, m_config.m_idleTimeoutMs);
+			m_metrics.m_idleTimeouts.add();
+
+			_ecs->removeComponentFromEntity<ConnectionTimeoutComponent>(_entityId);
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+			return;
+		}
+
+		uint64_t lastQueuedNs = (std::max)(sendTcpMessageComponent->m_lastQueuedNs, connectionTimeoutComponent->m_armedNs);
+		if (m_config.m_heartbeatIntervalMs > 0 && _nowNs >= lastQueuedNs + m_config.m_heartbeatIntervalMs * NS_PER_MS)
+		{
+			queueHeartbeat(m_metrics, *sendTcpMessageComponent, _nowNs);
+		}
+
+		// Only a handshake timeout, and the handshake is done.
+		uint64_t deadlineNs = getNextDeadline(m_config, *connectionTimeoutComponent, *receiveTcpMessageComponent, *sendTcpMessageComponent);
+		if (deadlineNs == UINT64_MAX)
+		{
+			_ecs->removeComponentFromEntity<ConnectionTimeoutComponent>(_entityId);
+			return;
+		}
+
+		connectionTimeoutComponent->m_timer = _wheel.schedule(deadlineNs, _entityId);
+	}
+}
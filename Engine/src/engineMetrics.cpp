@@ -0,0 +1,43 @@
+#include "engineMetrics.hpp"
+
+namespace tra::engine
+{
+	EngineMetrics::EngineMetrics(core::MetricsRegistry& _registry)
+		: m_registry(_registry),
+		m_tcpMessagesSent(_registry.counter("tra_tcp_messages_sent_total", "Messages serialized for sending over TCP.")),
+		m_tcpMessagesReceived(_registry.counter("tra_tcp_messages_received_total", "Messages decoded from TCP frames.")),
+		m_tcpBytesSent(_registry.counter("tra_tcp_bytes_sent_total", "Frame bytes written to TCP connections.")),
+		m_tcpBytesReceived(_registry.counter("tra_tcp_bytes_received_total", "Bytes read from TCP connections.")),
+		m_tcpPartialSends(_registry.counter("tra_tcp_partial_sends_total", "TCP sends that wrote only part of a frame.")),
+		m_tcpFramesDropped(_registry.counter("tra_tcp_frames_dropped_total", "Queued TCP frames dropped or coalesced for slow consumers.")),
+		m_tcpProtocolErrors(_registry.counter("tra_tcp_protocol_errors_total", "TCP frames rejected for version, size or sequence.")),
+		m_tcpDeserializeFailures(_registry.counter("tra_deserialize_failures_total", "Payloads that failed to deserialize.", "protocol=\"tcp\"")),
+		m_udpDeserializeFailures(_registry.counter("tra_deserialize_failures_total", "Payloads that failed to deserialize.", "protocol=\"udp\"")),
+		m_acceptedConnections(_registry.counter("tra_accepted_connections_total", "TCP connections accepted.")),
+		m_acceptFailures(_registry.counter("tra_accept_failures_total", "TCP accept calls that failed.")),
+		m_conditionerDatagramsDropped(_registry.counter("tra_conditioner_datagrams_dropped_total", "Received datagrams the network conditioner lost or tail-dropped.")),
+		m_conditionerDatagramsDuplicated(_registry.counter("tra_conditioner_datagrams_duplicated_total", "Received datagrams the network conditioner duplicated.")),
+		m_captureFrames(_registry.counter("tra_capture_frames_total", "Received TCP frames written to the traffic capture.")),
+		m_captureDroppedFrames(_registry.counter("tra_capture_dropped_frames_total", "Received TCP frames left out of the traffic capture because its writer fell behind.")),
+		m_heartbeatsSent(_registry.counter("tra_heartbeats_sent_total", "Heartbeats queued on idle TCP connections.")),
+		m_idleTimeouts(_registry.counter("tra_connection_timeouts_total", "TCP connections disconnected by a liveness timeout.", "reason=\"idle\"")),
+		m_handshakeTimeouts(_registry.counter("tra_connection_timeouts_total", "TCP connections disconnected by a liveness timeout.", "reason=\"handshake\"")),
+		m_tcpConnections(_registry.gauge("tra_tcp_connections", "Open TCP connections.")),
+		m_tcpSendQueueBytes(_registry.gauge("tra_tcp_send_queue_bytes", "Bytes queued for sending across all TCP connections.")),
+		m_tcpReceiveBufferedBytes(_registry.gauge("tra_tcp_receive_buffered_bytes", "Bytes read but not yet decoded across all TCP connections.")),
+		m_tcpConditionerQueuedBytes(_registry.gauge("tra_conditioner_queued_bytes", "Received bytes held by the network conditioner.", "protocol=\"tcp\"")),
+		m_udpConditionerQueuedBytes(_registry.gauge("tra_conditioner_queued_bytes", "Received bytes held by the network conditioner.", "protocol=\"udp\"")),
+		m_tcpFrameSize(_registry.histogram("tra_tcp_frame_size_bytes", "Size of TCP frames sent, header included.")),
+		m_tcpKernelSendDelay(_registry.histogram("tra_tcp_kernel_send_delay_us", "Time from a TCP send call to the data leaving the local stack.")),
+		m_tcpWireRoundTrip(_registry.histogram("tra_tcp_wire_rtt_us", "Time from TCP data leaving the local stack to the peer acknowledging it.")),
+		m_tcpKernelReceiveDelay(_registry.histogram("tra_kernel_receive_delay_us", "Time received data waited in the kernel before being read.", "protocol=\"tcp\"")),
+		m_udpKernelReceiveDelay(_registry.histogram("tra_kernel_receive_delay_us", "Time received data waited in the kernel before being read.", "protocol=\"udp\""))
+	{
+	}
+
+	void EngineMetrics::collect(core::MetricsSnapshot& _snapshot) const
+	{
+		m_registry.collect(_snapshot);
+		core::MetricsRegistry::getProcessRegistry().collect(_snapshot);
+	}
+}
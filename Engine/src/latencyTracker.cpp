@@ -0,0 +1,88 @@
+#include "latencyTracker.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "TRA/engine/message.hpp"
+#include "TRA/engine/networkEngine.hpp"
+
+namespace tra::engine
+{
+	namespace
+	{
+		LatencySummary summarize(const core::HdrHistogram& _histogram)
+		{
+			LatencySummary summary;
+			summary.m_count = _histogram.getCount();
+			summary.m_minNs = _histogram.getMin();
+			summary.m_p50Ns = _histogram.getValueAtPercentile(50.0);
+			summary.m_p90Ns = _histogram.getValueAtPercentile(90.0);
+			summary.m_p99Ns = _histogram.getValueAtPercentile(99.0);
+			summary.m_p999Ns = _histogram.getValueAtPercentile(99.9);
+			summary.m_maxNs = _histogram.getMax();
+
+			return summary;
+		}
+	}
+
+	void LatencyTracker::record(const Message& _message, Stage _stage, uint64_t _valueNs)
+	{
+		if (_message.isInternal())
+		{
+			return;
+		}
+
+		TypeLatency& typeLatency = m_types[_message.getTypeId()];
+		if (typeLatency.m_name.empty())
+		{
+			typeLatency.m_name = _message.getType();
+		}
+
+		typeLatency.m_stages[static_cast<size_t>(_stage)].record(_valueNs);
+	}
+
+	void LatencyTracker::reset()
+	{
+		for (auto& typeLatency : m_types)
+		{
+			for (core::HdrHistogram& histogram : typeLatency.second.m_stages)
+			{
+				histogram.reset();
+			}
+		}
+	}
+
+	std::vector<MessageLatency> LatencyTracker::getLatencies() const
+	{
+		std::vector<MessageLatency> latencies;
+		latencies.reserve(m_types.size());
+
+		for (const auto& typeLatency : m_types)
+		{
+			const TypeLatency& type = typeLatency.second;
+
+			// Types seen before the last reset but not since.
+			bool hasSamples = std::any_of(std::begin(type.m_stages), std::end(type.m_stages),
+				[](const core::HdrHistogram& _histogram) { return _histogram.getCount() > 0; });
+			if (!hasSamples)
+			{
+				continue;
+			}
+
+			MessageLatency latency;
+			latency.m_messageType = type.m_name;
+			latency.m_queue = summarize(type.m_stages[static_cast<size_t>(Stage::Queue)]);
+			latency.m_network = summarize(type.m_stages[static_cast<size_t>(Stage::Network)]);
+			latency.m_receive = summarize(type.m_stages[static_cast<size_t>(Stage::Receive)]);
+			latency.m_endToEnd = summarize(type.m_stages[static_cast<size_t>(Stage::EndToEnd)]);
+			latencies.push_back(std::move(latency));
+		}
+
+		std::sort(latencies.begin(), latencies.end(), [](const MessageLatency& _left, const MessageLatency& _right)
+			{
+				return _left.m_messageType < _right.m_messageType;
+			});
+
+		return latencies;
+	}
+}
@@ -37,58 +37,62 @@ namespace tra::engine
             MessageFactory::registerMessage(_id, _creator);
         }
 
-        void serializeField(std::vector<uint8_t>& _data, int _value)
+        void serializeField(std::vector<uint8_t>& _data, bool _value)
         {
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_data);
 
-            _data.insert(_data.end(), reinterpret_cast<const uint8_t*>(&_value),
-                reinterpret_cast<const uint8_t*>(&_value) + sizeof(_value));
+            _data.push_back(_value ? 1 : 0);
         }
 
-        void serializeField(std::vector<uint8_t>& _data, float _value)
+        void serializeField(std::vector<uint8_t>& _data, const std::string& _value)
         {
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_data);
+            TRA_ASSERT_REF_PTR_OR_COPIABLE(_value);
 
-            _data.insert(_data.end(), reinterpret_cast<const uint8_t*>(&_value),
-                reinterpret_cast<const uint8_t*>(&_value) + sizeof(_value));
+            serializeField(_data, static_cast<uint32_t>(_value.size()));
+            _data.insert(_data.end(), _value.begin(), _value.end());
         }
 
-        void serializeField(std::vector<uint8_t>& _data, const std::string& _value)
+        void serializeField(std::vector<uint8_t>& _data, const std::vector<bool>& _value)
         {
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_data);
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_value);
 
-            uint32_t size = static_cast<uint32_t>(_value.size());
-            _data.insert(_data.end(), reinterpret_cast<const uint8_t*>(&size),
-                reinterpret_cast<const uint8_t*>(&size) + sizeof(size));
-            _data.insert(_data.end(), _value.begin(), _value.end());
+            serializeField(_data, static_cast<uint32_t>(_value.size()));
+            serializeBoolBits(_data, _value, _value.size());
         }
 
-        void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, int& _value)
+        void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, bool& _value)
         {
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_data);
 
-            _value = *reinterpret_cast<const int*>(&_data[_offset]);
-            _offset += sizeof(int);
+            checkFieldBounds(_data, _offset, 1);
+            _value = _data[_offset] != 0;
+            _offset += 1;
         }
 
-        void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, float& _value)
+        void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::string& _value)
         {
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_data);
+            TRA_ASSERT_REF_PTR_OR_COPIABLE(_value);
 
-            _value = *reinterpret_cast<const float*>(&_data[_offset]);
-            _offset += sizeof(float);
+            uint32_t size = 0;
+            deserializeField(_data, _offset, size);
+            checkFieldBounds(_data, _offset, size);
+            _value.assign(reinterpret_cast<const char*>(_data.data() + _offset), size);
+            _offset += size;
         }
 
-        void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::string& _value)
+        void deserializeField(const std::vector<uint8_t>& _data, size_t& _offset, std::vector<bool>& _value)
         {
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_data);
             TRA_ASSERT_REF_PTR_OR_COPIABLE(_value);
 
-            uint32_t size = *reinterpret_cast<const uint32_t*>(&_data[_offset]);
-            _offset += sizeof(uint32_t);
-            _value.assign(reinterpret_cast<const char*>(&_data[_offset]), size);
-            _offset += size;
+            uint32_t size = 0;
+            deserializeField(_data, _offset, size);
+            checkFieldBounds(_data, _offset, (static_cast<size_t>(size) + 7) / 8);
+            _value.assign(size, false);
+            deserializeBoolBits(_data, _offset, _value, _value.size());
         }
     }
 }
@@ -5,11 +5,15 @@
 
 namespace tra::engine
 {
-    std::unordered_map<uint32_t, MessageFactory::Creator> MessageFactory::m_registry;
+    std::unordered_map<uint32_t, MessageFactory::Creator>& MessageFactory::getRegistry()
+    {
+        static std::unordered_map<uint32_t, Creator> registry;
+        return registry;
+    }
 
     void MessageFactory::registerMessage(const uint32_t _id, Creator _creator)
     {
-        m_registry[_id] = std::move(_creator);
+        getRegistry()[_id] = std::move(_creator);
     }
 
     std::vector<uint8_t> MessageFactory::serialize(const Message& _message)
@@ -19,24 +23,23 @@ namespace tra::engine
         return _message.serialize();
     }
 
-    std::unique_ptr<Message> MessageFactory::deserialize(const std::vector<uint8_t>& _payload)
+    std::unique_ptr<Message> MessageFactory::deserialize(const uint32_t _typeId, const std::vector<uint8_t>& _payload)
     {
         TRA_ASSERT_REF_PTR_OR_COPIABLE(_payload);
 
-        if (_payload.size() < sizeof(uint32_t))
+        std::unordered_map<uint32_t, Creator>& registry = getRegistry();
+        std::unordered_map<uint32_t, Creator>::iterator it = registry.find(_typeId);
+        if (it == registry.end())
         {
-            throw std::runtime_error("Payload too small");
-        }
-
-        uint32_t typeId;
-        std::memcpy(&typeId, _payload.data(), sizeof(uint32_t));
-
-        std::unordered_map<uint32_t, Creator>::iterator it = m_registry.find(typeId);
-        if (it == m_registry.end())
-        {
-            throw std::runtime_error("Unknown message type: " + std::to_string(typeId));
+            throw std::runtime_error("Unknown message type: " + std::to_string(_typeId));
         }
 
         return it->second(_payload);
     }
+
+    bool MessageFactory::isRegistered(const uint32_t _typeId)
+    {
+        const std::unordered_map<uint32_t, Creator>& registry = getRegistry();
+        return registry.find(_typeId) != registry.end();
+    }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <cstring>
 
 #include "TRA/debugUtils.hpp"
+#include "TRA/engine/endian.hpp"
 
 namespace tra::engine
 {
@@ -14,28 +15,106 @@ namespace tra::engine
 		return MessageFactory::serialize(_message);
 	}
 
-	std::unique_ptr<Message> MessageSerializer::deserializePayload(const std::vector<uint8_t>& _payload)
+	std::unique_ptr<Message> MessageSerializer::deserializePayload(uint32_t _typeId, const std::vector<uint8_t>& _payload)
 	{
 		TRA_ASSERT_REF_PTR_OR_COPIABLE(_payload);
 
-		return MessageFactory::deserialize(_payload);
+		try
+		{
+			return MessageFactory::deserialize(_typeId, _payload);
+		}
+		catch (const std::exception& exception)
+		{
+			TRA_ERROR_LOG("MessageSerializer::deserializePayload: %s", exception.what());
+			return nullptr;
+		}
 	}
 
-	std::vector<uint8_t> MessageSerializer::serializeForNetwork(const std::vector<uint8_t>& _payload, bool _internal)
+	std::vector<uint8_t> MessageSerializer::serializeForNetwork(MessageHeader _header, const std::vector<uint8_t>& _payload, bool _timestamped)
 	{
 		TRA_ASSERT_REF_PTR_OR_COPIABLE(_payload);
 
-		MessageHeader header;
-		header.size = static_cast<uint32_t>(_payload.size());
+		size_t extensionSize = _timestamped ? MESSAGE_TIMESTAMP_WIRE_SIZE : 0;
+		if (_timestamped)
+		{
+			_header.flags |= MessageFlagTimestamped;
+		}
+
+		_header.size = static_cast<uint32_t>(extensionSize + _payload.size());
 
-		std::vector<uint8_t> data(sizeof(MessageHeader));
-		std::memcpy(data.data(), &header, sizeof(header));
+		std::vector<uint8_t> data;
+		data.reserve(MESSAGE_HEADER_WIRE_SIZE + extensionSize + _payload.size());
+		Endian::appendLittle(data, _header.version);
+		Endian::appendLittle(data, static_cast<uint8_t>((_header.flags & MESSAGE_FLAGS_MASK) | (_header.channel << MESSAGE_CHANNEL_SHIFT)));
+		Endian::appendLittle(data, _header.sequence);
+		Endian::appendLittle(data, _header.typeId);
+		Endian::appendLittle(data, _header.size);
+		data.resize(data.size() + extensionSize, 0);
 		data.insert(data.end(), _payload.begin(), _payload.end());
 
 		return data;
 	}
 
-	bool MessageSerializer::getPayloadFromNetworkBuffer(const std::vector<uint8_t>& _buffer, 
+	void MessageSerializer::writeSequence(std::vector<uint8_t>& _frame, uint16_t _sequence)
+	{
+		TRA_ASSERT_REF_PTR_OR_COPIABLE(_frame);
+
+		if (_frame.size() < MESSAGE_HEADER_WIRE_SIZE)
+		{
+			return;
+		}
+
+		Endian::storeLittle(_frame.data() + MESSAGE_HEADER_SEQUENCE_OFFSET, _sequence);
+	}
+
+	void MessageSerializer::writeTimestamp(std::vector<uint8_t>& _frame, const MessageTimestamp& _timestamp)
+	{
+		TRA_ASSERT_REF_PTR_OR_COPIABLE(_frame);
+
+		if (_frame.size() < MESSAGE_HEADER_WIRE_SIZE + MESSAGE_TIMESTAMP_WIRE_SIZE)
+		{
+			return;
+		}
+
+		uint8_t* data = _frame.data() + MESSAGE_HEADER_WIRE_SIZE;
+		Endian::storeLittle(data, _timestamp.sendNs);
+		Endian::storeLittle(data + 8, _timestamp.queuedNs);
+		Endian::storeLittle(data + 12, _timestamp.echoNs);
+		Endian::storeLittle(data + 20, _timestamp.echoHoldNs);
+	}
+
+	MessageTimestamp MessageSerializer::readTimestamp(const uint8_t* _data)
+	{
+		MessageTimestamp timestamp;
+		timestamp.sendNs = Endian::loadLittle<uint64_t>(_data);
+		timestamp.queuedNs = Endian::loadLittle<uint32_t>(_data + 8);
+		timestamp.echoNs = Endian::loadLittle<uint64_t>(_data + 12);
+		timestamp.echoHoldNs = Endian::loadLittle<uint32_t>(_data + 20);
+
+		return timestamp;
+	}
+
+	bool MessageSerializer::readHeader(const std::vector<uint8_t>& _buffer, size_t _offset, MessageHeader& _outHeader)
+	{
+		TRA_ASSERT_REF_PTR_OR_COPIABLE(_buffer);
+
+		if (_offset > _buffer.size() || _buffer.size() - _offset < MESSAGE_HEADER_WIRE_SIZE)
+		{
+			return false;
+		}
+
+		const uint8_t* data = _buffer.data() + _offset;
+		_outHeader.version = data[0];
+		_outHeader.flags = data[1] & MESSAGE_FLAGS_MASK;
+		_outHeader.channel = data[1] >> MESSAGE_CHANNEL_SHIFT;
+		_outHeader.sequence = Endian::loadLittle<uint16_t>(data + 2);
+		_outHeader.typeId = Endian::loadLittle<uint32_t>(data + 4);
+		_outHeader.size = Endian::loadLittle<uint32_t>(data + 8);
+
+		return true;
+	}
+
+	bool MessageSerializer::getPayloadFromNetworkBuffer(const std::vector<uint8_t>& _buffer, MessageHeader& _outHeader,
 		std::vector<uint8_t>& _outPayload, size_t& _outConsumedBytes)
 	{
 		TRA_ASSERT_REF_PTR_OR_COPIABLE(_buffer);
@@ -44,23 +123,20 @@ namespace tra::engine
 		_outConsumedBytes = 0;
 		_outPayload.clear();
 
-		if (_buffer.size() < sizeof(MessageHeader))
+		if (!readHeader(_buffer, 0, _outHeader))
 		{
 			return false;
 		}
 
-		MessageHeader header;
-		std::memcpy(&header, _buffer.data(), sizeof(MessageHeader));
-		if (_buffer.size() < sizeof(MessageHeader) + header.size)
+		if (_buffer.size() - MESSAGE_HEADER_WIRE_SIZE < _outHeader.size)
 		{
 			return false;
 		}
 
-		_outPayload.resize(header.size);
-		std::memcpy(_outPayload.data(), _buffer.data() + sizeof(MessageHeader), header.size);
+		_outPayload.assign(_buffer.begin() + MESSAGE_HEADER_WIRE_SIZE, _buffer.begin() + MESSAGE_HEADER_WIRE_SIZE + _outHeader.size);
 
-		_outConsumedBytes = sizeof(MessageHeader) + header.size;
+		_outConsumedBytes = MESSAGE_HEADER_WIRE_SIZE + _outHeader.size;
 
 		return true;
 	}
-}
\ No newline at end of file
+}
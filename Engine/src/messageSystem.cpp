@@ -1,6 +1,7 @@
 #include "messageSystem.hpp"
 
-#define TRA_MAX_TCP_MESSAGES_TO_RECEIVE_PAR_TICK 32
+#include <algorithm>
+#include <unordered_set>
 
 #include "TRA/debugUtils.hpp"
 
@@ -10,13 +11,29 @@
 #include "TRA/engine/networkEcsUtils.hpp"
 
 #include "messageSerializer.hpp"
+#include "heartbeatMessage.hpp"
 
 #include "socketComponent.hpp"
 #include "messageComponent.hpp"
 #include "pendingDisconnectComponent.hpp"
+#include "trafficCaptureComponent.hpp"
 
 namespace tra::engine
 {
+	namespace
+	{
+		void updateSmoothed(uint64_t& _average, uint64_t _sample)
+		{
+			if (_average == 0)
+			{
+				_average = _sample;
+				return;
+			}
+
+			_average = _average - _average / 8 + _sample / 8;
+		}
+	}
+
 	void SendTcpMessageSystem::update(NetworkEcs* _ecs)
 	{
 		EntityId entityId = 0;
@@ -25,6 +42,14 @@ namespace tra::engine
 		std::shared_ptr<SendTcpMessageComponent> sendTcpMessageComponent = nullptr;
 
 		std::vector<uint8_t> serializedMessage;
+		MessageHeader header;
+
+		int64_t connections = 0;
+		int64_t queuedBytes = 0;
+
+		// Heartbeats are only sent after a quiet interval.
+		bool heartbeats = m_config.m_heartbeatIntervalMs > 0;
+		uint64_t nowNs = heartbeats ? getLatencyClockNs() : 0;
 
 		for (auto queryResult : _ecs->query<TcpConnectSocketComponent, SendTcpMessageComponent>())
 		{
@@ -36,36 +61,89 @@ namespace tra::engine
 
 			tcpSocketComponent = std::get<1>(queryResult);
 			sendTcpMessageComponent = std::get<2>(queryResult);
+			++connections;
 
-			for (auto message : sendTcpMessageComponent->m_messagesToSend)
+			if (heartbeats && !sendTcpMessageComponent->m_messagesToSend.empty())
 			{
-				serializedMessage.clear();
+				sendTcpMessageComponent->m_lastQueuedNs = nowNs;
+			}
+
+			bool timestamped = m_config.m_latencyTimestamps;
+
+			for (PendingTcpMessage& pendingMessage : sendTcpMessageComponent->m_messagesToSend)
+			{
+				std::shared_ptr<Message>& message = pendingMessage.m_message;
 				serializedMessage = MessageSerializer::serializePayload(*message.get());
-				serializedMessage = MessageSerializer::serializeForNetwork(serializedMessage);
-				sendTcpMessageComponent->m_serializedToSend.push_back(serializedMessage);
+				header.typeId = message->getTypeId();
+
+				QueuedTcpFrame frame;
+				frame.m_data = MessageSerializer::serializeForNetwork(header, serializedMessage, timestamped);
+				frame.m_typeId = header.typeId;
+				frame.m_droppable = message->isDroppable();
+				frame.m_coalescable = message->isCoalescable();
+				frame.m_coalesceKey = { header.typeId, message->getCoalesceKey() };
+
+				if (timestamped)
+				{
+					frame.m_timestamped = true;
+					frame.m_enqueuedNs = pendingMessage.m_enqueuedNs;
+					frame.m_message = message;
+				}
+
+				m_metrics.m_tcpMessagesSent.add();
+				m_metrics.m_tcpFrameSize.record(frame.m_data.size());
+				++sendTcpMessageComponent->m_messagesSent;
+
+				enqueueFrame(*sendTcpMessageComponent, std::move(frame));
 			}
 
 			sendTcpMessageComponent->m_messagesToSend.clear();
+			sendTcpMessageComponent->m_pendingCoalesced.clear();
 
-			for (auto messageIt = sendTcpMessageComponent->m_serializedToSend.begin(); messageIt != sendTcpMessageComponent->m_serializedToSend.end();)
+			std::shared_ptr<ReceiveTcpMessageComponent> receiveTcpMessageComponent = nullptr;
+
+			while (!sendTcpMessageComponent->m_serializedToSend.empty())
 			{
+				QueuedTcpFrame& frame = sendTcpMessageComponent->m_serializedToSend.front();
+				std::vector<uint8_t>& frameData = frame.m_data;
+				if (sendTcpMessageComponent->m_lastMessageByteSent == 0)
+				{
+					MessageSerializer::writeSequence(frameData, sendTcpMessageComponent->m_nextSequence++);
+
+					if (frame.m_timestamped)
+					{
+						if (!receiveTcpMessageComponent)
+						{
+							receiveTcpMessageComponent = _ecs->getComponentOfEntity<ReceiveTcpMessageComponent>(entityId).second.lock();
+						}
+
+						stampFrame(frame, receiveTcpMessageComponent.get());
+					}
+				}
+
 				int byteSent = 0;
-				auto sendDataResult = tcpSocketComponent->m_tcpSocket->sendData(messageIt->data() + sendTcpMessageComponent->m_lastMessageByteSent,
-					messageIt->size() - sendTcpMessageComponent->m_lastMessageByteSent, byteSent);
+				auto sendDataResult = tcpSocketComponent->m_tcpSocket->sendData(frameData.data() + sendTcpMessageComponent->m_lastMessageByteSent,
+					frameData.size() - sendTcpMessageComponent->m_lastMessageByteSent, byteSent);
+
+				sendTcpMessageComponent->m_queuedBytes -= static_cast<size_t>(byteSent);
+				sendTcpMessageComponent->m_bytesSent += static_cast<uint64_t>(byteSent);
+				m_metrics.m_tcpBytesSent.add(static_cast<uint64_t>(byteSent));
 
 				if (sendDataResult.first != ErrorCode::Success)
 				{
 					if (sendDataResult.first == ErrorCode::SocketSendPartial)
 					{
-						sendTcpMessageComponent->m_lastMessageByteSent = byteSent;
+						++sendTcpMessageComponent->m_partialSends;
+						m_metrics.m_tcpPartialSends.add();
+						sendTcpMessageComponent->m_lastMessageByteSent += byteSent;
 						TRA_DEBUG_LOG("SendTcpMessageSystem::update: Partial data sent for entity %llu, BytesSent: %d/%llu",
-							static_cast<unsigned long long>(entityId), byteSent, static_cast<unsigned long long>(messageIt->size()));
+							static_cast<unsigned long long>(entityId), sendTcpMessageComponent->m_lastMessageByteSent, static_cast<unsigned long long>(frameData.size()));
 					}
 					else if (sendDataResult.first == ErrorCode::SocketConnectionClosed)
 					{
 						TRA_ENTITY_ADD_COMPONENT(_ecs, entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
 					}
-					else
+					else if (sendDataResult.first != ErrorCode::SocketWouldBlock)
 					{
 						TRA_ERROR_LOG("SendTcpMessageSystem::update: Failed to send data for entity %llu, ErrorCode: %d, Last socket error: %d",
 							static_cast<unsigned long long>(entityId), static_cast<int>(sendDataResult.first), static_cast<int>(sendDataResult.second));
@@ -76,23 +154,312 @@ namespace tra::engine
 					break;
 				}
 
-				messageIt = sendTcpMessageComponent->m_serializedToSend.erase(messageIt);
+				QueuedTcpFrame& sentFrame = sendTcpMessageComponent->m_serializedToSend.front();
+				if (sentFrame.m_coalescable)
+				{
+					// A newer frame with the key may have been queued behind this
+					// one while it was partly sent; the index then points at it.
+					auto coalescedIt = sendTcpMessageComponent->m_queuedCoalesced.find(sentFrame.m_coalesceKey);
+					if (coalescedIt != sendTcpMessageComponent->m_queuedCoalesced.end() && coalescedIt->second == &sentFrame)
+					{
+						sendTcpMessageComponent->m_queuedCoalesced.erase(coalescedIt);
+					}
+				}
+
+				sendTcpMessageComponent->m_lastMessageByteSent = 0;
+				sendTcpMessageComponent->m_serializedToSend.pop_front();
+			}
+
+			if (tcpSocketComponent->m_tcpSocket->isKernelTimestamping())
+			{
+				readKernelTimestamps(_ecs, entityId, *tcpSocketComponent->m_tcpSocket, *sendTcpMessageComponent);
+			}
+
+			updateCongestion(_ecs, entityId, *sendTcpMessageComponent);
+			queuedBytes += static_cast<int64_t>(sendTcpMessageComponent->m_queuedBytes);
+		}
+
+		m_metrics.m_tcpConnections.set(connections);
+		m_metrics.m_tcpSendQueueBytes.set(queuedBytes);
+	}
+
+	void SendTcpMessageSystem::stampFrame(QueuedTcpFrame& _frame, const ReceiveTcpMessageComponent* _receiveComponent)
+	{
+		MessageTimestamp timestamp;
+		timestamp.sendNs = getLatencyClockNs();
+
+		uint64_t queuedNs = timestamp.sendNs - (std::min)(_frame.m_enqueuedNs, timestamp.sendNs);
+		timestamp.queuedNs = static_cast<uint32_t>((std::min)(queuedNs, static_cast<uint64_t>(UINT32_MAX)));
+
+		if (_receiveComponent && _receiveComponent->m_echoPeerNs != 0)
+		{
+			uint64_t holdNs = timestamp.sendNs - (std::min)(_receiveComponent->m_echoReadNs, timestamp.sendNs);
+			if (holdNs <= UINT32_MAX)
+			{
+				timestamp.echoNs = _receiveComponent->m_echoPeerNs;
+				timestamp.echoHoldNs = static_cast<uint32_t>(holdNs);
+			}
+		}
+
+		MessageSerializer::writeTimestamp(_frame.m_data, timestamp);
+
+		if (_frame.m_message)
+		{
+			m_metrics.m_latency.record(*_frame.m_message, LatencyTracker::Stage::Queue, queuedNs);
+			_frame.m_message.reset();
+		}
+	}
+
+	void SendTcpMessageSystem::readKernelTimestamps(NetworkEcs* _ecs, EntityId _entityId, core::TcpSocket& _socket, SendTcpMessageComponent& _component)
+	{
+		m_transmitTimestamps.clear();
+		uint64_t receiveDelayNs = 0;
+
+		auto readResult = _socket.readKernelTimestamps(m_transmitTimestamps, receiveDelayNs);
+		if (readResult.first != ErrorCode::Success)
+		{
+			TRA_DEBUG_LOG("SendTcpMessageSystem::update: Failed to read kernel timestamps for entity %llu, ErrorCode: %d, Last socket error: %d",
+				static_cast<unsigned long long>(_entityId), static_cast<int>(readResult.first), readResult.second);
+			return;
+		}
+
+		for (const core::TransmitTimestamp& transmit : m_transmitTimestamps)
+		{
+			updateSmoothed(_component.m_kernelSendDelayNs, transmit.m_bufferedNs);
+			updateSmoothed(_component.m_wireRoundTripNs, transmit.m_wireNs);
+			m_metrics.m_tcpKernelSendDelay.record(transmit.m_bufferedNs / 1000);
+			m_metrics.m_tcpWireRoundTrip.record(transmit.m_wireNs / 1000);
+		}
+
+		// Only fresh samples keep the connection marked: the average is not
+		// updated while nothing is being sent.
+		if (!m_transmitTimestamps.empty())
+		{
+			_component.m_kernelSendDelayed = m_config.m_kernelSendDelayCongestionMs != 0
+				&& _component.m_kernelSendDelayNs > static_cast<uint64_t>(m_config.m_kernelSendDelayCongestionMs) * 1000000;
+		}
+		else if (_component.m_queuedBytes == 0)
+		{
+			_component.m_kernelSendDelayed = false;
+		}
+
+		if (receiveDelayNs != 0)
+		{
+			std::shared_ptr<ReceiveTcpMessageComponent> receiveTcpMessageComponent = _ecs->getComponentOfEntity<ReceiveTcpMessageComponent>(_entityId).second.lock();
+			if (receiveTcpMessageComponent)
+			{
+				updateSmoothed(receiveTcpMessageComponent->m_kernelReceiveDelayNs, receiveDelayNs);
+			}
+
+			m_metrics.m_tcpKernelReceiveDelay.record(receiveDelayNs / 1000);
+		}
+	}
+
+	void SendTcpMessageSystem::enqueueFrame(SendTcpMessageComponent& _component, QueuedTcpFrame&& _frame)
+	{
+		if (_frame.m_coalescable)
+		{
+			auto it = _component.m_queuedCoalesced.find(_frame.m_coalesceKey);
+			if (it != _component.m_queuedCoalesced.end())
+			{
+				QueuedTcpFrame* queuedFrame = it->second;
+				bool isSending = queuedFrame == &_component.m_serializedToSend.front() && _component.m_lastMessageByteSent > 0;
+				if (!isSending)
+				{
+					_component.m_queuedBytes += _frame.m_data.size();
+					_component.m_queuedBytes -= queuedFrame->m_data.size();
+					*queuedFrame = std::move(_frame);
+					return;
+				}
+			}
+		}
+
+		_component.m_queuedBytes += _frame.m_data.size();
+		_component.m_serializedToSend.push_back(std::move(_frame));
+
+		QueuedTcpFrame& queuedFrame = _component.m_serializedToSend.back();
+		if (queuedFrame.m_coalescable)
+		{
+			_component.m_queuedCoalesced[queuedFrame.m_coalesceKey] = &queuedFrame;
+		}
+	}
+
+	void SendTcpMessageSystem::rebuildCoalesceIndex(SendTcpMessageComponent& _component)
+	{
+		_component.m_queuedCoalesced.clear();
+		for (QueuedTcpFrame& frame : _component.m_serializedToSend)
+		{
+			if (frame.m_coalescable)
+			{
+				_component.m_queuedCoalesced[frame.m_coalesceKey] = &frame;
+			}
+		}
+	}
+
+	void SendTcpMessageSystem::updateCongestion(NetworkEcs* _ecs, EntityId _entityId, SendTcpMessageComponent& _component)
+	{
+		if (_component.m_queuedBytes > m_config.m_maxSendQueueSize)
+		{
+			TRA_ERROR_LOG("SendTcpMessageSystem::update: Send queue limit exceeded for entity %llu, QueuedBytes: %llu",
+				static_cast<unsigned long long>(_entityId), static_cast<unsigned long long>(_component.m_queuedBytes));
+
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+			return;
+		}
+
+		if (_component.m_queuedBytes <= m_config.m_sendHighWatermark)
+		{
+			_component.m_ticksAboveHighWatermark = 0;
+		}
+		else if (++_component.m_ticksAboveHighWatermark >= m_config.m_slowConsumerTicks)
+		{
+			TRA_DEBUG_LOG("SendTcpMessageSystem::update: Slow consumer entity %llu, QueuedBytes: %llu, Policy: %d",
+				static_cast<unsigned long long>(_entityId), static_cast<unsigned long long>(_component.m_queuedBytes),
+				static_cast<int>(m_config.m_slowConsumerPolicy));
+
+			switch (m_config.m_slowConsumerPolicy)
+			{
+			case SlowConsumerPolicy::DropOldest:
+				dropOldest(_component);
+				rebuildCoalesceIndex(_component);
+				break;
+			case SlowConsumerPolicy::Coalesce:
+				coalesce(_component);
+				rebuildCoalesceIndex(_component);
+				break;
+			case SlowConsumerPolicy::Disconnect:
+				TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+				return;
+			}
+
+			_component.m_ticksAboveHighWatermark = 0;
+		}
+
+		// Data sitting in the local stack means the socket buffer is backing up
+		// even when our own queue is short.
+		if (_component.m_queuedBytes >= m_config.m_sendHighWatermark || _component.m_kernelSendDelayed)
+		{
+			_component.m_congested = true;
+		}
+		else if (_component.m_queuedBytes <= m_config.m_sendLowWatermark)
+		{
+			_component.m_congested = false;
+		}
+	}
+
+	void SendTcpMessageSystem::dropOldest(SendTcpMessageComponent& _component)
+	{
+		auto it = _component.m_serializedToSend.begin();
+		if (it != _component.m_serializedToSend.end() && _component.m_lastMessageByteSent > 0)
+		{
+			++it;
+		}
+
+		while (it != _component.m_serializedToSend.end() && _component.m_queuedBytes > m_config.m_sendLowWatermark)
+		{
+			if (!it->m_droppable)
+			{
+				++it;
+				continue;
+			}
+
+			_component.m_queuedBytes -= it->m_data.size();
+			it = _component.m_serializedToSend.erase(it);
+			m_metrics.m_tcpFramesDropped.add();
+		}
+	}
+
+	void SendTcpMessageSystem::coalesce(SendTcpMessageComponent& _component)
+	{
+		std::deque<QueuedTcpFrame>& frames = _component.m_serializedToSend;
+		size_t firstCandidate = _component.m_lastMessageByteSent > 0 ? 1 : 0;
+
+		std::unordered_set<uint32_t> newestTypes;
+		std::vector<bool> keep(frames.size(), true);
+		for (size_t i = frames.size(); i > firstCandidate; i--)
+		{
+			const QueuedTcpFrame& frame = frames[i - 1];
+			if (frame.m_droppable && !frame.m_coalescable && !newestTypes.insert(frame.m_typeId).second)
+			{
+				keep[i - 1] = false;
+				_component.m_queuedBytes -= frame.m_data.size();
+				m_metrics.m_tcpFramesDropped.add();
+			}
+		}
+
+		size_t kept = 0;
+		for (size_t i = 0; i < frames.size(); i++)
+		{
+			if (keep[i])
+			{
+				if (kept != i)
+				{
+					frames[kept] = std::move(frames[i]);
+				}
+
+				++kept;
 			}
 		}
+
+		frames.resize(kept);
 	}
 
 	void ReceiveTcpMessageSystem::update(NetworkEcs* _ecs)
 	{
-		uint8_t messagesReceived = 0;
+		m_capture = nullptr;
+		for (auto queryResult : _ecs->query<TrafficCaptureComponent>())
+		{
+			m_capture = std::get<1>(queryResult)->m_writer.get();
+			m_captureNowNs = getLatencyClockNs();
+		}
+
+		readConnections(_ecs);
+		decodeConnections(_ecs);
+
+		if (m_capture)
+		{
+			m_capture->flush();
+			m_capture = nullptr;
+		}
+	}
+
+	void ReceiveTcpMessageSystem::decodeBuffered(NetworkEcs* _ecs)
+	{
+		EntityId entityId = 0;
+		std::shared_ptr<ReceiveTcpMessageComponent> receiveTcpMessageComponent = nullptr;
+
+		m_pendingConnections.clear();
+
+		for (auto queryResult : _ecs->query<ReceiveTcpMessageComponent>())
+		{
+			entityId = std::get<0>(queryResult);
+			if (_ecs->hasComponent<PendingDisconnectComponentTag>(entityId))
+			{
+				continue;
+			}
 
+			receiveTcpMessageComponent = std::get<1>(queryResult);
+			receiveTcpMessageComponent->m_receivedMessages.clear();
+
+			compactBuffer(*receiveTcpMessageComponent);
+			queueIfReady(_ecs, entityId, receiveTcpMessageComponent);
+		}
+
+		decodeConnections(_ecs);
+	}
+
+	void ReceiveTcpMessageSystem::readConnections(NetworkEcs* _ecs)
+	{
 		EntityId entityId = 0;
 		std::shared_ptr<TcpConnectSocketComponent> tcpSocketComponent = nullptr;
 		std::shared_ptr<ReceiveTcpMessageComponent> receiveTcpMessageComponent = nullptr;
 
-		std::vector<uint8_t> newReceivedBuffer;
-		std::vector<uint8_t> payload;
+		int64_t bufferedBytes = 0;
+		int64_t conditionedBytes = 0;
+
+		uint64_t nowNs = getLatencyClockNs();
 
-		size_t consumedBytes = 0;
+		m_pendingConnections.clear();
 
 		for (auto queryResult : _ecs->query<TcpConnectSocketComponent, ReceiveTcpMessageComponent>())
 		{
@@ -107,49 +474,360 @@ namespace tra::engine
 
 			receiveTcpMessageComponent->m_receivedMessages.clear();
 
-			auto receiveDataResult = tcpSocketComponent->m_tcpSocket->receiveData(newReceivedBuffer);
-			if (receiveDataResult.first != ErrorCode::Success && receiveDataResult.first != ErrorCode::SocketWouldBlock)
+			std::vector<uint8_t>& receivedBuffer = receiveTcpMessageComponent->m_receivedBuffer;
+			compactBuffer(*receiveTcpMessageComponent);
+
+			if (m_config.m_conditioner.m_enabled && !receiveTcpMessageComponent->m_conditioner)
+			{
+				receiveTcpMessageComponent->m_conditioner = std::make_unique<NetworkConditioner>(m_config.m_conditioner, entityId);
+			}
+
+			NetworkConditioner* conditioner = receiveTcpMessageComponent->m_conditioner.get();
+			if (conditioner && receiveTcpMessageComponent->m_peerClosed && conditioner->isEmpty())
+			{
+				TRA_ENTITY_ADD_COMPONENT(_ecs, entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+				continue;
+			}
+
+			size_t freeCapacity = receivedBuffer.size() < m_config.m_maxReceiveBufferSize ? m_config.m_maxReceiveBufferSize - receivedBuffer.size() : 0;
+			if (freeCapacity == 0)
+			{
+				TRA_DEBUG_LOG("ReceiveTcpMessageSystem::update: Receive buffer full for entity %llu, reading paused, ErrorCode: %d",
+					static_cast<unsigned long long>(entityId), static_cast<int>(ErrorCode::ReceiveBufferFull));
+			}
+			else
 			{
-				if (receiveDataResult.first == ErrorCode::SocketConnectionClosed)
+				size_t readLimit = (std::min)(freeCapacity, m_config.m_maxBytesReadPerTick);
+				if (conditioner)
 				{
-					TRA_ENTITY_ADD_COMPONENT(_ecs, entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
-					continue;
+					// The link holds what was read until it is due, so it is
+					// its room that bounds the read.
+					readLimit = receiveTcpMessageComponent->m_peerClosed ? 0 : (std::min)(conditioner->getFreeBytes(), m_config.m_maxBytesReadPerTick);
 				}
-				else
+
+				m_newReceivedBuffer.clear();
+				auto receiveDataResult = readLimit > 0 ? tcpSocketComponent->m_tcpSocket->receiveData(m_newReceivedBuffer, readLimit)
+					: std::pair<ErrorCode, int>(ErrorCode::Success, 0);
+				if (receiveDataResult.first == ErrorCode::SocketConnectionClosed && conditioner)
 				{
-					TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Failed to receive data for entity %llu, ErrorCode: %d, Last socket error: %d",
-						static_cast<unsigned long long>(entityId), static_cast<int>(receiveDataResult.first), static_cast<int>(receiveDataResult.second));
-					
+					receiveTcpMessageComponent->m_peerClosed = true;
+				}
+				else if (receiveDataResult.first != ErrorCode::Success && receiveDataResult.first != ErrorCode::SocketWouldBlock)
+				{
+					if (receiveDataResult.first != ErrorCode::SocketConnectionClosed)
+					{
+						TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Failed to receive data for entity %llu, ErrorCode: %d, Last socket error: %d",
+							static_cast<unsigned long long>(entityId), static_cast<int>(receiveDataResult.first), static_cast<int>(receiveDataResult.second));
+					}
+
 					TRA_ENTITY_ADD_COMPONENT(_ecs, entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
 					continue;
 				}
+
+				if (conditioner)
+				{
+					conditioner->pushStream(m_newReceivedBuffer, nowNs);
+					m_newReceivedBuffer.clear();
+					conditioner->popStream(m_newReceivedBuffer, (std::min)(freeCapacity, m_config.m_maxBytesReadPerTick), nowNs);
+				}
+
+				receivedBuffer.insert(receivedBuffer.end(), m_newReceivedBuffer.begin(), m_newReceivedBuffer.end());
+				receiveTcpMessageComponent->m_bytesReceived += m_newReceivedBuffer.size();
+				m_metrics.m_tcpBytesReceived.add(m_newReceivedBuffer.size());
+
+				if (!m_newReceivedBuffer.empty())
+				{
+					receiveTcpMessageComponent->m_lastReceiveNs = nowNs;
+				}
+
+				if (m_config.m_latencyTimestamps && !m_newReceivedBuffer.empty())
+				{
+					receiveTcpMessageComponent->m_lastReadNs = getLatencyClockNs();
+				}
+			}
+
+			bufferedBytes += static_cast<int64_t>(receivedBuffer.size());
+			if (conditioner)
+			{
+				conditionedBytes += static_cast<int64_t>(conditioner->getQueuedBytes());
 			}
 
-			receiveTcpMessageComponent->m_receivedBuffer.insert(receiveTcpMessageComponent->m_receivedBuffer.end(),
-				newReceivedBuffer.begin(), newReceivedBuffer.end());
+			queueIfReady(_ecs, entityId, receiveTcpMessageComponent);
+		}
+
+		m_metrics.m_tcpReceiveBufferedBytes.set(bufferedBytes);
+		m_metrics.m_tcpConditionerQueuedBytes.set(conditionedBytes);
+	}
+
+	void ReceiveTcpMessageSystem::compactBuffer(ReceiveTcpMessageComponent& _component)
+	{
+		std::vector<uint8_t>& receivedBuffer = _component.m_receivedBuffer;
+		if (_component.m_readOffset > 0)
+		{
+			receivedBuffer.erase(receivedBuffer.begin(), receivedBuffer.begin() + static_cast<std::vector<uint8_t>::difference_type>(_component.m_readOffset));
+			_component.m_readOffset = 0;
+		}
+
+		if (receivedBuffer.empty() && receivedBuffer.capacity() > m_config.m_maxBytesReadPerTick)
+		{
+			std::vector<uint8_t>().swap(receivedBuffer);
+		}
+	}
+
+	void ReceiveTcpMessageSystem::queueIfReady(NetworkEcs* _ecs, EntityId _entityId, const std::shared_ptr<ReceiveTcpMessageComponent>& _component)
+	{
+		MessageHeader header;
+		if (peekFrame(_ecs, _entityId, *_component, header) == FrameStatus::Ready)
+		{
+			m_pendingConnections.push_back({ _entityId, _component });
+		}
+		else
+		{
+			_component->m_deficit = 0;
+			_component->m_deferredTicks = 0;
+		}
+	}
+
+	void ReceiveTcpMessageSystem::decodeConnections(NetworkEcs* _ecs)
+	{
+		if (m_pendingConnections.empty())
+		{
+			return;
+		}
+
+		std::rotate(m_pendingConnections.begin(), m_pendingConnections.begin() + static_cast<std::ptrdiff_t>(m_nextStartIndex++ % m_pendingConnections.size()),
+			m_pendingConnections.end());
+
+		size_t bytesBudget = m_config.m_maxBytesDecodedPerTick;
+		uint32_t messagesBudget = m_config.m_maxMessagesDecodedPerTick;
+		size_t maxDeficit = m_config.m_receiveQuantum + MESSAGE_HEADER_WIRE_SIZE + m_config.m_maxFrameSize;
+
+		MessageHeader header;
+		FrameStatus status = FrameStatus::Ready;
 
-			messagesReceived = 0;
-			while (messagesReceived < TRA_MAX_TCP_MESSAGES_TO_RECEIVE_PAR_TICK)
+		while (!m_pendingConnections.empty() && bytesBudget > 0 && messagesBudget > 0)
+		{
+			size_t kept = 0;
+			for (size_t i = 0; i < m_pendingConnections.size(); i++)
 			{
-				if (!MessageSerializer::getPayloadFromNetworkBuffer(receiveTcpMessageComponent->m_receivedBuffer, payload, consumedBytes))
+				PendingConnection& connection = m_pendingConnections[i];
+				if (bytesBudget == 0 || messagesBudget == 0)
 				{
-					break;
+					m_pendingConnections[kept++] = connection;
+					continue;
 				}
 
-				receiveTcpMessageComponent->m_receivedBuffer.erase(receiveTcpMessageComponent->m_receivedBuffer.begin(), 
-					receiveTcpMessageComponent->m_receivedBuffer.begin() + static_cast<std::vector<uint8_t>::difference_type>(consumedBytes));
+				ReceiveTcpMessageComponent& component = *connection.m_component;
+				component.m_deficit = (std::min)(component.m_deficit + m_config.m_receiveQuantum, maxDeficit);
 
-				std::shared_ptr<Message> newMessage = MessageSerializer::deserializePayload(payload);
-				if (!newMessage)
+				while ((status = peekFrame(_ecs, connection.m_entityId, component, header)) == FrameStatus::Ready)
 				{
-					TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Failed to deserialize message for entity %llu",
-						static_cast<unsigned long long>(entityId));
-					continue;
+					size_t frameSize = MESSAGE_HEADER_WIRE_SIZE + header.size;
+					if (frameSize > component.m_deficit || bytesBudget == 0 || messagesBudget == 0)
+					{
+						break;
+					}
+
+					consumeFrame(connection.m_entityId, component, header);
+
+					component.m_deficit -= frameSize;
+					bytesBudget -= (std::min)(frameSize, bytesBudget);
+					--messagesBudget;
+				}
+
+				if (status == FrameStatus::Ready)
+				{
+					m_pendingConnections[kept++] = connection;
 				}
+				else
+				{
+					component.m_deficit = 0;
+					component.m_deferredTicks = 0;
+				}
+			}
 
-				receiveTcpMessageComponent->m_receivedMessages[newMessage->getType()].push_back(newMessage);
-				++messagesReceived;
+			m_pendingConnections.resize(kept);
+		}
+
+		for (PendingConnection& connection : m_pendingConnections)
+		{
+			++connection.m_component->m_deferredTicks;
+		}
+	}
+
+	ReceiveTcpMessageSystem::FrameStatus ReceiveTcpMessageSystem::peekFrame(NetworkEcs* _ecs, EntityId _entityId,
+		const ReceiveTcpMessageComponent& _component, MessageHeader& _outHeader) const
+	{
+		const std::vector<uint8_t>& receivedBuffer = _component.m_receivedBuffer;
+		if (!MessageSerializer::readHeader(receivedBuffer, _component.m_readOffset, _outHeader))
+		{
+			return FrameStatus::Incomplete;
+		}
+
+		if (_outHeader.version != MESSAGE_HEADER_VERSION)
+		{
+			m_metrics.m_tcpProtocolErrors.add();
+			TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Unsupported frame version %u for entity %llu",
+				static_cast<unsigned int>(_outHeader.version), static_cast<unsigned long long>(_entityId));
+
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+			return FrameStatus::Invalid;
+		}
+
+		if (_outHeader.size > m_config.m_maxFrameSize || MESSAGE_HEADER_WIRE_SIZE + _outHeader.size > m_config.m_maxReceiveBufferSize)
+		{
+			m_metrics.m_tcpProtocolErrors.add();
+			TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Frame of %u bytes exceeds the limit for entity %llu, ErrorCode: %d",
+				_outHeader.size, static_cast<unsigned long long>(_entityId), static_cast<int>(ErrorCode::FrameSizeTooLarge));
+
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+			return FrameStatus::Invalid;
+		}
+
+		if ((_outHeader.flags & MessageFlagTimestamped) != 0 && _outHeader.size < MESSAGE_TIMESTAMP_WIRE_SIZE)
+		{
+			m_metrics.m_tcpProtocolErrors.add();
+			TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Timestamped frame of %u bytes is too short for entity %llu",
+				_outHeader.size, static_cast<unsigned long long>(_entityId));
+
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+			return FrameStatus::Invalid;
+		}
+
+		if (receivedBuffer.size() - _component.m_readOffset - MESSAGE_HEADER_WIRE_SIZE < _outHeader.size)
+		{
+			return FrameStatus::Incomplete;
+		}
+
+		if (_outHeader.sequence != _component.m_nextSequence)
+		{
+			m_metrics.m_tcpProtocolErrors.add();
+			TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Out of sequence frame for entity %llu, Expected: %u, Received: %u",
+				static_cast<unsigned long long>(_entityId), static_cast<unsigned int>(_component.m_nextSequence),
+				static_cast<unsigned int>(_outHeader.sequence));
+
+			TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+			return FrameStatus::Invalid;
+		}
+
+		return FrameStatus::Ready;
+	}
+
+	void ReceiveTcpMessageSystem::consumeFrame(EntityId _entityId, ReceiveTcpMessageComponent& _component, const MessageHeader& _header)
+	{
+		if (m_capture)
+		{
+			captureFrame(_entityId, _component, _header);
+		}
+
+		const uint8_t* payloadBegin = _component.m_receivedBuffer.data() + _component.m_readOffset + MESSAGE_HEADER_WIRE_SIZE;
+		size_t payloadSize = _header.size;
+
+		++_component.m_nextSequence;
+		_component.m_readOffset += MESSAGE_HEADER_WIRE_SIZE + _header.size;
+
+		bool timestamped = (_header.flags & MessageFlagTimestamped) != 0;
+		MessageTimestamp timestamp;
+		if (timestamped)
+		{
+			timestamp = MessageSerializer::readTimestamp(payloadBegin);
+			payloadBegin += MESSAGE_TIMESTAMP_WIRE_SIZE;
+			payloadSize -= MESSAGE_TIMESTAMP_WIRE_SIZE;
+
+			if (m_config.m_latencyTimestamps)
+			{
+				updateClockSkew(_component, timestamp);
 			}
 		}
+
+		// Any frame completes the handshake; heartbeats are only there to be one.
+		_component.m_frameReceived = true;
+		if (_header.typeId == message::TraHeartbeat::MESSAGE_TYPE_ID)
+		{
+			return;
+		}
+
+		if (!MessageFactory::isRegistered(_header.typeId))
+		{
+			TRA_DEBUG_LOG("ReceiveTcpMessageSystem::update: Skipping frame of unknown type %u for entity %llu",
+				_header.typeId, static_cast<unsigned long long>(_entityId));
+			return;
+		}
+
+		m_payload.assign(payloadBegin, payloadBegin + payloadSize);
+
+		std::shared_ptr<Message> newMessage = MessageSerializer::deserializePayload(_header.typeId, m_payload);
+		if (!newMessage)
+		{
+			++_component.m_deserializeFailures;
+			m_metrics.m_tcpDeserializeFailures.add();
+			TRA_ERROR_LOG("ReceiveTcpMessageSystem::update: Failed to deserialize message for entity %llu",
+				static_cast<unsigned long long>(_entityId));
+			return;
+		}
+
+		++_component.m_messagesReceived;
+		m_metrics.m_tcpMessagesReceived.add();
+
+		if (timestamped && m_config.m_latencyTimestamps)
+		{
+			recordLatency(_component, timestamp, *newMessage);
+		}
+
+		_component.m_receivedMessages[newMessage->getType()].push_back(newMessage);
+	}
+
+	void ReceiveTcpMessageSystem::captureFrame(EntityId _entityId, const ReceiveTcpMessageComponent& _component, const MessageHeader& _header)
+	{
+		const uint8_t* frame = _component.m_receivedBuffer.data() + _component.m_readOffset;
+		if (m_capture->record(_entityId, frame, MESSAGE_HEADER_WIRE_SIZE + _header.size, m_captureNowNs))
+		{
+			m_metrics.m_captureFrames.add();
+		}
+		else
+		{
+			m_metrics.m_captureDroppedFrames.add();
+		}
+	}
+
+	void ReceiveTcpMessageSystem::updateClockSkew(ReceiveTcpMessageComponent& _component, const MessageTimestamp& _timestamp)
+	{
+		uint64_t readNs = _component.m_lastReadNs;
+
+		// The echo is our own send time, so the round trip needs no skew:
+		// everything since we sent it, minus the time the peer held it.
+		if (_timestamp.echoNs != 0 && readNs >= _timestamp.echoNs + _timestamp.echoHoldNs)
+		{
+			uint64_t roundTripNs = readNs - _timestamp.echoNs - _timestamp.echoHoldNs;
+			int64_t offsetNs = static_cast<int64_t>(_timestamp.sendNs + roundTripNs / 2) - static_cast<int64_t>(readNs);
+			_component.m_clockSkew.addSample(roundTripNs, offsetNs);
+		}
+
+		if (_timestamp.sendNs > _component.m_echoPeerNs)
+		{
+			_component.m_echoPeerNs = _timestamp.sendNs;
+			_component.m_echoReadNs = readNs;
+		}
+	}
+
+	void ReceiveTcpMessageSystem::recordLatency(const ReceiveTcpMessageComponent& _component, const MessageTimestamp& _timestamp, const Message& _message)
+	{
+		uint64_t decodedNs = getLatencyClockNs();
+		uint64_t readNs = _component.m_lastReadNs;
+
+		m_metrics.m_latency.record(_message, LatencyTracker::Stage::Receive, decodedNs - (std::min)(readNs, decodedNs));
+
+		if (!_component.m_clockSkew.isSynchronized())
+		{
+			return;
+		}
+
+		// Estimation error can put a peer time slightly in our future; such
+		// samples are clamped to zero rather than dropped.
+		uint64_t sentNs = _component.m_clockSkew.toLocal(_timestamp.sendNs);
+		uint64_t enqueuedNs = sentNs - (std::min)(static_cast<uint64_t>(_timestamp.queuedNs), sentNs);
+
+		m_metrics.m_latency.record(_message, LatencyTracker::Stage::Network, readNs - (std::min)(sentNs, readNs));
+		m_metrics.m_latency.record(_message, LatencyTracker::Stage::EndToEnd, decodedNs - (std::min)(enqueuedNs, decodedNs));
 	}
-}
\ No newline at end of file
+}
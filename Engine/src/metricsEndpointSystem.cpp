@@ -0,0 +1,143 @@
+#include "metricsEndpointSystem.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "TRA/debugUtils.hpp"
+
+#include "TRA/core/metrics.hpp"
+
+#include "TRA/engine/networkEcs.hpp"
+
+#include "latencyTracker.hpp"
+
+namespace tra::engine
+{
+	namespace
+	{
+		constexpr uint32_t MAX_ACCEPTS_PER_TICK = 4;
+		constexpr size_t MAX_SCRAPE_CLIENTS = 16;
+		constexpr uint64_t SCRAPE_TIMEOUT_NS = 2'000'000'000;
+		constexpr size_t MAX_REQUEST_BYTES = 4096;
+
+		const char REQUEST_END[] = "\r\n\r\n";
+
+		void closeClient(MetricsScrapeClient& _client)
+		{
+			_client.m_tcpSocket->shutdownSocket();
+			_client.m_tcpSocket->closeSocket();
+			delete _client.m_tcpSocket;
+			_client.m_tcpSocket = nullptr;
+		}
+	}
+
+	void MetricsEndpointSystem::update(NetworkEcs* _ecs)
+	{
+		for (auto queryResult : _ecs->query<MetricsEndpointComponent>())
+		{
+			MetricsEndpointComponent& metricsEndpointComponent = *std::get<1>(queryResult);
+			uint64_t nowNs = getLatencyClockNs();
+
+			acceptClients(metricsEndpointComponent, nowNs);
+
+			std::vector<MetricsScrapeClient>& clients = metricsEndpointComponent.m_clients;
+			for (size_t i = 0; i < clients.size();)
+			{
+				bool open = nowNs < clients[i].m_deadlineNs && serve(clients[i]);
+				if (open)
+				{
+					i++;
+					continue;
+				}
+
+				if (clients[i].m_sentBytes < clients[i].m_response.size() || !clients[i].m_responding)
+				{
+					TRA_DEBUG_LOG("MetricsEndpointSystem::update: Scrape connection dropped after %zu of %zu bytes.",
+						clients[i].m_sentBytes, clients[i].m_response.size());
+				}
+
+				closeClient(clients[i]);
+				clients[i] = std::move(clients.back());
+				clients.pop_back();
+			}
+		}
+	}
+
+	void MetricsEndpointSystem::acceptClients(MetricsEndpointComponent& _component, uint64_t _nowNs)
+	{
+		for (uint32_t i = 0; i < MAX_ACCEPTS_PER_TICK && _component.m_clients.size() < MAX_SCRAPE_CLIENTS; i++)
+		{
+			core::TcpSocket* clientSocket = nullptr;
+			std::pair<ErrorCode, int> intPairResult = _component.m_tcpSocket->acceptSocket(&clientSocket, true);
+			if (intPairResult.first == ErrorCode::SocketWouldBlock)
+			{
+				break;
+			}
+			else if (intPairResult.first != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("MetricsEndpointSystem::update: Failed to accept scrape connection, ErrorCode: %d, Last socket error: %d",
+					static_cast<int>(intPairResult.first), intPairResult.second);
+				break;
+			}
+
+			MetricsScrapeClient client;
+			client.m_tcpSocket = clientSocket;
+			client.m_deadlineNs = _nowNs + SCRAPE_TIMEOUT_NS;
+			_component.m_clients.push_back(std::move(client));
+		}
+	}
+
+	bool MetricsEndpointSystem::serve(MetricsScrapeClient& _client)
+	{
+		std::pair<ErrorCode, int> intPairResult;
+
+		// The request itself is ignored, every path gets the metrics. Reading it
+		// first keeps the close from resetting the connection under the client.
+		if (!_client.m_responding)
+		{
+			size_t previousSize = _client.m_request.size();
+			intPairResult = _client.m_tcpSocket->receiveData(m_received, MAX_REQUEST_BYTES - previousSize);
+			_client.m_request.insert(_client.m_request.end(), m_received.begin(), m_received.end());
+
+			// A client that closes its side after the request is still answered.
+			bool peerClosed = intPairResult.first == ErrorCode::SocketConnectionClosed;
+			if ((intPairResult.first != ErrorCode::Success && !peerClosed) || (peerClosed && _client.m_request.empty()))
+			{
+				return false;
+			}
+
+			// The end of the headers may straddle two reads.
+			size_t searchFrom = previousSize >= 3 ? previousSize - 3 : 0;
+			auto requestEnd = std::search(_client.m_request.begin() + searchFrom, _client.m_request.end(), REQUEST_END, REQUEST_END + 4);
+			if (!peerClosed && requestEnd == _client.m_request.end() && _client.m_request.size() < MAX_REQUEST_BYTES)
+			{
+				return true;
+			}
+
+			core::MetricsSnapshot snapshot;
+			m_metrics.collect(snapshot);
+
+			_client.m_response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n";
+			_client.m_response += snapshot.toPrometheusText();
+			_client.m_responding = true;
+		}
+
+		while (_client.m_sentBytes < _client.m_response.size())
+		{
+			int byteSent = 0;
+			intPairResult = _client.m_tcpSocket->sendData(_client.m_response.data() + _client.m_sentBytes, _client.m_response.size() - _client.m_sentBytes, byteSent);
+			_client.m_sentBytes += static_cast<size_t>(byteSent);
+
+			if (intPairResult.first == ErrorCode::SocketWouldBlock)
+			{
+				return true;
+			}
+			else if (intPairResult.first != ErrorCode::Success && intPairResult.first != ErrorCode::SocketSendPartial)
+			{
+				return false;
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,152 @@
+#include "networkConditioner.hpp"
+
+#include <algorithm>
+
+namespace tra::engine
+{
+	namespace
+	{
+		constexpr uint64_t NS_PER_MS = 1000000;
+		constexpr uint64_t NS_PER_SECOND = 1000000000;
+
+		template<typename PacketType>
+		bool releasesLater(const PacketType& _left, const PacketType& _right)
+		{
+			return _left.m_releaseNs > _right.m_releaseNs || (_left.m_releaseNs == _right.m_releaseNs && _left.m_order > _right.m_order);
+		}
+	}
+
+	NetworkConditioner::NetworkConditioner(const NetworkConditionerConfig& _config, uint64_t _stream)
+		: m_config(_config), m_randomState(_config.m_seed ^ (_stream * 0x9e3779b97f4a7c15ull)),
+		m_linkFreeNs(0), m_lastReleaseNs(0), m_lastPushNs(0), m_nextOrder(0), m_queuedBytes(0)
+	{
+	}
+
+	void NetworkConditioner::pushStream(const std::vector<uint8_t>& _data, uint64_t _nowNs)
+	{
+		if (_data.empty())
+		{
+			return;
+		}
+
+		m_lastPushNs = _nowNs;
+
+		// Jitter may not reorder a byte stream, so nothing is released before
+		// what was pushed ahead of it.
+		uint64_t releaseNs = (std::max)(transmit(_data.size(), _nowNs, nextRandom()), m_lastReleaseNs);
+		m_lastReleaseNs = releaseNs;
+
+		Packet packet;
+		packet.m_releaseNs = releaseNs;
+		packet.m_data = _data;
+		m_stream.push_back(std::move(packet));
+		m_queuedBytes += _data.size();
+	}
+
+	void NetworkConditioner::popStream(std::vector<uint8_t>& _outData, size_t _maxBytes, uint64_t _nowNs)
+	{
+		while (!m_stream.empty() && _maxBytes > 0 && m_stream.front().m_releaseNs <= _nowNs)
+		{
+			Packet& packet = m_stream.front();
+			size_t count = (std::min)(packet.m_data.size() - packet.m_offset, _maxBytes);
+			_outData.insert(_outData.end(), packet.m_data.begin() + static_cast<std::ptrdiff_t>(packet.m_offset),
+				packet.m_data.begin() + static_cast<std::ptrdiff_t>(packet.m_offset + count));
+
+			packet.m_offset += count;
+			_maxBytes -= count;
+			m_queuedBytes -= count;
+
+			if (packet.m_offset == packet.m_data.size())
+			{
+				m_stream.pop_front();
+			}
+		}
+	}
+
+	uint32_t NetworkConditioner::pushDatagram(const uint8_t* _data, size_t _size, uint64_t _nowNs)
+	{
+		m_lastPushNs = _nowNs;
+
+		// Every datagram draws the same numbers whatever happens to it, so
+		// changing one rate leaves the other decisions of a seed unchanged.
+		double loss = nextUnit();
+		double duplicate = nextUnit();
+		double reorder = nextUnit();
+		uint64_t jitterRandom = nextRandom();
+		uint64_t duplicateJitterRandom = nextRandom();
+
+		if (loss < m_config.m_lossRate || getFreeBytes() < _size)
+		{
+			return 0;
+		}
+
+		uint64_t extraDelayNs = reorder < m_config.m_reorderRate ? m_config.m_reorderDelayMs * NS_PER_MS : 0;
+		queueDatagram(_data, _size, transmit(_size, _nowNs, jitterRandom) + extraDelayNs);
+
+		if (duplicate < m_config.m_duplicateRate && getFreeBytes() >= _size)
+		{
+			queueDatagram(_data, _size, transmit(_size, _nowNs, duplicateJitterRandom) + extraDelayNs);
+			return 2;
+		}
+
+		return 1;
+	}
+
+	bool NetworkConditioner::popDatagram(std::vector<uint8_t>& _outData, uint64_t _nowNs)
+	{
+		if (m_datagrams.empty() || m_datagrams.front().m_releaseNs > _nowNs)
+		{
+			return false;
+		}
+
+		std::pop_heap(m_datagrams.begin(), m_datagrams.end(), releasesLater<Packet>);
+		_outData = std::move(m_datagrams.back().m_data);
+		m_queuedBytes -= _outData.size();
+		m_datagrams.pop_back();
+		return true;
+	}
+
+	uint64_t NetworkConditioner::nextRandom()
+	{
+		uint64_t value = (m_randomState += 0x9e3779b97f4a7c15ull);
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return value ^ (value >> 31);
+	}
+
+	double NetworkConditioner::nextUnit()
+	{
+		return static_cast<double>(nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	uint64_t NetworkConditioner::transmit(size_t _size, uint64_t _nowNs, uint64_t _random)
+	{
+		uint64_t departureNs = (std::max)(_nowNs, m_linkFreeNs);
+		if (m_config.m_bandwidthBytesPerSecond != 0)
+		{
+			departureNs += static_cast<uint64_t>(_size) * NS_PER_SECOND / m_config.m_bandwidthBytesPerSecond;
+		}
+		m_linkFreeNs = departureNs;
+
+		int64_t delayNs = static_cast<int64_t>(m_config.m_delayMs * NS_PER_MS);
+		if (m_config.m_jitterMs != 0)
+		{
+			uint64_t jitterNs = m_config.m_jitterMs * NS_PER_MS;
+			delayNs += static_cast<int64_t>(_random % (2 * jitterNs + 1)) - static_cast<int64_t>(jitterNs);
+		}
+
+		return departureNs + static_cast<uint64_t>((std::max)(delayNs, static_cast<int64_t>(0)));
+	}
+
+	void NetworkConditioner::queueDatagram(const uint8_t* _data, size_t _size, uint64_t _releaseNs)
+	{
+		Packet packet;
+		packet.m_releaseNs = _releaseNs;
+		packet.m_order = m_nextOrder++;
+		packet.m_data.assign(_data, _data + _size);
+
+		m_datagrams.push_back(std::move(packet));
+		std::push_heap(m_datagrams.begin(), m_datagrams.end(), releasesLater<Packet>);
+		m_queuedBytes += _size;
+	}
+}
@@ -7,6 +7,11 @@
 
 namespace tra::engine
 {
+	NetworkEcs::NetworkEcs()
+	{
+		m_destroyEntitiesSlot = m_profiler.addSlot("DestroyEntities", TickPhase::EndUpdate);
+	}
+
 	EntityId NetworkEcs::createEntity()
 	{
 		EntityId newEntityId = m_nextEntityId++;
@@ -40,6 +45,7 @@ namespace tra::engine
 
 		m_registerBeginUpdateSystem.insert(_system);
 		m_beginUpdateSystems.push_back(_system);
+		m_beginUpdateSlots.push_back(m_profiler.addSlot(_system->getName(), TickPhase::BeginUpdate));
 
 		return;
 	}
@@ -54,25 +60,33 @@ namespace tra::engine
 
 		m_registerEndUpdateSystem.insert(_system);
 		m_endUpdateSystems.push_back(_system);
+		m_endUpdateSlots.push_back(m_profiler.addSlot(_system->getName(), TickPhase::EndUpdate));
 
 		return;
 	}
 
 	void NetworkEcs::beginUpdate()
 	{
+		ScopedTickTimer phaseTimer(m_profiler, TickProfiler::BEGIN_UPDATE_SLOT);
+
 		for (size_t i = 0; i < m_beginUpdateSystems.size(); i++)
 		{
+			ScopedTickTimer systemTimer(m_profiler, m_beginUpdateSlots[i]);
 			m_beginUpdateSystems[i]->update(this);
 		}
 	}
 
 	void NetworkEcs::endUpdate()
 	{
+		ScopedTickTimer phaseTimer(m_profiler, TickProfiler::END_UPDATE_SLOT);
+
 		for (size_t i = 0; i < m_endUpdateSystems.size(); i++)
 		{
+			ScopedTickTimer systemTimer(m_profiler, m_endUpdateSlots[i]);
 			m_endUpdateSystems[i]->update(this);
 		}
 
+		ScopedTickTimer destroyTimer(m_profiler, m_destroyEntitiesSlot);
 		for (auto entityId : queryIds<DestroyComponentTag>())
 		{
 			for (auto store : m_componentStores)
@@ -1,5 +1,7 @@
 #include "TRA/engine/networkEngine.hpp"
 
+#include <random>
+
 #include "TRA/debugUtils.hpp"
 #include "TRA/core/netUtils.hpp"
 #include "TRA/engine/message.hpp"
@@ -13,35 +15,49 @@
 
 #include "TRA/engine/networkRootComponentTag.hpp"
 #include "TRA/engine/connectionStatusComponent.hpp"
+#include "TRA/engine/newConnectionComponent.hpp"
 #include "socketComponent.hpp"
 #include "messageComponent.hpp"
+#include "messageSerializer.hpp"
+#include "udpComponent.hpp"
 #include "selfComponent.hpp"
+#include "migratedConnection.hpp"
+#include "engineMetrics.hpp"
+#include "metricsEndpointComponent.hpp"
+#include "trafficCaptureComponent.hpp"
+#include "udpSystem.hpp"
+#include "connectionTimeoutComponent.hpp"
+#include "connectionTimeoutSystem.hpp"
 
 namespace tra::engine
 {
-	NetworkEngine::NetworkEngine()
+	NetworkEngine::NetworkEngine(const NetworkEngineConfig& _config) : m_config(_config)
 	{
-		m_udpSocket = nullptr;
+		m_metricsRegistry = new core::MetricsRegistry();
+		m_metrics = new EngineMetrics(*m_metricsRegistry);
 
 		m_networkEcs = new NetworkEcs();
-		NetworkSystemRegistrar::registerNetworkSystems(m_networkEcs);
+		m_networkEcs->getProfiler().setEnabled(m_config.m_tickProfiling);
+		NetworkSystemRegistrar::registerNetworkSystems(m_networkEcs, m_config, *m_metrics);
 
 		m_selfEntityId = m_networkEcs->createEntity();
 		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, std::make_shared<SelfComponentTag>(), {});
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, std::make_shared<ConnectionTimersComponent>(), {});
 	}
 
 	NetworkEngine::~NetworkEngine()
 	{
-		delete m_udpSocket;
-
 		m_networkEcs->destroyEntity(m_selfEntityId);
 
 		delete m_networkEcs;
+
+		delete m_metrics;
+		delete m_metricsRegistry;
 	}
 
 	ErrorCode NetworkEngine::startTcpListenOnPort(uint16_t _port, bool _blocking)
 	{
-		if (m_networkEcs->hasComponent<TcpListenSocketComponent>(m_selfEntityId))
+		if (m_networkEcs->hasComponent<TcpListenSocketComponent>(m_selfEntityId) || m_networkEcs->hasComponent<TcpAcceptorPoolComponent>(m_selfEntityId))
 		{
 			TRA_ERROR_LOG("NetworkEngine: Start TCP listen on port callrd but TCP listen socket is already open.");
 			return ErrorCode::SocketAlreadyOpen;
@@ -63,12 +79,42 @@ namespace tra::engine
 		TRA_DEBUG_LOG("NetworkEngine: WSA initialized successfully.");
 #endif
 
+		if (m_config.m_tcpAcceptorThreads > 0)
+		{
+			std::shared_ptr<TcpAcceptorPoolComponent> tcpAcceptorPoolComponent = std::make_shared<TcpAcceptorPoolComponent>();
+			tcpAcceptorPoolComponent->m_acceptorPool = new TcpAcceptorPool();
+
+			ErrorCode startResult = tcpAcceptorPoolComponent->m_acceptorPool->start(_port, m_config.m_tcpAcceptorThreads);
+			if (startResult != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("NetworkEngine: Failed to start %u TCP acceptors on port %d. ErrorCode: %d", m_config.m_tcpAcceptorThreads, _port, static_cast<int>(startResult));
+				return startResult;
+			}
+
+			TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, tcpAcceptorPoolComponent, {
+				TRA_INFO_LOG("NetworkEngine: TCP listen socket was not listening on port %d.", _port);
+				stopTcpListen();
+				return ErrorCode::Failure;
+				}
+			);
+
+			TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, std::make_shared<ListeningComponentTag>(), {
+				TRA_INFO_LOG("NetworkEngine: TCP listen socket was not listening on port %d.", _port);
+				stopTcpListen();
+				return ErrorCode::Failure;
+				}
+			);
+
+			TRA_DEBUG_LOG("NetworkEngine: %u TCP acceptors started on port %d.", m_config.m_tcpAcceptorThreads, _port);
+			return ErrorCode::Success;
+		}
+
 		std::shared_ptr<TcpListenSocketComponent> tcpListenSocketComponent = std::make_shared<TcpListenSocketComponent>();
 		tcpListenSocketComponent->m_tcpSocket = new core::TcpSocket();
 
 		std::pair<ErrorCode, int> intPairResult;
 
-		intPairResult = tcpListenSocketComponent->m_tcpSocket->bindSocket(_port);
+		intPairResult = tcpListenSocketComponent->m_tcpSocket->bindSocket(_port, m_config.m_tcpReusePort);
 		if (intPairResult.first != ErrorCode::Success)
 		{
 			TRA_ERROR_LOG("NetworkEngine: Failed to bind TCP listen socket on port %d. ErrorCode: %d", _port, static_cast<int>(intPairResult.first));
@@ -163,6 +209,15 @@ namespace tra::engine
 			return intPairResult.first;
 		}
 
+		if (m_config.m_kernelTimestamps)
+		{
+			intPairResult = tcpSocketComponent->m_tcpSocket->setKernelTimestamping(true);
+			if (intPairResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("NetworkEngine: TCP kernel timestamps unavailable. Last socket error: %d", intPairResult.second);
+			}
+		}
+
 		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, tcpSocketComponent, {
 			TRA_INFO_LOG("NetworkEngine: TCP connect socket was not connected on port %d.", _port);
 			return ErrorCode::Failure;
@@ -199,13 +254,15 @@ namespace tra::engine
 			}
 		);
 
+		armConnectionTimeouts(m_networkEcs, m_config, *m_metrics, m_selfEntityId, m_selfEntityId, *sendMessageComponent);
+
 		TRA_DEBUG_LOG("NetworkEngine: TCP connect socket connected to %s:%d.", _address.c_str(), _port);
 		return ErrorCode::Success;
 	}
 
 	ErrorCode NetworkEngine::startUdpOnPort(uint16_t _port, bool _blocking)
 	{
-		if (m_udpSocket)
+		if (m_networkEcs->hasComponent<UdpSocketComponent>(m_selfEntityId))
 		{
 			TRA_ERROR_LOG("NetworkEngine: start UDP on port called but UDP socket is already open.");
 			return ErrorCode::SocketAlreadyOpen;
@@ -227,11 +284,12 @@ namespace tra::engine
 		TRA_DEBUG_LOG("NetworkEngine: WSA initialized successfully.");
 #endif
 
-		m_udpSocket = new core::UdpSocket();
+		std::shared_ptr<UdpSocketComponent> udpSocketComponent = std::make_shared<UdpSocketComponent>();
+		udpSocketComponent->m_udpSocket = new core::UdpSocket();
 
 		std::pair<ErrorCode, int> intPairResult;
 
-		intPairResult = m_udpSocket->bindSocket(_port);
+		intPairResult = udpSocketComponent->m_udpSocket->bindSocket(_port);
 		if (intPairResult.first != ErrorCode::Success)
 		{
 			TRA_ERROR_LOG("NetworkEngine: Failed to bind UDP socket on port %d. ErrorCode: %d", _port, static_cast<int>(intPairResult.first));
@@ -239,7 +297,7 @@ namespace tra::engine
 			return intPairResult.first;
 		}
 
-		intPairResult = m_udpSocket->setBlocking(_blocking);
+		intPairResult = udpSocketComponent->m_udpSocket->setBlocking(_blocking);
 		if (intPairResult.first != ErrorCode::Success)
 		{
 			TRA_ERROR_LOG("NetworkEngine: Failed to set UDP socket blocking mode. ErrorCode: %d", static_cast<int>(intPairResult.first));
@@ -247,9 +305,36 @@ namespace tra::engine
 			return intPairResult.first;
 		}
 
+		if (m_config.m_udpSegmentationOffload)
+		{
+			intPairResult = udpSocketComponent->m_udpSocket->setSegmentationOffload(true);
+			if (intPairResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("NetworkEngine: UDP segmentation offload unavailable, sending one datagram per slot. Last socket error: %d", intPairResult.second);
+			}
+		}
+
+		if (m_config.m_udpReceiveOffload)
+		{
+			intPairResult = udpSocketComponent->m_udpSocket->setReceiveOffload(true);
+			if (intPairResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("NetworkEngine: UDP receive offload unavailable. Last socket error: %d", intPairResult.second);
+			}
+		}
+
+		if (m_config.m_kernelTimestamps)
+		{
+			intPairResult = udpSocketComponent->m_udpSocket->setKernelTimestamping(true);
+			if (intPairResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("NetworkEngine: UDP kernel timestamps unavailable. Last socket error: %d", intPairResult.second);
+			}
+		}
+
 		if (_port == 0)
 		{
-			std::pair<ErrorCode, uint16_t> portResult = m_udpSocket->getPort();
+			std::pair<ErrorCode, uint16_t> portResult = udpSocketComponent->m_udpSocket->getPort();
 
 			if (portResult.first != ErrorCode::Success)
 			{
@@ -261,12 +346,52 @@ namespace tra::engine
 			_port = portResult.second;
 		}
 
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, udpSocketComponent, {
+			TRA_INFO_LOG("NetworkEngine: UDP socket was not started on port %d.", _port);
+			stopUdp();
+			return ErrorCode::Failure;
+			}
+		);
+
+		std::shared_ptr<UdpPeerTableComponent> udpPeerTableComponent = std::make_shared<UdpPeerTableComponent>();
+		std::random_device randomDevice;
+		for (uint64_t& key : udpPeerTableComponent->m_cookieKey)
+		{
+			key = (static_cast<uint64_t>(randomDevice()) << 32) | randomDevice();
+		}
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, udpPeerTableComponent, {
+			TRA_INFO_LOG("NetworkEngine: UDP socket was not started on port %d.", _port);
+			stopUdp();
+			return ErrorCode::Failure;
+			}
+		);
+
 		TRA_DEBUG_LOG("NetworkEngine: UDP socket started on port %d.", _port);
 		return ErrorCode::Success;
 	}
 
 	ErrorCode NetworkEngine::stopTcpListen()
 	{
+		if (m_networkEcs->hasComponent<TcpAcceptorPoolComponent>(m_selfEntityId))
+		{
+			m_networkEcs->removeComponentFromEntity<ListeningComponentTag>(m_selfEntityId);
+
+			ErrorCode removeResult = m_networkEcs->removeComponentFromEntity<TcpAcceptorPoolComponent>(m_selfEntityId);
+			if (removeResult != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("NetworkEngine: Failed to remove TcpAcceptorPoolComponent from self entity. ErrorCode: %d", static_cast<int>(removeResult));
+				return removeResult;
+			}
+
+#ifdef _WIN32
+			core::WSAInitializer::Get()->CleanUp();
+#endif
+
+			TRA_DEBUG_LOG("NetworkEngine: TCP acceptors stopped.");
+			return ErrorCode::Success;
+		}
+
 		if (!m_networkEcs->hasComponent<TcpListenSocketComponent>(m_selfEntityId))
 		{
 			TRA_DEBUG_LOG("NetworkEngine: Stop TCP listen called but TCP listen socket is not open.");
@@ -371,15 +496,31 @@ namespace tra::engine
 
 	ErrorCode NetworkEngine::stopUdp()
 	{
-		if (!m_udpSocket)
+		if (!m_networkEcs->hasComponent<UdpSocketComponent>(m_selfEntityId))
 		{
 			TRA_DEBUG_LOG("NetworkEngine: Stop UDP called but UDP socket is not open.");
 			return ErrorCode::Success;
 		}
 
-		m_udpSocket->closeSocket();
-		delete m_udpSocket;
-		m_udpSocket = nullptr;
+		for (EntityId entityId : m_networkEcs->queryIds<UdpConnectionComponent>())
+		{
+			m_networkEcs->removeComponentFromEntity<UdpConnectionComponent>(entityId);
+		}
+
+		ErrorCode removeResult;
+
+		removeResult = m_networkEcs->removeComponentFromEntity<UdpPeerTableComponent>(m_selfEntityId);
+		if (removeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to remove UdpPeerTableComponent from self entity. ErrorCode: %d", static_cast<int>(removeResult));
+		}
+
+		removeResult = m_networkEcs->removeComponentFromEntity<UdpSocketComponent>(m_selfEntityId);
+		if (removeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to remove UdpSocketComponent from self entity. ErrorCode: %d", static_cast<int>(removeResult));
+			return removeResult;
+		}
 
 #ifdef _WIN32
 		core::WSAInitializer::Get()->CleanUp();
@@ -426,8 +567,24 @@ namespace tra::engine
 			return ErrorCode::InvalidComponent;
 		}
 
-		sendTcpMessageComponent->m_messagesToSend.push_back(_message);
-		return ErrorCode::Success;
+		PendingTcpMessage pendingMessage{ _message, getLatencyClockNs() };
+
+		if (_message->isCoalescable())
+		{
+			CoalesceKey key{ _message->getTypeId(), _message->getCoalesceKey() };
+			auto it = sendTcpMessageComponent->m_pendingCoalesced.find(key);
+			if (it != sendTcpMessageComponent->m_pendingCoalesced.end())
+			{
+				sendTcpMessageComponent->m_messagesToSend[it->second] = std::move(pendingMessage);
+				return sendTcpMessageComponent->m_congested ? ErrorCode::SendQueueCongested : ErrorCode::Success;
+			}
+
+			sendTcpMessageComponent->m_pendingCoalesced.emplace(key, sendTcpMessageComponent->m_messagesToSend.size());
+		}
+
+		sendTcpMessageComponent->m_messagesToSend.push_back(std::move(pendingMessage));
+
+		return sendTcpMessageComponent->m_congested ? ErrorCode::SendQueueCongested : ErrorCode::Success;
 	}
 
 	std::vector<std::shared_ptr<Message>> NetworkEngine::getTcpMessages(EntityId _entityId, const std::string& _messageType)
@@ -465,8 +622,441 @@ namespace tra::engine
 		return messages;
 	}
 
+	std::pair<ErrorCode, ReceiveQueueDepth> NetworkEngine::getReceiveQueueDepth(EntityId _entityId)
+	{
+		auto getComponentResult = m_networkEcs->getComponentOfEntity<ReceiveTcpMessageComponent>(_entityId);
+		if (getComponentResult.first != ErrorCode::Success)
+		{
+			return { getComponentResult.first, ReceiveQueueDepth() };
+		}
+
+		auto receiveTcpMessageComponent = getComponentResult.second.lock();
+		if (!receiveTcpMessageComponent)
+		{
+			return { ErrorCode::InvalidComponent, ReceiveQueueDepth() };
+		}
+
+		ReceiveQueueDepth depth;
+		depth.m_bufferedBytes = receiveTcpMessageComponent->m_receivedBuffer.size() - receiveTcpMessageComponent->m_readOffset;
+		depth.m_deficit = receiveTcpMessageComponent->m_deficit;
+		depth.m_deferredTicks = receiveTcpMessageComponent->m_deferredTicks;
+
+		return { ErrorCode::Success, depth };
+	}
+
+	std::pair<ErrorCode, ConnectionStats> NetworkEngine::getConnectionStats(EntityId _entityId)
+	{
+		auto getSendComponentResult = m_networkEcs->getComponentOfEntity<SendTcpMessageComponent>(_entityId);
+		if (getSendComponentResult.first != ErrorCode::Success)
+		{
+			return { getSendComponentResult.first, ConnectionStats() };
+		}
+
+		auto getReceiveComponentResult = m_networkEcs->getComponentOfEntity<ReceiveTcpMessageComponent>(_entityId);
+		if (getReceiveComponentResult.first != ErrorCode::Success)
+		{
+			return { getReceiveComponentResult.first, ConnectionStats() };
+		}
+
+		auto sendTcpMessageComponent = getSendComponentResult.second.lock();
+		auto receiveTcpMessageComponent = getReceiveComponentResult.second.lock();
+		if (!sendTcpMessageComponent || !receiveTcpMessageComponent)
+		{
+			return { ErrorCode::InvalidComponent, ConnectionStats() };
+		}
+
+		ConnectionStats stats;
+		stats.m_bytesSent = sendTcpMessageComponent->m_bytesSent;
+		stats.m_bytesReceived = receiveTcpMessageComponent->m_bytesReceived;
+		stats.m_messagesSent = sendTcpMessageComponent->m_messagesSent;
+		stats.m_messagesReceived = receiveTcpMessageComponent->m_messagesReceived;
+		stats.m_partialSends = sendTcpMessageComponent->m_partialSends;
+		stats.m_deserializeFailures = receiveTcpMessageComponent->m_deserializeFailures;
+		stats.m_sendQueueBytes = sendTcpMessageComponent->m_queuedBytes;
+		stats.m_receiveBufferedBytes = receiveTcpMessageComponent->m_receivedBuffer.size() - receiveTcpMessageComponent->m_readOffset;
+		stats.m_clockSynchronized = receiveTcpMessageComponent->m_clockSkew.isSynchronized();
+		stats.m_clockOffsetNs = receiveTcpMessageComponent->m_clockSkew.getOffsetNs();
+		stats.m_roundTripNs = receiveTcpMessageComponent->m_clockSkew.getRoundTripNs();
+		stats.m_kernelSendDelayNs = sendTcpMessageComponent->m_kernelSendDelayNs;
+		stats.m_wireRoundTripNs = sendTcpMessageComponent->m_wireRoundTripNs;
+		stats.m_kernelReceiveDelayNs = receiveTcpMessageComponent->m_kernelReceiveDelayNs;
+
+		return { ErrorCode::Success, stats };
+	}
+
+	ErrorCode NetworkEngine::sendUdpMessage(EntityId _entityId, std::shared_ptr<Message> _message, UdpChannel _channel)
+	{
+		auto getComponentResult = m_networkEcs->getComponentOfEntity<UdpConnectionComponent>(_entityId);
+		if (getComponentResult.first != ErrorCode::Success)
+		{
+			return ErrorCode::UdpNotConnected;
+		}
+
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent)
+		{
+			TRA_ERROR_LOG("NetworkEngine: UdpConnectionComponent for entity %I32u is no longer valid.", _entityId);
+			return ErrorCode::InvalidComponent;
+		}
+
+		if (!udpConnectionComponent->m_bound && _channel != UdpChannel::ReliableOrdered)
+		{
+			return ErrorCode::UdpNotConnected;
+		}
+
+		UdpQueuedMessage queuedMessage;
+		queuedMessage.m_channel = _channel;
+		queuedMessage.m_typeId = _message->getTypeId();
+		queuedMessage.m_payload = MessageSerializer::serializePayload(*_message);
+		if (UDP_DATA_HEADER_SIZE + UDP_ENTRY_HEADER_SIZE + queuedMessage.m_payload.size() > m_config.m_udpMaxPacketSize)
+		{
+			TRA_ERROR_LOG("NetworkEngine: UDP message of %llu bytes for entity %I32u does not fit in a datagram.",
+				static_cast<unsigned long long>(queuedMessage.m_payload.size()), _entityId);
+			return ErrorCode::UdpMessageTooLarge;
+		}
+
+		udpConnectionComponent->m_messagesToSend.push_back(std::move(queuedMessage));
+		return ErrorCode::Success;
+	}
+
+	std::vector<std::shared_ptr<Message>> NetworkEngine::getUdpMessages(EntityId _entityId, const std::string& _messageType)
+	{
+		auto getComponentResult = m_networkEcs->getComponentOfEntity<UdpConnectionComponent>(_entityId);
+		if (getComponentResult.first != ErrorCode::Success)
+		{
+			return {};
+		}
+
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent)
+		{
+			return {};
+		}
+
+		auto it = udpConnectionComponent->m_receivedMessages.find(_messageType);
+		if (it == udpConnectionComponent->m_receivedMessages.end())
+		{
+			return {};
+		}
+
+		return it->second;
+	}
+
+	bool NetworkEngine::isUdpConnected(EntityId _entityId)
+	{
+		auto getComponentResult = m_networkEcs->getComponentOfEntity<UdpConnectionComponent>(_entityId);
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+
+		return udpConnectionComponent && udpConnectionComponent->m_bound;
+	}
+
+	std::pair<ErrorCode, std::shared_ptr<MigratedConnection>> NetworkEngine::detachConnection(EntityId _entityId)
+	{
+		if (_entityId == m_selfEntityId || !m_networkEcs->hasComponent<ConnectedComponentTag>(_entityId))
+		{
+			TRA_ERROR_LOG("NetworkEngine: Cannot detach entity %I32u, it is not a connected peer.", _entityId);
+			return { ErrorCode::InvalidEntity, nullptr };
+		}
+
+		std::shared_ptr<TcpConnectSocketComponent> tcpSocketComponent = m_networkEcs->getComponentOfEntity<TcpConnectSocketComponent>(_entityId).second.lock();
+		std::shared_ptr<SendTcpMessageComponent> sendTcpMessageComponent = m_networkEcs->getComponentOfEntity<SendTcpMessageComponent>(_entityId).second.lock();
+		std::shared_ptr<ReceiveTcpMessageComponent> receiveTcpMessageComponent = m_networkEcs->getComponentOfEntity<ReceiveTcpMessageComponent>(_entityId).second.lock();
+		if (!tcpSocketComponent || !tcpSocketComponent->m_tcpSocket || !sendTcpMessageComponent || !receiveTcpMessageComponent)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Cannot detach entity %I32u, its TCP components are missing.", _entityId);
+			return { ErrorCode::InvalidComponent, nullptr };
+		}
+
+		std::shared_ptr<MigratedConnection> connection = std::make_shared<MigratedConnection>();
+		connection->m_tcpSocket = tcpSocketComponent->m_tcpSocket;
+		connection->m_sendMessageComponent = sendTcpMessageComponent;
+		connection->m_receiveMessageComponent = receiveTcpMessageComponent;
+		tcpSocketComponent->m_tcpSocket = nullptr;
+
+		// Messages decoded this tick were already handed out here; only the
+		// undecoded bytes move on.
+		receiveTcpMessageComponent->m_receivedMessages.clear();
+
+		// Destruction is deferred to the end of the tick, so strip the shared
+		// components now to keep this engine's systems away from them.
+		releaseUdpConnection(m_networkEcs, _entityId);
+		m_networkEcs->removeComponentFromEntity<TcpConnectSocketComponent>(_entityId);
+		m_networkEcs->removeComponentFromEntity<SendTcpMessageComponent>(_entityId);
+		m_networkEcs->removeComponentFromEntity<ReceiveTcpMessageComponent>(_entityId);
+		m_networkEcs->removeComponentFromEntity<ConnectedComponentTag>(_entityId);
+		m_networkEcs->destroyEntity(_entityId);
+
+		TRA_DEBUG_LOG("NetworkEngine: Detached connection entity %I32u.", _entityId);
+		return { ErrorCode::Success, connection };
+	}
+
+	std::pair<ErrorCode, EntityId> NetworkEngine::attachConnection(std::shared_ptr<MigratedConnection> _connection)
+	{
+		if (!_connection || !_connection->m_tcpSocket || !_connection->m_sendMessageComponent || !_connection->m_receiveMessageComponent)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Cannot attach an empty migrated connection.");
+			return { ErrorCode::InvalidComponent, 0 };
+		}
+
+		EntityId newEntityId = m_networkEcs->createEntity();
+
+		std::shared_ptr<TcpConnectSocketComponent> tcpSocketComponent = std::make_shared<TcpConnectSocketComponent>();
+		tcpSocketComponent->m_tcpSocket = _connection->m_tcpSocket;
+		_connection->m_tcpSocket = nullptr;
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, newEntityId, std::make_shared<NetworkRootComponentTag>(), {
+			m_networkEcs->destroyEntity(newEntityId);
+			return std::make_pair(ErrorCode::Failure, EntityId(0));
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, newEntityId, tcpSocketComponent, {
+			m_networkEcs->destroyEntity(newEntityId);
+			return std::make_pair(ErrorCode::Failure, EntityId(0));
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, newEntityId, _connection->m_receiveMessageComponent, {
+			m_networkEcs->destroyEntity(newEntityId);
+			return std::make_pair(ErrorCode::Failure, EntityId(0));
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, newEntityId, _connection->m_sendMessageComponent, {
+			m_networkEcs->destroyEntity(newEntityId);
+			return std::make_pair(ErrorCode::Failure, EntityId(0));
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, newEntityId, std::make_shared<NewConnectionComponentTag>(), {
+			m_networkEcs->destroyEntity(newEntityId);
+			return std::make_pair(ErrorCode::Failure, EntityId(0));
+			});
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, newEntityId, std::make_shared<ConnectedComponentTag>(), {
+			m_networkEcs->destroyEntity(newEntityId);
+			return std::make_pair(ErrorCode::Failure, EntityId(0));
+			});
+
+		issueUdpHandshake(m_networkEcs, m_selfEntityId, newEntityId, *_connection->m_sendMessageComponent);
+		armConnectionTimeouts(m_networkEcs, m_config, *m_metrics, m_selfEntityId, newEntityId, *_connection->m_sendMessageComponent);
+
+		TRA_DEBUG_LOG("NetworkEngine: Attached migrated connection as entity %I32u.", newEntityId);
+		return { ErrorCode::Success, newEntityId };
+	}
+
+	core::MetricsSnapshot NetworkEngine::getMetricsSnapshot()
+	{
+		core::MetricsSnapshot snapshot;
+		m_metrics->collect(snapshot);
+		return snapshot;
+	}
+
+	ErrorCode NetworkEngine::dumpMetrics(const std::string& _path)
+	{
+		TRA_ASSERT_REF_PTR_OR_COPIABLE(_path);
+
+		ErrorCode writeResult = getMetricsSnapshot().writeToFile(_path);
+		if (writeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to write metrics to %s. ErrorCode: %d", _path.c_str(), static_cast<int>(writeResult));
+		}
+
+		return writeResult;
+	}
+
+	ErrorCode NetworkEngine::startMetricsEndpoint(uint16_t _port)
+	{
+		if (m_networkEcs->hasComponent<MetricsEndpointComponent>(m_selfEntityId))
+		{
+			TRA_ERROR_LOG("NetworkEngine: Start metrics endpoint called but the metrics endpoint is already open.");
+			return ErrorCode::SocketAlreadyOpen;
+		}
+
+		if (!core::NetUtils::isValidPort(_port))
+		{
+			TRA_ERROR_LOG("NetworkEngine: Invalid port number %d for metrics endpoint.", _port);
+			return ErrorCode::InvalidPortNumber;
+		}
+
+#ifdef _WIN32
+		ErrorCode errorCode = core::WSAInitializer::Get()->Init();
+		if (errorCode != ErrorCode::Success)
+		{
+			return errorCode;
+		}
+#endif
+
+		std::shared_ptr<MetricsEndpointComponent> metricsEndpointComponent = std::make_shared<MetricsEndpointComponent>();
+		metricsEndpointComponent->m_tcpSocket = new core::TcpSocket();
+
+		std::pair<ErrorCode, int> intPairResult;
+
+		intPairResult = metricsEndpointComponent->m_tcpSocket->bindSocket(_port, false, true);
+		if (intPairResult.first != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to bind metrics endpoint on port %d. ErrorCode: %d", _port, static_cast<int>(intPairResult.first));
+			return intPairResult.first;
+		}
+
+		intPairResult = metricsEndpointComponent->m_tcpSocket->listenSocket();
+		if (intPairResult.first != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to listen on metrics endpoint. ErrorCode: %d", static_cast<int>(intPairResult.first));
+			return intPairResult.first;
+		}
+
+		intPairResult = metricsEndpointComponent->m_tcpSocket->setBlocking(false);
+		if (intPairResult.first != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to set metrics endpoint blocking mode. ErrorCode: %d", static_cast<int>(intPairResult.first));
+			return intPairResult.first;
+		}
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, metricsEndpointComponent, {
+			TRA_INFO_LOG("NetworkEngine: Metrics endpoint was not started on port %d.", _port);
+			return ErrorCode::Failure;
+			}
+		);
+
+		TRA_DEBUG_LOG("NetworkEngine: Metrics endpoint started on 127.0.0.1:%d.", _port);
+		return ErrorCode::Success;
+	}
+
+	ErrorCode NetworkEngine::stopMetricsEndpoint()
+	{
+		if (!m_networkEcs->hasComponent<MetricsEndpointComponent>(m_selfEntityId))
+		{
+			TRA_DEBUG_LOG("NetworkEngine: Stop metrics endpoint called but the metrics endpoint is not open.");
+			return ErrorCode::Success;
+		}
+
+		ErrorCode removeResult = m_networkEcs->removeComponentFromEntity<MetricsEndpointComponent>(m_selfEntityId);
+		if (removeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to remove MetricsEndpointComponent from self entity. ErrorCode: %d", static_cast<int>(removeResult));
+			return removeResult;
+		}
+
+#ifdef _WIN32
+		core::WSAInitializer::Get()->CleanUp();
+#endif
+
+		TRA_DEBUG_LOG("NetworkEngine: Metrics endpoint stopped.");
+		return ErrorCode::Success;
+	}
+
+	std::vector<MessageLatency> NetworkEngine::getMessageLatencies() const
+	{
+		return m_metrics->m_latency.getLatencies();
+	}
+
+	void NetworkEngine::resetMessageLatencies()
+	{
+		m_metrics->m_latency.reset();
+	}
+
+	std::vector<SystemTiming> NetworkEngine::getTickProfile() const
+	{
+		return m_networkEcs->getProfiler().getTimings();
+	}
+
+	void NetworkEngine::startTickTrace(size_t _maxEvents)
+	{
+		if (!m_config.m_tickProfiling)
+		{
+			TRA_INFO_LOG("NetworkEngine: Tick trace started but tick profiling is disabled, no spans will be captured.");
+		}
+
+		m_networkEcs->getProfiler().startTrace(_maxEvents);
+	}
+
+	void NetworkEngine::stopTickTrace()
+	{
+		m_networkEcs->getProfiler().stopTrace();
+	}
+
+	ErrorCode NetworkEngine::writeTickTrace(const std::string& _path) const
+	{
+		TRA_ASSERT_REF_PTR_OR_COPIABLE(_path);
+
+		ErrorCode writeResult = m_networkEcs->getProfiler().writeChromeTrace(_path);
+		if (writeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to write tick trace to %s. ErrorCode: %d", _path.c_str(), static_cast<int>(writeResult));
+		}
+
+		return writeResult;
+	}
+
+	ErrorCode NetworkEngine::startCapture(const std::string& _path)
+	{
+		TRA_ASSERT_REF_PTR_OR_COPIABLE(_path);
+
+		if (m_networkEcs->hasComponent<TrafficCaptureComponent>(m_selfEntityId))
+		{
+			TRA_ERROR_LOG("NetworkEngine: Traffic capture is already running. ErrorCode: %d", static_cast<int>(ErrorCode::CaptureAlreadyRunning));
+			return ErrorCode::CaptureAlreadyRunning;
+		}
+
+		std::shared_ptr<TrafficCaptureComponent> trafficCaptureComponent = std::make_shared<TrafficCaptureComponent>();
+		trafficCaptureComponent->m_writer = std::make_unique<TrafficCaptureWriter>();
+
+		ErrorCode openResult = trafficCaptureComponent->m_writer->open(_path, m_config.m_captureMaxQueuedBytes);
+		if (openResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to open traffic capture %s. ErrorCode: %d", _path.c_str(), static_cast<int>(openResult));
+			return openResult;
+		}
+
+		TRA_ENTITY_ADD_COMPONENT(m_networkEcs, m_selfEntityId, trafficCaptureComponent, {
+			TRA_INFO_LOG("NetworkEngine: Traffic capture was not started.");
+			return ErrorCode::Failure;
+			}
+		);
+
+		TRA_DEBUG_LOG("NetworkEngine: Traffic capture started to %s.", _path.c_str());
+		return ErrorCode::Success;
+	}
+
+	ErrorCode NetworkEngine::stopCapture()
+	{
+		auto queryResult = m_networkEcs->query<TrafficCaptureComponent>();
+		if (queryResult.empty())
+		{
+			TRA_DEBUG_LOG("NetworkEngine: Stop capture called but no traffic capture is running.");
+			return ErrorCode::Success;
+		}
+
+		// Closed here rather than by the component so a failed write is reported.
+		ErrorCode closeResult = std::get<1>(queryResult.front())->m_writer->close();
+
+		ErrorCode removeResult = m_networkEcs->removeComponentFromEntity<TrafficCaptureComponent>(m_selfEntityId);
+		if (removeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Failed to remove TrafficCaptureComponent from self entity. ErrorCode: %d", static_cast<int>(removeResult));
+			return removeResult;
+		}
+
+		if (closeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("NetworkEngine: Traffic capture was incomplete. ErrorCode: %d", static_cast<int>(closeResult));
+			return closeResult;
+		}
+
+		TRA_DEBUG_LOG("NetworkEngine: Traffic capture stopped.");
+		return ErrorCode::Success;
+	}
+
 	EntityId NetworkEngine::getSelfEntityId()
 	{
 		return m_selfEntityId;
 	}
+
+	const NetworkEngineConfig& NetworkEngine::getConfig() const
+	{
+		return m_config;
+	}
+
+	void NetworkEngine::setConfig(const NetworkEngineConfig& _config)
+	{
+		m_config = _config;
+		m_networkEcs->getProfiler().setEnabled(m_config.m_tickProfiling);
+	}
 }
\ No newline at end of file
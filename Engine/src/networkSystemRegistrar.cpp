@@ -4,20 +4,28 @@
 
 #include "acceptConnectionSystem.hpp"
 #include "messageSystem.hpp"
+#include "udpSystem.hpp"
 #include "pendingDisconnectSystem.hpp"
 #include "disconnectSystem.hpp"
+#include "connectionTimeoutSystem.hpp"
+#include "metricsEndpointSystem.hpp"
 
 namespace tra::engine
 {
-	void NetworkSystemRegistrar::registerNetworkSystems(NetworkEcs* _networkEcs)
+	void NetworkSystemRegistrar::registerNetworkSystems(NetworkEcs* _networkEcs, const NetworkEngineConfig& _config, EngineMetrics& _metrics)
 	{
 		// BeginUpdate
 		_networkEcs->registerBeginUpdateSystem(std::make_unique<DisconnectSystem>());
 		_networkEcs->registerBeginUpdateSystem(std::make_unique<PendingDisconnectSystem>());
-		_networkEcs->registerBeginUpdateSystem(std::make_unique<AcceptConnectionSystem>());
-		_networkEcs->registerBeginUpdateSystem(std::make_unique<ReceiveTcpMessageSystem>());
+		_networkEcs->registerBeginUpdateSystem(std::make_unique<AcceptConnectionSystem>(_config, _metrics));
+		_networkEcs->registerBeginUpdateSystem(std::make_unique<ReceiveTcpMessageSystem>(_config, _metrics));
+		_networkEcs->registerBeginUpdateSystem(std::make_unique<ConnectionTimeoutSystem>(_config, _metrics));
+		_networkEcs->registerBeginUpdateSystem(std::make_unique<UdpHandshakeSystem>(_config));
+		_networkEcs->registerBeginUpdateSystem(std::make_unique<ReceiveUdpMessageSystem>(_config, _metrics));
+		_networkEcs->registerBeginUpdateSystem(std::make_unique<MetricsEndpointSystem>(_metrics));
 
 		// EndUpdate
-		_networkEcs->registerEndUpdateSystem(std::make_shared<SendTcpMessageSystem>());
+		_networkEcs->registerEndUpdateSystem(std::make_shared<SendTcpMessageSystem>(_config, _metrics));
+		_networkEcs->registerEndUpdateSystem(std::make_shared<SendUdpMessageSystem>(_config));
 	}
 }
\ No newline at end of file
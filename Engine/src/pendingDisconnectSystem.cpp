@@ -8,6 +8,8 @@
 #include "pendingDisconnectComponent.hpp"
 #include "socketComponent.hpp"
 #include "messageComponent.hpp"
+#include "udpComponent.hpp"
+#include "udpSystem.hpp"
 
 namespace tra::engine
 {
@@ -48,6 +50,11 @@ namespace tra::engine
 					entityId, static_cast<int>(removeResult));
 			}
 
+			if (_ecs->hasComponent<UdpConnectionComponent>(entityId))
+			{
+				releaseUdpConnection(_ecs, entityId);
+			}
+
 			removeResult = _ecs->removeComponentFromEntity<ConnectedComponentTag>(entityId);
 			if (removeResult != ErrorCode::Success)
 			{
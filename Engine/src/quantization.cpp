@@ -0,0 +1,132 @@
+#include "TRA/engine/quantization.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace tra::engine
+{
+	namespace
+	{
+		constexpr float SMALLEST_THREE_RANGE = 0.70710678118f;
+		constexpr float MAX_STEPS = 18446744073709551616.0f;
+
+		uint64_t quantizationSteps(float _min, float _max, float _precision)
+		{
+			if (_max <= _min || _precision <= 0.0f)
+			{
+				return 0;
+			}
+
+			// More steps than a uint64_t holds cannot be encoded at all.
+			float steps = std::ceil((_max - _min) / _precision);
+			if (!(steps < MAX_STEPS))
+			{
+				return 0;
+			}
+
+			return static_cast<uint64_t>(steps);
+		}
+	}
+
+	uint32_t Quantization::bitsRequired(uint64_t _maxValue)
+	{
+		uint32_t bits = 0;
+		while (_maxValue > 0)
+		{
+			++bits;
+			_maxValue >>= 1;
+		}
+
+		return bits;
+	}
+
+	uint64_t Quantization::quantizeFloat(float _value, float _min, float _max, float _precision)
+	{
+		uint64_t steps = quantizationSteps(_min, _max, _precision);
+		if (steps == 0 || !(_value > _min))
+		{
+			return 0;
+		}
+
+		float scaled = std::round((std::min(_value, _max) - _min) / _precision);
+		return std::min(static_cast<uint64_t>(scaled), steps);
+	}
+
+	float Quantization::dequantizeFloat(uint64_t _value, float _min, float _max, float _precision)
+	{
+		return std::min(_min + static_cast<float>(_value) * _precision, _max);
+	}
+
+	uint32_t Quantization::quantizedFloatBits(float _min, float _max, float _precision)
+	{
+		return bitsRequired(quantizationSteps(_min, _max, _precision));
+	}
+
+	uint64_t Quantization::encodeQuaternion(const Quaternion& _value, uint32_t _componentBits)
+	{
+		if (_componentBits == 0 || _componentBits > MAX_QUATERNION_COMPONENT_BITS)
+		{
+			return 0;
+		}
+
+		float components[4] = { _value.x, _value.y, _value.z, _value.w };
+
+		uint32_t largest = 0;
+		for (uint32_t i = 1; i < 4; i++)
+		{
+			if (std::fabs(components[i]) > std::fabs(components[largest]))
+			{
+				largest = i;
+			}
+		}
+
+		float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+		float precision = 2.0f * SMALLEST_THREE_RANGE / static_cast<float>((1ull << _componentBits) - 1);
+
+		uint64_t encoded = largest;
+		uint32_t shift = 2;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+
+			encoded |= quantizeFloat(components[i] * sign, -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, precision) << shift;
+			shift += _componentBits;
+		}
+
+		return encoded;
+	}
+
+	Quaternion Quantization::decodeQuaternion(uint64_t _value, uint32_t _componentBits)
+	{
+		if (_componentBits == 0 || _componentBits > MAX_QUATERNION_COMPONENT_BITS)
+		{
+			return {};
+		}
+
+		float components[4] = {};
+		float precision = 2.0f * SMALLEST_THREE_RANGE / static_cast<float>((1ull << _componentBits) - 1);
+		uint64_t mask = (1ull << _componentBits) - 1;
+
+		uint32_t largest = static_cast<uint32_t>(_value & 3u);
+		uint32_t shift = 2;
+		float sumOfSquares = 0.0f;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+
+			components[i] = dequantizeFloat((_value >> shift) & mask, -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, precision);
+			sumOfSquares += components[i] * components[i];
+			shift += _componentBits;
+		}
+
+		components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+
+		return { components[0], components[1], components[2], components[3] };
+	}
+}
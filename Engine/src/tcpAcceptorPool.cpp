@@ -0,0 +1,152 @@
+#include "tcpAcceptorPool.hpp"
+
+#include <chrono>
+
+#include "TRA/debugUtils.hpp"
+
+namespace tra::engine
+{
+	TcpAcceptorPool::~TcpAcceptorPool()
+	{
+		stop();
+	}
+
+	ErrorCode TcpAcceptorPool::start(uint16_t _port, uint32_t _threadCount)
+	{
+		if (!m_listenSockets.empty())
+		{
+			return ErrorCode::SocketAlreadyOpen;
+		}
+
+		std::pair<ErrorCode, int> intPairResult;
+
+		for (uint32_t i = 0; i < _threadCount; i++)
+		{
+			core::TcpSocket* listenSocket = new core::TcpSocket();
+			m_listenSockets.push_back(listenSocket);
+
+			intPairResult = listenSocket->bindSocket(_port, true);
+			if (intPairResult.first != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("TcpAcceptorPool: Failed to bind listen socket %u on port %d. ErrorCode: %d, Last socket error: %d",
+					i, _port, static_cast<int>(intPairResult.first), intPairResult.second);
+				stop();
+				return intPairResult.first;
+			}
+
+			// Port 0 picks an ephemeral port for the first socket; the others must share it.
+			if (_port == 0)
+			{
+				_port = listenSocket->getPort().second;
+			}
+
+			intPairResult = listenSocket->listenSocket();
+			if (intPairResult.first == ErrorCode::Success)
+			{
+				intPairResult = listenSocket->setBlocking(false);
+			}
+
+			if (intPairResult.first != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("TcpAcceptorPool: Failed to listen on socket %u. ErrorCode: %d, Last socket error: %d",
+					i, static_cast<int>(intPairResult.first), intPairResult.second);
+				stop();
+				return intPairResult.first;
+			}
+		}
+
+		m_running = true;
+		for (core::TcpSocket* listenSocket : m_listenSockets)
+		{
+			m_threads.emplace_back(&TcpAcceptorPool::run, this, listenSocket);
+		}
+
+		return ErrorCode::Success;
+	}
+
+	void TcpAcceptorPool::stop()
+	{
+		m_running = false;
+
+		for (std::thread& thread : m_threads)
+		{
+			if (thread.joinable())
+			{
+				thread.join();
+			}
+		}
+		m_threads.clear();
+
+		for (core::TcpSocket* listenSocket : m_listenSockets)
+		{
+			listenSocket->shutdownSocket();
+			listenSocket->closeSocket();
+			delete listenSocket;
+		}
+		m_listenSockets.clear();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (core::TcpSocket* acceptedSocket : m_acceptedSockets)
+		{
+			acceptedSocket->closeSocket();
+			delete acceptedSocket;
+		}
+		m_acceptedSockets.clear();
+	}
+
+	size_t TcpAcceptorPool::drain(std::vector<core::TcpSocket*>& _outSockets, size_t _maxSockets)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		size_t count = 0;
+		while (count < _maxSockets && !m_acceptedSockets.empty())
+		{
+			_outSockets.push_back(m_acceptedSockets.front());
+			m_acceptedSockets.pop_front();
+			++count;
+		}
+
+		return count;
+	}
+
+	void TcpAcceptorPool::run(core::TcpSocket* _listenSocket)
+	{
+		core::TcpSocket* clientSocket = nullptr;
+
+		while (m_running)
+		{
+			std::pair<ErrorCode, int> waitResult = _listenSocket->waitReadable(WAIT_TIMEOUT_MS);
+			if (waitResult.first != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("TcpAcceptorPool: Failed to wait on listen socket. ErrorCode: %d, Last socket error: %d",
+					static_cast<int>(waitResult.first), waitResult.second);
+				break;
+			}
+
+			if (waitResult.second == 0)
+			{
+				continue;
+			}
+
+			while (m_running)
+			{
+				clientSocket = nullptr;
+				std::pair<ErrorCode, int> acceptResult = _listenSocket->acceptSocket(&clientSocket, true);
+				if (acceptResult.first == ErrorCode::SocketWouldBlock)
+				{
+					break;
+				}
+				else if (acceptResult.first != ErrorCode::Success)
+				{
+					TRA_ERROR_LOG("TcpAcceptorPool: Failed to accept new connection. ErrorCode: %d, Last socket error: %d",
+						static_cast<int>(acceptResult.first), acceptResult.second);
+					std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_TIMEOUT_MS));
+					break;
+				}
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_acceptedSockets.push_back(clientSocket);
+			}
+		}
+	}
+}
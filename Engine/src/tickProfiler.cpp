@@ -0,0 +1,143 @@
+#include "TRA/engine/tickProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace tra::engine
+{
+	namespace
+	{
+		const char* phaseName(TickPhase _phase)
+		{
+			return _phase == TickPhase::BeginUpdate ? "beginUpdate" : "endUpdate";
+		}
+
+		uint64_t percentile(std::vector<uint64_t>& _sorted, double _fraction)
+		{
+			size_t index = static_cast<size_t>(_fraction * static_cast<double>(_sorted.size() - 1) + 0.5);
+			return _sorted[index];
+		}
+
+		void appendMicroseconds(std::string& _out, uint64_t _ns)
+		{
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "%llu.%03llu", static_cast<unsigned long long>(_ns / 1000), static_cast<unsigned long long>(_ns % 1000));
+			_out += buffer;
+		}
+	}
+
+	TickProfiler::TickProfiler()
+		: m_enabled(true), m_tracing(false), m_maxTraceEvents(0), m_traceStartNs(0)
+	{
+		addSlot("beginUpdate", TickPhase::BeginUpdate);
+		addSlot("endUpdate", TickPhase::EndUpdate);
+	}
+
+	size_t TickProfiler::addSlot(const char* _name, TickPhase _phase)
+	{
+		Slot slot;
+		slot.m_name = _name;
+		slot.m_phase = _phase;
+		slot.m_window.assign(WINDOW_SIZE, 0);
+
+		m_slots.push_back(std::move(slot));
+		return m_slots.size() - 1;
+	}
+
+	void TickProfiler::record(size_t _slot, uint64_t _startNs, uint64_t _endNs)
+	{
+		Slot& slot = m_slots[_slot];
+		uint64_t duration = _endNs - _startNs;
+
+		slot.m_window[slot.m_samples % WINDOW_SIZE] = duration;
+		slot.m_samples++;
+
+		if (m_tracing && m_traceEvents.size() < m_maxTraceEvents)
+		{
+			m_traceEvents.push_back({ static_cast<uint32_t>(_slot), _startNs, duration });
+		}
+	}
+
+	std::vector<SystemTiming> TickProfiler::getTimings() const
+	{
+		std::vector<SystemTiming> timings;
+		timings.reserve(m_slots.size());
+
+		std::vector<uint64_t> sorted;
+		for (const Slot& slot : m_slots)
+		{
+			SystemTiming timing;
+			timing.m_name = slot.m_name;
+			timing.m_phase = slot.m_phase;
+			timing.m_samples = slot.m_samples;
+
+			if (slot.m_samples > 0)
+			{
+				size_t count = static_cast<size_t>((std::min)(slot.m_samples, static_cast<uint64_t>(WINDOW_SIZE)));
+				timing.m_lastNs = slot.m_window[(slot.m_samples - 1) % WINDOW_SIZE];
+
+				sorted.assign(slot.m_window.begin(), slot.m_window.begin() + count);
+				std::sort(sorted.begin(), sorted.end());
+				timing.m_p50Ns = percentile(sorted, 0.50);
+				timing.m_p99Ns = percentile(sorted, 0.99);
+				timing.m_maxNs = sorted.back();
+			}
+
+			timings.push_back(std::move(timing));
+		}
+
+		return timings;
+	}
+
+	void TickProfiler::startTrace(size_t _maxEvents)
+	{
+		m_traceEvents.clear();
+		m_traceEvents.reserve(_maxEvents);
+		m_maxTraceEvents = _maxEvents;
+		m_traceStartNs = now();
+		m_tracing = true;
+	}
+
+	void TickProfiler::stopTrace()
+	{
+		m_tracing = false;
+	}
+
+	ErrorCode TickProfiler::writeChromeTrace(const std::string& _path) const
+	{
+		std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+		json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"NetworkEcs\"}}";
+
+		for (const TraceEvent& event : m_traceEvents)
+		{
+			const Slot& slot = m_slots[event.m_slot];
+
+			json += ",\n{\"name\":\"";
+			json += slot.m_name;
+			json += "\",\"cat\":\"";
+			json += phaseName(slot.m_phase);
+			json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":";
+			appendMicroseconds(json, event.m_startNs >= m_traceStartNs ? event.m_startNs - m_traceStartNs : 0);
+			json += ",\"dur\":";
+			appendMicroseconds(json, event.m_durationNs);
+			json += '}';
+		}
+
+		json += "\n]}\n";
+
+		std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return ErrorCode::TickTraceWriteFailed;
+		}
+
+		file.write(json.data(), static_cast<std::streamsize>(json.size()));
+		if (!file)
+		{
+			return ErrorCode::TickTraceWriteFailed;
+		}
+
+		return ErrorCode::Success;
+	}
+}
@@ -0,0 +1,175 @@
+#include "timerWheel.hpp"
+
+#include <algorithm>
+
+namespace tra::engine
+{
+	namespace
+	{
+		constexpr uint64_t WHEEL_SPAN_TICKS = 1ull << (TimerWheel::LEVEL_BITS * TimerWheel::LEVELS);
+	}
+
+	TimerWheel::TimerWheel(uint64_t _resolutionNs, uint64_t _nowNs)
+		: m_resolutionNs(_resolutionNs > 0 ? _resolutionNs : 1), m_startNs(_nowNs), m_nextTick(0), m_freeList(INVALID_TIMER), m_size(0)
+	{
+		m_slots.fill(INVALID_TIMER);
+	}
+
+	TimerWheel::TimerId TimerWheel::schedule(uint64_t _deadlineNs, uint64_t _payload)
+	{
+		TimerId timer = m_freeList;
+		if (timer != INVALID_TIMER)
+		{
+			m_freeList = m_nodes[timer].m_next;
+		}
+		else
+		{
+			timer = static_cast<TimerId>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+
+		Node& node = m_nodes[timer];
+		// Rounded up, so a timer never fires before its deadline.
+		node.m_deadlineTick = _deadlineNs > m_startNs ? (_deadlineNs - m_startNs + m_resolutionNs - 1) / m_resolutionNs : 0;
+		node.m_payload = _payload;
+		node.m_active = true;
+
+		link(timer);
+		++m_size;
+		return timer;
+	}
+
+	void TimerWheel::cancel(TimerId _timer)
+	{
+		if (_timer >= m_nodes.size() || !m_nodes[_timer].m_active)
+		{
+			return;
+		}
+
+		unlink(_timer);
+
+		Node& node = m_nodes[_timer];
+		node.m_active = false;
+		node.m_next = m_freeList;
+		m_freeList = _timer;
+		--m_size;
+	}
+
+	void TimerWheel::advance(uint64_t _nowNs, std::vector<uint64_t>& _outExpired)
+	{
+		uint64_t targetTick = toTick(_nowNs);
+
+		if (m_size == 0)
+		{
+			m_nextTick = (std::max)(m_nextTick, targetTick + 1);
+			return;
+		}
+
+		while (m_nextTick <= targetTick)
+		{
+			// Entering a new turn of a level pulls the matching slot of the
+			// level above down, and so on while those wrap as well.
+			if ((m_nextTick & (SLOTS - 1)) == 0)
+			{
+				for (uint32_t level = 1; level < LEVELS && cascade(level) == 0; level++)
+				{
+				}
+			}
+
+			uint32_t slot = static_cast<uint32_t>(m_nextTick & (SLOTS - 1));
+			TimerId timer = m_slots[slot];
+			m_slots[slot] = INVALID_TIMER;
+
+			while (timer != INVALID_TIMER)
+			{
+				Node& node = m_nodes[timer];
+				TimerId next = node.m_next;
+
+				_outExpired.push_back(node.m_payload);
+
+				node.m_active = false;
+				node.m_next = m_freeList;
+				m_freeList = timer;
+				--m_size;
+
+				timer = next;
+			}
+
+			++m_nextTick;
+		}
+	}
+
+	uint64_t TimerWheel::toTick(uint64_t _ns) const
+	{
+		return _ns > m_startNs ? (_ns - m_startNs) / m_resolutionNs : 0;
+	}
+
+	void TimerWheel::link(TimerId _timer)
+	{
+		Node& node = m_nodes[_timer];
+
+		uint32_t level = 0;
+		uint64_t slotTick = m_nextTick;
+		if (node.m_deadlineTick >= m_nextTick)
+		{
+			uint64_t delta = node.m_deadlineTick - m_nextTick;
+			if (delta >= WHEEL_SPAN_TICKS)
+			{
+				node.m_deadlineTick = m_nextTick + WHEEL_SPAN_TICKS - 1;
+				delta = WHEEL_SPAN_TICKS - 1;
+			}
+
+			while (level + 1 < LEVELS && delta >= (1ull << (LEVEL_BITS * (level + 1))))
+			{
+				++level;
+			}
+
+			slotTick = node.m_deadlineTick;
+		}
+
+		node.m_slot = level * SLOTS + static_cast<uint32_t>((slotTick >> (LEVEL_BITS * level)) & (SLOTS - 1));
+		node.m_prev = INVALID_TIMER;
+		node.m_next = m_slots[node.m_slot];
+		if (node.m_next != INVALID_TIMER)
+		{
+			m_nodes[node.m_next].m_prev = _timer;
+		}
+		m_slots[node.m_slot] = _timer;
+	}
+
+	void TimerWheel::unlink(TimerId _timer)
+	{
+		Node& node = m_nodes[_timer];
+		if (node.m_prev != INVALID_TIMER)
+		{
+			m_nodes[node.m_prev].m_next = node.m_next;
+		}
+		else
+		{
+			m_slots[node.m_slot] = node.m_next;
+		}
+
+		if (node.m_next != INVALID_TIMER)
+		{
+			m_nodes[node.m_next].m_prev = node.m_prev;
+		}
+	}
+
+	uint32_t TimerWheel::cascade(uint32_t _level)
+	{
+		uint32_t index = static_cast<uint32_t>((m_nextTick >> (LEVEL_BITS * _level)) & (SLOTS - 1));
+		uint32_t slot = _level * SLOTS + index;
+
+		TimerId timer = m_slots[slot];
+		m_slots[slot] = INVALID_TIMER;
+
+		while (timer != INVALID_TIMER)
+		{
+			TimerId next = m_nodes[timer].m_next;
+			link(timer);
+			timer = next;
+		}
+
+		return index;
+	}
+}
@@ -0,0 +1,341 @@
+#include "trafficCapture.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "TRA/debugUtils.hpp"
+#include "TRA/engine/endian.hpp"
+#include "TRA/engine/varint.hpp"
+
+#include "latencyTracker.hpp"
+
+namespace tra::engine
+{
+	namespace
+	{
+		constexpr size_t INITIAL_FILE_CAPACITY = 16 * 1024 * 1024;
+		constexpr size_t MAX_FILE_GROWTH = 256 * 1024 * 1024;
+		constexpr size_t MAX_SPARE_CHUNKS = 4;
+	}
+
+	TrafficCaptureWriter::TrafficCaptureWriter()
+		: m_startNs(0), m_maxQueuedBytes(0), m_stopping(false), m_queuedBytes(0), m_failed(false),
+#ifdef _WIN32
+		m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr),
+#else
+		m_file(-1),
+#endif
+		m_map(nullptr), m_capacity(0), m_length(0)
+	{
+	}
+
+	TrafficCaptureWriter::~TrafficCaptureWriter()
+	{
+		close();
+	}
+
+	ErrorCode TrafficCaptureWriter::open(const std::string& _path, size_t _maxQueuedBytes)
+	{
+#ifdef _WIN32
+		m_file = CreateFileA(_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+		{
+			return ErrorCode::CaptureOpenFailed;
+		}
+#else
+		m_file = ::open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (m_file < 0)
+		{
+			return ErrorCode::CaptureOpenFailed;
+		}
+#endif
+
+		if (!reserve(INITIAL_FILE_CAPACITY))
+		{
+			close();
+			return ErrorCode::CaptureOpenFailed;
+		}
+
+		uint64_t startUnixNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+
+		std::memcpy(m_map, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+		Endian::storeLittle<uint32_t>(m_map + 8, CAPTURE_VERSION);
+		Endian::storeLittle<uint32_t>(m_map + 12, 0);
+		Endian::storeLittle<uint64_t>(m_map + 16, startUnixNs);
+		m_length = CAPTURE_FILE_HEADER_SIZE;
+
+		m_startNs = getLatencyClockNs();
+		m_maxQueuedBytes = _maxQueuedBytes;
+		m_stopping = false;
+		m_queuedBytes = 0;
+		m_failed = false;
+
+		m_thread = std::thread(&TrafficCaptureWriter::run, this);
+		return ErrorCode::Success;
+	}
+
+	ErrorCode TrafficCaptureWriter::close()
+	{
+		if (m_thread.joinable())
+		{
+			flush();
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stopping = true;
+			}
+
+			m_wake.notify_one();
+			m_thread.join();
+		}
+
+		unmapFile();
+
+		bool truncated = true;
+#ifdef _WIN32
+		if (m_file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER length;
+			length.QuadPart = static_cast<LONGLONG>(m_length);
+			truncated = SetFilePointerEx(m_file, length, nullptr, FILE_BEGIN) && SetEndOfFile(m_file);
+			CloseHandle(m_file);
+			m_file = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (m_file >= 0)
+		{
+			truncated = ftruncate(m_file, static_cast<off_t>(m_length)) == 0;
+			::close(m_file);
+			m_file = -1;
+		}
+#endif
+
+		m_capacity = 0;
+		return !truncated || m_failed ? ErrorCode::CaptureWriteFailed : ErrorCode::Success;
+	}
+
+	bool TrafficCaptureWriter::record(EntityId _entityId, const uint8_t* _frame, size_t _size, uint64_t _nowNs)
+	{
+		if (m_failed.load(std::memory_order_relaxed)
+			|| m_queuedBytes.load(std::memory_order_relaxed) + m_chunk.size() + _size + 3 * internal::MAX_VARINT_SIZE > m_maxQueuedBytes)
+		{
+			return false;
+		}
+
+		internal::writeVarint(m_chunk, _nowNs > m_startNs ? _nowNs - m_startNs : 0);
+		internal::writeVarint(m_chunk, _entityId);
+		internal::writeVarint(m_chunk, _size);
+		m_chunk.insert(m_chunk.end(), _frame, _frame + _size);
+		return true;
+	}
+
+	void TrafficCaptureWriter::flush()
+	{
+		if (m_chunk.empty())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_queuedBytes += m_chunk.size();
+			m_pending.push_back(std::move(m_chunk));
+
+			m_chunk.clear();
+			if (!m_spareChunks.empty())
+			{
+				m_chunk = std::move(m_spareChunks.back());
+				m_spareChunks.pop_back();
+			}
+		}
+
+		m_wake.notify_one();
+	}
+
+	void TrafficCaptureWriter::run()
+	{
+		std::vector<uint8_t> chunk;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if (!chunk.empty())
+				{
+					chunk.clear();
+					if (m_spareChunks.size() < MAX_SPARE_CHUNKS)
+					{
+						m_spareChunks.push_back(std::move(chunk));
+					}
+				}
+
+				m_wake.wait(lock, [this]() { return m_stopping || !m_pending.empty(); });
+				if (m_pending.empty())
+				{
+					return;
+				}
+
+				chunk = std::move(m_pending.front());
+				m_pending.pop_front();
+			}
+
+			if (!m_failed && reserve(m_length + chunk.size()))
+			{
+				std::memcpy(m_map + m_length, chunk.data(), chunk.size());
+				m_length += chunk.size();
+			}
+			else
+			{
+				m_failed = true;
+			}
+
+			m_queuedBytes -= chunk.size();
+		}
+	}
+
+	bool TrafficCaptureWriter::reserve(size_t _length)
+	{
+		if (_length <= m_capacity)
+		{
+			return true;
+		}
+
+		size_t capacity = (std::max)(m_capacity, INITIAL_FILE_CAPACITY);
+		while (capacity < _length)
+		{
+			capacity += (std::min)(capacity, MAX_FILE_GROWTH);
+		}
+
+		unmapFile();
+		if (!mapFile(capacity))
+		{
+			TRA_ERROR_LOG("TrafficCaptureWriter::reserve: Failed to grow the capture file to %llu bytes, ErrorCode: %d",
+				static_cast<unsigned long long>(capacity), static_cast<int>(ErrorCode::CaptureWriteFailed));
+			return false;
+		}
+
+		return true;
+	}
+
+	bool TrafficCaptureWriter::mapFile(size_t _capacity)
+	{
+#ifdef _WIN32
+		ULARGE_INTEGER size;
+		size.QuadPart = _capacity;
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+		if (!m_mapping)
+		{
+			return false;
+		}
+
+		m_map = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, _capacity));
+		if (!m_map)
+		{
+			CloseHandle(m_mapping);
+			m_mapping = nullptr;
+			return false;
+		}
+#else
+		if (ftruncate(m_file, static_cast<off_t>(_capacity)) != 0)
+		{
+			return false;
+		}
+
+		void* map = mmap(nullptr, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+		if (map == MAP_FAILED)
+		{
+			return false;
+		}
+
+		m_map = static_cast<uint8_t*>(map);
+#endif
+
+		m_capacity = _capacity;
+		return true;
+	}
+
+	void TrafficCaptureWriter::unmapFile()
+	{
+		if (!m_map)
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		UnmapViewOfFile(m_map);
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+#else
+		munmap(m_map, m_capacity);
+#endif
+
+		m_map = nullptr;
+	}
+
+	TrafficCaptureReader::TrafficCaptureReader() : m_offset(0), m_startUnixNs(0)
+	{
+	}
+
+	ErrorCode TrafficCaptureReader::open(const std::string& _path)
+	{
+		std::ifstream file(_path, std::ios::binary);
+		if (!file)
+		{
+			return ErrorCode::CaptureOpenFailed;
+		}
+
+		m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		if (m_data.size() < CAPTURE_FILE_HEADER_SIZE || std::memcmp(m_data.data(), CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0
+			|| Endian::loadLittle<uint32_t>(m_data.data() + 8) != CAPTURE_VERSION)
+		{
+			m_data.clear();
+			return ErrorCode::CaptureInvalidFormat;
+		}
+
+		m_startUnixNs = Endian::loadLittle<uint64_t>(m_data.data() + 16);
+		m_offset = CAPTURE_FILE_HEADER_SIZE;
+		return ErrorCode::Success;
+	}
+
+	bool TrafficCaptureReader::next(CaptureRecord& _outRecord)
+	{
+		size_t offset = m_offset;
+
+		try
+		{
+			_outRecord.m_timestampNs = internal::readVarint(m_data, offset);
+			_outRecord.m_entityId = static_cast<EntityId>(internal::readVarint(m_data, offset));
+			_outRecord.m_size = static_cast<size_t>(internal::readVarint(m_data, offset));
+		}
+		catch (const std::runtime_error&)
+		{
+			return false;
+		}
+
+		if (_outRecord.m_size == 0 || _outRecord.m_size > m_data.size() - offset)
+		{
+			return false;
+		}
+
+		_outRecord.m_frame = m_data.data() + offset;
+		m_offset = offset + _outRecord.m_size;
+		return true;
+	}
+
+	void TrafficCaptureReader::rewind()
+	{
+		m_offset = m_data.empty() ? 0 : CAPTURE_FILE_HEADER_SIZE;
+	}
+}
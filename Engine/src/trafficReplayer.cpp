@@ -0,0 +1,206 @@
+#include "TRA/engine/trafficReplayer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "TRA/debugUtils.hpp"
+#include "TRA/engine/endian.hpp"
+#include "TRA/engine/networkEcsUtils.hpp"
+
+#include "messageSystem.hpp"
+#include "messageComponent.hpp"
+#include "pendingDisconnectComponent.hpp"
+#include "engineMetrics.hpp"
+#include "trafficCapture.hpp"
+
+namespace tra::engine
+{
+	TrafficReplayer::TrafficReplayer(const NetworkEngineConfig& _config)
+		: m_config(_config), m_hasRecord(false), m_firstTickNs(0), m_replayStartNs(0)
+	{
+		m_metricsRegistry = new core::MetricsRegistry();
+		m_metrics = new EngineMetrics(*m_metricsRegistry);
+		m_networkEcs = new NetworkEcs();
+		m_receiveSystem = new ReceiveTcpMessageSystem(m_config, *m_metrics);
+		m_reader = new TrafficCaptureReader();
+		m_record = new CaptureRecord();
+	}
+
+	TrafficReplayer::~TrafficReplayer()
+	{
+		destroyConnections();
+
+		delete m_record;
+		delete m_reader;
+		delete m_receiveSystem;
+		delete m_networkEcs;
+
+		delete m_metrics;
+		delete m_metricsRegistry;
+	}
+
+	ErrorCode TrafficReplayer::open(const std::string& _path)
+	{
+		TRA_ASSERT_REF_PTR_OR_COPIABLE(_path);
+
+		ErrorCode openResult = m_reader->open(_path);
+		if (openResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("TrafficReplayer: Failed to open capture %s. ErrorCode: %d", _path.c_str(), static_cast<int>(openResult));
+			return openResult;
+		}
+
+		rewind();
+		return ErrorCode::Success;
+	}
+
+	bool TrafficReplayer::step(ReplaySpeed _speed)
+	{
+		if (!m_hasRecord && !m_receiveSystem->hasPendingFrames())
+		{
+			return false;
+		}
+
+		if (m_hasRecord)
+		{
+			uint64_t tickNs = m_record->m_timestampNs;
+			if (m_stats.m_ticks == 0)
+			{
+				m_firstTickNs = tickNs;
+				m_replayStartNs = getLatencyClockNs();
+			}
+
+			if (_speed == ReplaySpeed::Original)
+			{
+				uint64_t dueNs = m_replayStartNs + (tickNs - (std::min)(m_firstTickNs, tickNs));
+				uint64_t nowNs = getLatencyClockNs();
+				if (dueNs > nowNs)
+				{
+					std::this_thread::sleep_for(std::chrono::nanoseconds(dueNs - nowNs));
+				}
+			}
+
+			// Frames of one capture tick share its timestamp.
+			do
+			{
+				feedRecord();
+				m_hasRecord = m_reader->next(*m_record);
+			} while (m_hasRecord && m_record->m_timestampNs == tickNs);
+
+			m_stats.m_captureNs = tickNs - (std::min)(m_firstTickNs, tickNs);
+		}
+
+		uint64_t messagesBefore = m_metrics->m_tcpMessagesReceived.read();
+		uint64_t decodeStartNs = getLatencyClockNs();
+
+		m_receiveSystem->decodeBuffered(m_networkEcs);
+
+		m_stats.m_decodeNs += getLatencyClockNs() - decodeStartNs;
+		m_stats.m_messages += m_metrics->m_tcpMessagesReceived.read() - messagesBefore;
+		++m_stats.m_ticks;
+		return true;
+	}
+
+	void TrafficReplayer::rewind()
+	{
+		destroyConnections();
+
+		m_reader->rewind();
+		m_hasRecord = m_reader->next(*m_record);
+		m_firstTickNs = 0;
+		m_replayStartNs = 0;
+		m_stats = ReplayStats();
+
+		// Drops what the last pass left pending in the receive system.
+		m_receiveSystem->decodeBuffered(m_networkEcs);
+	}
+
+	std::vector<EntityId> TrafficReplayer::getConnectionIds() const
+	{
+		return m_connectionIds;
+	}
+
+	std::vector<std::shared_ptr<Message>> TrafficReplayer::getTcpMessages(EntityId _entityId, const std::string& _messageType)
+	{
+		if (!m_networkEcs->hasComponent<ReceiveTcpMessageComponent>(_entityId))
+		{
+			return {};
+		}
+
+		auto receiveTcpMessageComponent = m_networkEcs->getComponentOfEntity<ReceiveTcpMessageComponent>(_entityId).second.lock();
+		if (!receiveTcpMessageComponent)
+		{
+			return {};
+		}
+
+		auto it = receiveTcpMessageComponent->m_receivedMessages.find(_messageType);
+		if (it == receiveTcpMessageComponent->m_receivedMessages.end())
+		{
+			return {};
+		}
+
+		return it->second;
+	}
+
+	const ReplayStats& TrafficReplayer::getStats() const
+	{
+		return m_stats;
+	}
+
+	core::MetricsSnapshot TrafficReplayer::getMetricsSnapshot()
+	{
+		core::MetricsSnapshot snapshot;
+		m_metrics->collect(snapshot);
+		return snapshot;
+	}
+
+	void TrafficReplayer::feedRecord()
+	{
+		uint16_t sequence = Endian::loadLittle<uint16_t>(m_record->m_frame + MESSAGE_HEADER_SEQUENCE_OFFSET);
+
+		// A captured entity id can be reused by a later connection, and frames
+		// the writer dropped leave a gap; either way the sequence no longer
+		// follows on, which the decoder would reject as a protocol error.
+		auto it = m_connections.find(m_record->m_entityId);
+		if (it == m_connections.end() || it->second.m_nextSequence != sequence
+			|| m_networkEcs->hasComponent<PendingDisconnectComponentTag>(it->second.m_entityId))
+		{
+			ReplayConnection connection;
+			connection.m_entityId = m_networkEcs->createEntity();
+			connection.m_component = std::make_shared<ReceiveTcpMessageComponent>();
+			connection.m_component->m_nextSequence = sequence;
+
+			TRA_ENTITY_ADD_COMPONENT(m_networkEcs, connection.m_entityId, connection.m_component, {
+				m_networkEcs->destroyEntity(connection.m_entityId);
+				return;
+				}
+			);
+
+			m_connectionIds.push_back(connection.m_entityId);
+			++m_stats.m_connections;
+			it = m_connections.insert_or_assign(m_record->m_entityId, std::move(connection)).first;
+		}
+
+		std::vector<uint8_t>& receivedBuffer = it->second.m_component->m_receivedBuffer;
+		receivedBuffer.insert(receivedBuffer.end(), m_record->m_frame, m_record->m_frame + m_record->m_size);
+		it->second.m_nextSequence = static_cast<uint16_t>(sequence + 1);
+
+		++m_stats.m_frames;
+		m_stats.m_bytes += m_record->m_size;
+	}
+
+	void TrafficReplayer::destroyConnections()
+	{
+		for (EntityId entityId : m_connectionIds)
+		{
+			m_networkEcs->destroyEntity(entityId);
+		}
+
+		// No systems are registered, so this only removes the entities.
+		m_networkEcs->endUpdate();
+
+		m_connections.clear();
+		m_connectionIds.clear();
+	}
+}
@@ -0,0 +1,158 @@
+#include "udpPeerTable.hpp"
+
+#include <utility>
+
+namespace tra::engine
+{
+	UdpPeerTable::UdpPeerTable()
+	{
+		m_hashes.assign(INITIAL_CAPACITY, 0);
+		m_entries.resize(INITIAL_CAPACITY);
+		m_mask = INITIAL_CAPACITY - 1;
+		m_size = 0;
+		m_lastHit = NO_SLOT;
+	}
+
+	bool UdpPeerTable::find(const core::SocketAddress& _address, EntityId& _outEntityId)
+	{
+		if (m_lastHit != NO_SLOT && m_hashes[m_lastHit] != 0 && m_entries[m_lastHit].m_address == _address)
+		{
+			_outEntityId = m_entries[m_lastHit].m_entityId;
+			return true;
+		}
+
+		size_t slot = findSlot(_address, hashOf(_address));
+		if (slot == NO_SLOT)
+		{
+			return false;
+		}
+
+		m_lastHit = slot;
+		_outEntityId = m_entries[slot].m_entityId;
+		return true;
+	}
+
+	void UdpPeerTable::insert(const core::SocketAddress& _address, EntityId _entityId)
+	{
+		uint64_t hash = hashOf(_address);
+
+		size_t slot = findSlot(_address, hash);
+		if (slot != NO_SLOT)
+		{
+			m_entries[slot].m_entityId = _entityId;
+			return;
+		}
+
+		if ((m_size + 1) * 2 > m_hashes.size())
+		{
+			grow();
+		}
+
+		slot = static_cast<size_t>(hash) & m_mask;
+		while (m_hashes[slot] != 0)
+		{
+			slot = (slot + 1) & m_mask;
+		}
+
+		m_hashes[slot] = hash;
+		m_entries[slot].m_address = _address;
+		m_entries[slot].m_entityId = _entityId;
+		++m_size;
+	}
+
+	bool UdpPeerTable::erase(const core::SocketAddress& _address)
+	{
+		size_t slot = findSlot(_address, hashOf(_address));
+		if (slot == NO_SLOT)
+		{
+			return false;
+		}
+
+		m_hashes[slot] = 0;
+		--m_size;
+		m_lastHit = NO_SLOT;
+
+		// Pull later members of the probe run back into the hole so lookups never
+		// stop early on an empty slot.
+		size_t hole = slot;
+		size_t next = (hole + 1) & m_mask;
+		while (m_hashes[next] != 0)
+		{
+			size_t home = static_cast<size_t>(m_hashes[next]) & m_mask;
+			if (((next - home) & m_mask) >= ((next - hole) & m_mask))
+			{
+				m_hashes[hole] = m_hashes[next];
+				m_entries[hole] = std::move(m_entries[next]);
+				m_hashes[next] = 0;
+				hole = next;
+			}
+
+			next = (next + 1) & m_mask;
+		}
+
+		return true;
+	}
+
+	void UdpPeerTable::clear()
+	{
+		m_hashes.assign(m_hashes.size(), 0);
+		m_size = 0;
+		m_lastHit = NO_SLOT;
+	}
+
+	size_t UdpPeerTable::size() const
+	{
+		return m_size;
+	}
+
+	uint64_t UdpPeerTable::hashOf(const core::SocketAddress& _address)
+	{
+		return static_cast<uint64_t>(_address.hash()) | (1ull << 63);
+	}
+
+	size_t UdpPeerTable::findSlot(const core::SocketAddress& _address, uint64_t _hash) const
+	{
+		size_t slot = static_cast<size_t>(_hash) & m_mask;
+		while (m_hashes[slot] != 0)
+		{
+			if (m_hashes[slot] == _hash && m_entries[slot].m_address == _address)
+			{
+				return slot;
+			}
+
+			slot = (slot + 1) & m_mask;
+		}
+
+		return NO_SLOT;
+	}
+
+	void UdpPeerTable::grow()
+	{
+		std::vector<uint64_t> oldHashes = std::move(m_hashes);
+		std::vector<Entry> oldEntries = std::move(m_entries);
+
+		size_t capacity = oldHashes.size() * 2;
+		m_hashes.assign(capacity, 0);
+		m_entries.clear();
+		m_entries.resize(capacity);
+		m_mask = capacity - 1;
+		m_lastHit = NO_SLOT;
+
+		for (size_t i = 0; i < oldHashes.size(); i++)
+		{
+			if (oldHashes[i] == 0)
+			{
+				continue;
+			}
+
+			size_t slot = static_cast<size_t>(oldHashes[i]) & m_mask;
+			while (m_hashes[slot] != 0)
+			{
+				slot = (slot + 1) & m_mask;
+			}
+
+			m_hashes[slot] = oldHashes[i];
+			m_entries[slot] = std::move(oldEntries[i]);
+		}
+	}
+}
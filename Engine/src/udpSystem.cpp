@@ -0,0 +1,1063 @@
+#include "udpSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "TRA/debugUtils.hpp"
+
+#include "TRA/core/tcpSocket.hpp"
+
+#include "TRA/engine/endian.hpp"
+#include "TRA/engine/networkEcs.hpp"
+#include "TRA/engine/networkEcsUtils.hpp"
+
+#include "messageSerializer.hpp"
+#include "udpHandshakeMessage.hpp"
+
+#include "socketComponent.hpp"
+#include "messageComponent.hpp"
+#include "pendingDisconnectComponent.hpp"
+
+namespace tra::engine
+{
+	namespace
+	{
+		constexpr uint64_t CONDITIONED_PEER_IDLE_NS = 10ull * 1000 * 1000 * 1000;
+
+		// Keeps UDP peers' random streams apart from the TCP connections',
+		// which are numbered by entity id.
+		constexpr uint64_t CONDITIONED_PEER_STREAM = 1ull << 63;
+
+		std::shared_ptr<UdpSocketComponent> getUdpSocketComponent(NetworkEcs* _ecs, std::shared_ptr<UdpPeerTableComponent>& _outPeerTable)
+		{
+			for (auto queryResult : _ecs->query<UdpSocketComponent, UdpPeerTableComponent>())
+			{
+				_outPeerTable = std::get<2>(queryResult);
+				return std::get<1>(queryResult);
+			}
+
+			return nullptr;
+		}
+
+		void sendHandshakePacket(core::UdpSocket& _socket, const core::SocketAddress& _address, UdpPacketType _type, uint64_t _token)
+		{
+			std::vector<uint8_t> packet;
+			packet.reserve(UDP_HANDSHAKE_PACKET_SIZE);
+			Endian::appendLittle(packet, UDP_PACKET_VERSION);
+			Endian::appendLittle(packet, static_cast<uint8_t>(_type));
+			Endian::appendLittle(packet, _token);
+
+			auto sendResult = _socket.sendDataTo(packet.data(), packet.size(), _address);
+			if (sendResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("UdpSystem: Failed to send handshake packet, ErrorCode: %d, Last socket error: %d",
+					static_cast<int>(sendResult.first), sendResult.second);
+			}
+		}
+
+		void sendChallengePacket(core::UdpSocket& _socket, const core::SocketAddress& _address, UdpPacketType _type, uint64_t _token, uint64_t _cookie)
+		{
+			std::vector<uint8_t> packet;
+			packet.reserve(UDP_CHALLENGE_PACKET_SIZE);
+			Endian::appendLittle(packet, UDP_PACKET_VERSION);
+			Endian::appendLittle(packet, static_cast<uint8_t>(_type));
+			Endian::appendLittle(packet, _token);
+			Endian::appendLittle(packet, _cookie);
+
+			auto sendResult = _socket.sendDataTo(packet.data(), packet.size(), _address);
+			if (sendResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("UdpSystem: Failed to send challenge packet, ErrorCode: %d, Last socket error: %d",
+					static_cast<int>(sendResult.first), sendResult.second);
+			}
+		}
+
+		uint64_t rotateLeft(uint64_t _value, int _bits)
+		{
+			return (_value << _bits) | (_value >> (64 - _bits));
+		}
+
+		// SipHash-2-4 over whole 64-bit words.
+		uint64_t sipHash(const uint64_t _key[2], const uint64_t* _words, size_t _count)
+		{
+			uint64_t v0 = 0x736f6d6570736575ull ^ _key[0];
+			uint64_t v1 = 0x646f72616e646f6dull ^ _key[1];
+			uint64_t v2 = 0x6c7967656e657261ull ^ _key[0];
+			uint64_t v3 = 0x7465646279746573ull ^ _key[1];
+
+			auto round = [&]()
+			{
+				v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32);
+				v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2;
+				v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0;
+				v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32);
+			};
+
+			for (size_t i = 0; i < _count; i++)
+			{
+				v3 ^= _words[i];
+				round();
+				round();
+				v0 ^= _words[i];
+			}
+
+			uint64_t last = static_cast<uint64_t>(_count * sizeof(uint64_t)) << 56;
+			v3 ^= last;
+			round();
+			round();
+			v0 ^= last;
+
+			v2 ^= 0xff;
+			round();
+			round();
+			round();
+			round();
+
+			return v0 ^ v1 ^ v2 ^ v3;
+		}
+
+		// The cookie binds a token to the address that presented it within a time
+		// window, so the server can verify a response without having stored anything
+		// for the challenge.
+		uint64_t makeCookie(const UdpPeerTableComponent& _peerTable, const core::SocketAddress& _address, uint64_t _token, uint64_t _window)
+		{
+			uint64_t words[5] = {};
+			words[0] = (static_cast<uint64_t>(_address.getFamily()) << 16) | _address.getPort();
+
+			if (_address.getFamily() == AF_INET)
+			{
+				std::memcpy(&words[1], &reinterpret_cast<const sockaddr_in*>(_address.data())->sin_addr, sizeof(in_addr));
+			}
+			else if (_address.getFamily() == AF_INET6)
+			{
+				const sockaddr_in6* address = reinterpret_cast<const sockaddr_in6*>(_address.data());
+				std::memcpy(&words[1], &address->sin6_addr, sizeof(in6_addr));
+				words[0] |= static_cast<uint64_t>(address->sin6_scope_id) << 32;
+			}
+
+			words[3] = _token;
+			words[4] = _window;
+
+			return sipHash(_peerTable.m_cookieKey, words, 5);
+		}
+
+		uint64_t getCookieWindow(uint32_t _lifetimeMs)
+		{
+			uint64_t nowMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(UdpClock::now().time_since_epoch()).count());
+			return nowMs / (std::max)(_lifetimeMs, 1u);
+		}
+
+		double elapsedMs(UdpClock::time_point _from, UdpClock::time_point _to)
+		{
+			return std::chrono::duration<double, std::milli>(_to - _from).count();
+		}
+
+		// Only reliable entries wait on an ack; answering anything else would
+		// have idle peers trade ack-only packets every tick.
+		bool hasReliableEntry(const uint8_t* _data, size_t _size)
+		{
+			size_t offset = UDP_DATA_HEADER_SIZE;
+			while (_size - offset >= UDP_ENTRY_HEADER_SIZE)
+			{
+				if (static_cast<UdpChannel>(_data[offset]) == UdpChannel::ReliableOrdered)
+				{
+					return true;
+				}
+
+				uint16_t payloadSize = Endian::loadLittle<uint16_t>(_data + offset + 7);
+				offset += UDP_ENTRY_HEADER_SIZE;
+				if (_size - offset < payloadSize)
+				{
+					return false;
+				}
+
+				offset += payloadSize;
+			}
+
+			return false;
+		}
+	}
+
+	void issueUdpHandshake(NetworkEcs* _ecs, EntityId _listenEntityId, EntityId _entityId, SendTcpMessageComponent& _sendMessageComponent)
+	{
+		auto getPeerTableResult = _ecs->getComponentOfEntity<UdpPeerTableComponent>(_listenEntityId);
+		std::shared_ptr<UdpPeerTableComponent> udpPeerTableComponent = getPeerTableResult.second.lock();
+		auto getSocketResult = _ecs->getComponentOfEntity<UdpSocketComponent>(_listenEntityId);
+		std::shared_ptr<UdpSocketComponent> udpSocketComponent = getSocketResult.second.lock();
+		if (!udpPeerTableComponent || !udpSocketComponent)
+		{
+			return;
+		}
+
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = std::make_shared<UdpConnectionComponent>();
+		do
+		{
+			udpConnectionComponent->m_token = udpPeerTableComponent->m_tokenGenerator();
+		} while (udpPeerTableComponent->m_tokens.find(udpConnectionComponent->m_token) != udpPeerTableComponent->m_tokens.end());
+
+		TRA_ENTITY_ADD_COMPONENT(_ecs, _entityId, udpConnectionComponent, { return; });
+		udpPeerTableComponent->m_tokens[udpConnectionComponent->m_token] = _entityId;
+
+		std::shared_ptr<message::TraUdpHandshake> handshakeMessage = std::make_shared<message::TraUdpHandshake>();
+		handshakeMessage->token = udpConnectionComponent->m_token;
+		handshakeMessage->port = udpSocketComponent->m_udpSocket->getPort().second;
+		_sendMessageComponent.m_messagesToSend.push_back({ handshakeMessage, getLatencyClockNs() });
+	}
+
+	void releaseUdpConnection(NetworkEcs* _ecs, EntityId _entityId)
+	{
+		auto getComponentResult = _ecs->getComponentOfEntity<UdpConnectionComponent>(_entityId);
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent)
+		{
+			return;
+		}
+
+		for (auto peerTableResult : _ecs->query<UdpPeerTableComponent>())
+		{
+			std::shared_ptr<UdpPeerTableComponent> udpPeerTableComponent = std::get<1>(peerTableResult);
+
+			EntityId peerEntityId = 0;
+			if (udpPeerTableComponent->m_peers.find(udpConnectionComponent->m_peerAddress, peerEntityId) && peerEntityId == _entityId)
+			{
+				udpPeerTableComponent->m_peers.erase(udpConnectionComponent->m_peerAddress);
+			}
+
+			udpPeerTableComponent->m_tokens.erase(udpConnectionComponent->m_token);
+		}
+
+		ErrorCode removeResult = _ecs->removeComponentFromEntity<UdpConnectionComponent>(_entityId);
+		if (removeResult != ErrorCode::Success)
+		{
+			TRA_ERROR_LOG("UdpSystem: Failed to remove UdpConnectionComponent from entity %I32u, ErrorCode: %d",
+				_entityId, static_cast<int>(removeResult));
+		}
+	}
+
+	void UdpHandshakeSystem::update(NetworkEcs* _ecs)
+	{
+		std::shared_ptr<UdpPeerTableComponent> peerTable = nullptr;
+		std::shared_ptr<UdpSocketComponent> udpSocketComponent = getUdpSocketComponent(_ecs, peerTable);
+		if (!udpSocketComponent)
+		{
+			return;
+		}
+
+		EntityId entityId = 0;
+		std::shared_ptr<TcpConnectSocketComponent> tcpSocketComponent = nullptr;
+		std::shared_ptr<ReceiveTcpMessageComponent> receiveTcpMessageComponent = nullptr;
+
+		for (auto queryResult : _ecs->query<TcpConnectSocketComponent, ReceiveTcpMessageComponent>())
+		{
+			entityId = std::get<0>(queryResult);
+			tcpSocketComponent = std::get<1>(queryResult);
+			receiveTcpMessageComponent = std::get<2>(queryResult);
+
+			auto it = receiveTcpMessageComponent->m_receivedMessages.find(message::TraUdpHandshake::MESSAGE_TYPE_NAME);
+			if (it == receiveTcpMessageComponent->m_receivedMessages.end())
+			{
+				continue;
+			}
+
+			const message::TraUdpHandshake* handshakeMessage = static_cast<message::TraUdpHandshake*>(it->second.back().get());
+			uint64_t token = handshakeMessage->token;
+			uint16_t port = handshakeMessage->port;
+			receiveTcpMessageComponent->m_receivedMessages.erase(it);
+
+			// A fresh token on an existing connection means the server side moved
+			// (for example to another shard), so the UDP session starts over.
+			std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = nullptr;
+			bool existing = _ecs->hasComponent<UdpConnectionComponent>(entityId);
+			if (existing)
+			{
+				udpConnectionComponent = _ecs->getComponentOfEntity<UdpConnectionComponent>(entityId).second.lock();
+				if (!udpConnectionComponent || udpConnectionComponent->m_token == token)
+				{
+					continue;
+				}
+
+				peerTable->m_peers.erase(udpConnectionComponent->m_peerAddress);
+				*udpConnectionComponent = UdpConnectionComponent();
+			}
+			else
+			{
+				udpConnectionComponent = std::make_shared<UdpConnectionComponent>();
+			}
+
+			udpConnectionComponent->m_token = token;
+			udpConnectionComponent->m_initiator = true;
+
+			auto peerAddressResult = tcpSocketComponent->m_tcpSocket->getPeerAddress(udpConnectionComponent->m_peerAddress);
+			if (peerAddressResult.first != ErrorCode::Success || !udpConnectionComponent->m_peerAddress.isValid())
+			{
+				TRA_ERROR_LOG("UdpHandshakeSystem::update: Failed to resolve UDP peer address for entity %I32u, ErrorCode: %d",
+					entityId, static_cast<int>(peerAddressResult.first));
+				continue;
+			}
+
+			if (port != 0)
+			{
+				udpConnectionComponent->m_peerAddress.setPort(port);
+			}
+
+			if (!existing)
+			{
+				TRA_ENTITY_ADD_COMPONENT(_ecs, entityId, udpConnectionComponent, { continue; });
+			}
+
+			peerTable->m_peers.insert(udpConnectionComponent->m_peerAddress, entityId);
+		}
+
+		UdpClock::time_point now = UdpClock::now();
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = nullptr;
+
+		for (auto queryResult : _ecs->query<UdpConnectionComponent>())
+		{
+			udpConnectionComponent = std::get<1>(queryResult);
+			if (!udpConnectionComponent->m_initiator || udpConnectionComponent->m_bound)
+			{
+				continue;
+			}
+
+			if (elapsedMs(udpConnectionComponent->m_lastHandshakeSent, now) < m_config.m_udpHandshakeIntervalMs)
+			{
+				continue;
+			}
+
+			sendHandshakePacket(*udpSocketComponent->m_udpSocket, udpConnectionComponent->m_peerAddress, UdpPacketType::Handshake, udpConnectionComponent->m_token);
+			udpConnectionComponent->m_lastHandshakeSent = now;
+		}
+	}
+
+	void ReceiveUdpMessageSystem::update(NetworkEcs* _ecs)
+	{
+		std::shared_ptr<UdpPeerTableComponent> peerTable = nullptr;
+		std::shared_ptr<UdpSocketComponent> udpSocketComponent = getUdpSocketComponent(_ecs, peerTable);
+		if (!udpSocketComponent)
+		{
+			return;
+		}
+
+		for (auto queryResult : _ecs->query<UdpConnectionComponent>())
+		{
+			std::get<1>(queryResult)->m_receivedMessages.clear();
+		}
+
+		core::UdpSocket& udpSocket = *udpSocketComponent->m_udpSocket;
+		size_t slotCount = (std::max)(m_config.m_udpBatchSize, 1u);
+		size_t slotCapacity = udpSocket.isReceiveOffloadEnabled() ? core::UdpDatagramBatch::MAX_DATAGRAM_SIZE : m_config.m_udpMaxPacketSize;
+		if (!m_batch || m_batch->getSlotCount() != slotCount || m_batch->getSlotCapacity() != slotCapacity)
+		{
+			m_batch = std::make_unique<core::UdpDatagramBatch>(slotCount, slotCapacity);
+		}
+
+		bool conditioned = m_config.m_conditioner.m_enabled;
+		uint64_t nowNs = getLatencyClockNs();
+
+		uint32_t datagramsRead = 0;
+		while (datagramsRead < m_config.m_udpMaxDatagramsReadPerTick)
+		{
+			auto receiveResult = udpSocket.receiveBatch(*m_batch, m_config.m_udpMaxDatagramsReadPerTick - datagramsRead);
+			if (receiveResult.first == ErrorCode::SocketWouldBlock)
+			{
+				break;
+			}
+			else if (receiveResult.first != ErrorCode::Success)
+			{
+				TRA_DEBUG_LOG("ReceiveUdpMessageSystem::update: Failed to receive datagrams, ErrorCode: %d, Last socket error: %d",
+					static_cast<int>(receiveResult.first), receiveResult.second);
+				break;
+			}
+
+			for (int i = 0; i < receiveResult.second; i++)
+			{
+				const core::UdpDatagram& datagram = (*m_batch)[i];
+				if (datagram.m_receiveDelayNs != 0)
+				{
+					m_metrics.m_udpKernelReceiveDelay.record(datagram.m_receiveDelayNs / 1000);
+				}
+
+				size_t segmentSize = datagram.m_segmentSize != 0 ? datagram.m_segmentSize : datagram.m_size;
+
+				for (size_t offset = 0; offset < datagram.m_size; offset += segmentSize)
+				{
+					size_t size = (std::min)(segmentSize, datagram.m_size - offset);
+					if (conditioned)
+					{
+						conditionDatagram(datagram.m_address, datagram.m_data + offset, size, nowNs);
+					}
+					else
+					{
+						handleDatagram(_ecs, udpSocket, *peerTable, datagram.m_address, datagram.m_data + offset, size);
+					}
+				}
+			}
+
+			datagramsRead += static_cast<uint32_t>(receiveResult.second);
+			if (static_cast<size_t>(receiveResult.second) < slotCount)
+			{
+				break;
+			}
+		}
+
+		if (!m_conditionedPeers.empty())
+		{
+			releaseConditioned(_ecs, udpSocket, *peerTable, nowNs);
+		}
+	}
+
+	void ReceiveUdpMessageSystem::conditionDatagram(const core::SocketAddress& _address, const uint8_t* _data, size_t _size, uint64_t _nowNs)
+	{
+		std::unique_ptr<NetworkConditioner>& conditioner = m_conditionedPeers[_address];
+		if (!conditioner)
+		{
+			conditioner = std::make_unique<NetworkConditioner>(m_config.m_conditioner, CONDITIONED_PEER_STREAM | m_conditionedPeerCount++);
+		}
+
+		uint32_t copies = conditioner->pushDatagram(_data, _size, _nowNs);
+		if (copies == 0)
+		{
+			m_metrics.m_conditionerDatagramsDropped.add();
+		}
+		else if (copies > 1)
+		{
+			m_metrics.m_conditionerDatagramsDuplicated.add();
+		}
+	}
+
+	void ReceiveUdpMessageSystem::releaseConditioned(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable, uint64_t _nowNs)
+	{
+		int64_t queuedBytes = 0;
+
+		for (auto it = m_conditionedPeers.begin(); it != m_conditionedPeers.end();)
+		{
+			NetworkConditioner& conditioner = *it->second;
+			while (conditioner.popDatagram(m_conditionedDatagram, _nowNs))
+			{
+				handleDatagram(_ecs, _socket, _peerTable, it->first, m_conditionedDatagram.data(), m_conditionedDatagram.size());
+			}
+
+			// A peer that has gone quiet is forgotten; its link was idle anyway.
+			if (conditioner.isEmpty() && _nowNs - conditioner.getLastPushNs() > CONDITIONED_PEER_IDLE_NS)
+			{
+				it = m_conditionedPeers.erase(it);
+				continue;
+			}
+
+			queuedBytes += static_cast<int64_t>(conditioner.getQueuedBytes());
+			++it;
+		}
+
+		m_metrics.m_udpConditionerQueuedBytes.set(queuedBytes);
+	}
+
+	void ReceiveUdpMessageSystem::handleDatagram(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable,
+		const core::SocketAddress& _address, const uint8_t* _data, size_t _size)
+	{
+		if (_size < 2 || _data[0] != UDP_PACKET_VERSION)
+		{
+			return;
+		}
+
+		UdpPacketType packetType = static_cast<UdpPacketType>(_data[1]);
+		if (packetType == UdpPacketType::HandshakeChallenge || packetType == UdpPacketType::HandshakeResponse)
+		{
+			if (_size != UDP_CHALLENGE_PACKET_SIZE)
+			{
+				return;
+			}
+
+			uint64_t token = Endian::loadLittle<uint64_t>(_data + 2);
+			uint64_t cookie = Endian::loadLittle<uint64_t>(_data + UDP_HANDSHAKE_PACKET_SIZE);
+			if (packetType == UdpPacketType::HandshakeChallenge)
+			{
+				handleChallenge(_ecs, _socket, _peerTable, _address, token, cookie);
+			}
+			else
+			{
+				handleResponse(_ecs, _socket, _peerTable, _address, token, cookie);
+			}
+
+			return;
+		}
+
+		if (packetType == UdpPacketType::Handshake || packetType == UdpPacketType::HandshakeAck)
+		{
+			if (_size != UDP_HANDSHAKE_PACKET_SIZE)
+			{
+				return;
+			}
+
+			uint64_t token = Endian::loadLittle<uint64_t>(_data + 2);
+			if (packetType == UdpPacketType::Handshake)
+			{
+				handleHandshake(_ecs, _socket, _peerTable, _address, token);
+			}
+			else
+			{
+				handleHandshakeAck(_ecs, _peerTable, _address, token);
+			}
+
+			return;
+		}
+
+		if (packetType != UdpPacketType::Data)
+		{
+			return;
+		}
+
+		EntityId entityId = 0;
+		if (!_peerTable.m_peers.find(_address, entityId) || _ecs->hasComponent<PendingDisconnectComponentTag>(entityId))
+		{
+			return;
+		}
+
+		auto getComponentResult = _ecs->getComponentOfEntity<UdpConnectionComponent>(entityId);
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent || !udpConnectionComponent->m_bound)
+		{
+			return;
+		}
+
+		handleData(*udpConnectionComponent, _data, _size);
+	}
+
+	void ReceiveUdpMessageSystem::handleHandshake(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable,
+		const core::SocketAddress& _address, uint64_t _token)
+	{
+		auto tokenIt = _peerTable.m_tokens.find(_token);
+		if (tokenIt == _peerTable.m_tokens.end())
+		{
+			return;
+		}
+
+		auto getComponentResult = _ecs->getComponentOfEntity<UdpConnectionComponent>(tokenIt->second);
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent || udpConnectionComponent->m_initiator)
+		{
+			return;
+		}
+
+		if (udpConnectionComponent->m_bound)
+		{
+			if (udpConnectionComponent->m_peerAddress == _address)
+			{
+				sendHandshakePacket(_socket, _address, UdpPacketType::HandshakeAck, _token);
+			}
+
+			return;
+		}
+
+		uint64_t cookie = makeCookie(_peerTable, _address, _token, getCookieWindow(m_config.m_udpCookieLifetimeMs));
+		sendChallengePacket(_socket, _address, UdpPacketType::HandshakeChallenge, _token, cookie);
+	}
+
+	void ReceiveUdpMessageSystem::handleChallenge(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable,
+		const core::SocketAddress& _address, uint64_t _token, uint64_t _cookie)
+	{
+		EntityId entityId = 0;
+		if (!_peerTable.m_peers.find(_address, entityId))
+		{
+			return;
+		}
+
+		auto getComponentResult = _ecs->getComponentOfEntity<UdpConnectionComponent>(entityId);
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent || !udpConnectionComponent->m_initiator || udpConnectionComponent->m_bound || udpConnectionComponent->m_token != _token)
+		{
+			return;
+		}
+
+		sendChallengePacket(_socket, _address, UdpPacketType::HandshakeResponse, _token, _cookie);
+	}
+
+	void ReceiveUdpMessageSystem::handleResponse(NetworkEcs* _ecs, core::UdpSocket& _socket, UdpPeerTableComponent& _peerTable,
+		const core::SocketAddress& _address, uint64_t _token, uint64_t _cookie)
+	{
+		uint64_t window = getCookieWindow(m_config.m_udpCookieLifetimeMs);
+		if (_cookie != makeCookie(_peerTable, _address, _token, window) && _cookie != makeCookie(_peerTable, _address, _token, window - 1))
+		{
+			return;
+		}
+
+		auto tokenIt = _peerTable.m_tokens.find(_token);
+		if (tokenIt == _peerTable.m_tokens.end())
+		{
+			return;
+		}
+
+		auto getComponentResult = _ecs->getComponentOfEntity<UdpConnectionComponent>(tokenIt->second);
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent || udpConnectionComponent->m_initiator)
+		{
+			return;
+		}
+
+		if (udpConnectionComponent->m_bound)
+		{
+			if (udpConnectionComponent->m_peerAddress != _address)
+			{
+				return;
+			}
+		}
+		else
+		{
+			udpConnectionComponent->m_peerAddress = _address;
+			udpConnectionComponent->m_bound = true;
+			_peerTable.m_peers.insert(_address, tokenIt->second);
+
+			TRA_DEBUG_LOG("ReceiveUdpMessageSystem::update: UDP peer bound to entity %I32u", tokenIt->second);
+		}
+
+		sendHandshakePacket(_socket, _address, UdpPacketType::HandshakeAck, _token);
+	}
+
+	void ReceiveUdpMessageSystem::handleHandshakeAck(NetworkEcs* _ecs, UdpPeerTableComponent& _peerTable, const core::SocketAddress& _address, uint64_t _token)
+	{
+		EntityId entityId = 0;
+		if (!_peerTable.m_peers.find(_address, entityId))
+		{
+			return;
+		}
+
+		auto getComponentResult = _ecs->getComponentOfEntity<UdpConnectionComponent>(entityId);
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = getComponentResult.second.lock();
+		if (!udpConnectionComponent || !udpConnectionComponent->m_initiator || udpConnectionComponent->m_token != _token || udpConnectionComponent->m_bound)
+		{
+			return;
+		}
+
+		udpConnectionComponent->m_bound = true;
+		TRA_DEBUG_LOG("ReceiveUdpMessageSystem::update: UDP handshake completed for entity %I32u", entityId);
+	}
+
+	void ReceiveUdpMessageSystem::handleData(UdpConnectionComponent& _connection, const uint8_t* _data, size_t _size)
+	{
+		if (_size < UDP_DATA_HEADER_SIZE)
+		{
+			return;
+		}
+
+		uint16_t sequence = Endian::loadLittle<uint16_t>(_data + 2);
+		uint16_t ack = Endian::loadLittle<uint16_t>(_data + 4);
+		uint32_t ackBits = Endian::loadLittle<uint32_t>(_data + 6);
+
+		bool duplicate = false;
+		if (!_connection.m_hasRemoteSequence)
+		{
+			_connection.m_remoteSequence = sequence;
+			_connection.m_remoteAckBits = 0;
+			_connection.m_hasRemoteSequence = true;
+		}
+		else if (sequenceGreaterThan(sequence, _connection.m_remoteSequence))
+		{
+			uint16_t shift = static_cast<uint16_t>(sequence - _connection.m_remoteSequence);
+			if (shift < 32)
+			{
+				_connection.m_remoteAckBits = (_connection.m_remoteAckBits << shift) | (1u << (shift - 1));
+			}
+			else
+			{
+				_connection.m_remoteAckBits = shift == 32 ? (1u << 31) : 0;
+			}
+
+			_connection.m_remoteSequence = sequence;
+		}
+		else
+		{
+			uint16_t distance = static_cast<uint16_t>(_connection.m_remoteSequence - sequence);
+			if (distance == 0)
+			{
+				duplicate = true;
+			}
+			else if (distance <= 32)
+			{
+				uint32_t bit = 1u << (distance - 1);
+				duplicate = (_connection.m_remoteAckBits & bit) != 0;
+				_connection.m_remoteAckBits |= bit;
+			}
+		}
+
+		// Duplicates are acked too: the peer resends when our ack was lost.
+		if (hasReliableEntry(_data, _size))
+		{
+			_connection.m_ackPending = true;
+		}
+
+		processAck(_connection, ack, ackBits);
+
+		if (duplicate)
+		{
+			return;
+		}
+
+		size_t offset = UDP_DATA_HEADER_SIZE;
+		while (_size - offset >= UDP_ENTRY_HEADER_SIZE)
+		{
+			UdpChannel channel = static_cast<UdpChannel>(_data[offset]);
+			uint16_t channelSequence = Endian::loadLittle<uint16_t>(_data + offset + 1);
+			uint32_t typeId = Endian::loadLittle<uint32_t>(_data + offset + 3);
+			uint16_t payloadSize = Endian::loadLittle<uint16_t>(_data + offset + 7);
+			offset += UDP_ENTRY_HEADER_SIZE;
+
+			if (_size - offset < payloadSize)
+			{
+				TRA_DEBUG_LOG("ReceiveUdpMessageSystem::update: Truncated datagram from %s", _connection.m_peerAddress.toString().c_str());
+				return;
+			}
+
+			const uint8_t* payload = _data + offset;
+			offset += payloadSize;
+
+			switch (channel)
+			{
+			case UdpChannel::Unreliable:
+				deliver(_connection, typeId, payload, payloadSize);
+				break;
+			case UdpChannel::UnreliableSequenced:
+				if (!_connection.m_hasSequencedReceived || sequenceGreaterThan(channelSequence, _connection.m_lastSequencedReceived))
+				{
+					_connection.m_lastSequencedReceived = channelSequence;
+					_connection.m_hasSequencedReceived = true;
+					deliver(_connection, typeId, payload, payloadSize);
+				}
+				break;
+			case UdpChannel::ReliableOrdered:
+				if (channelSequence == _connection.m_nextExpectedReliable)
+				{
+					deliver(_connection, typeId, payload, payloadSize);
+					++_connection.m_nextExpectedReliable;
+
+					for (auto it = _connection.m_reorderBuffer.find(_connection.m_nextExpectedReliable); it != _connection.m_reorderBuffer.end();
+						it = _connection.m_reorderBuffer.find(_connection.m_nextExpectedReliable))
+					{
+						deliver(_connection, it->second.m_typeId, it->second.m_payload.data(), it->second.m_payload.size());
+						_connection.m_reorderBuffer.erase(it);
+						++_connection.m_nextExpectedReliable;
+					}
+				}
+				else if (sequenceGreaterThan(channelSequence, _connection.m_nextExpectedReliable)
+					&& static_cast<uint16_t>(channelSequence - _connection.m_nextExpectedReliable) < UDP_REORDER_WINDOW)
+				{
+					UdpReceivedEntry entry;
+					entry.m_typeId = typeId;
+					entry.m_payload.assign(payload, payload + payloadSize);
+					_connection.m_reorderBuffer.emplace(channelSequence, std::move(entry));
+				}
+				break;
+			default:
+				TRA_DEBUG_LOG("ReceiveUdpMessageSystem::update: Unknown channel %u from %s", static_cast<unsigned int>(channel), _connection.m_peerAddress.toString().c_str());
+				return;
+			}
+		}
+	}
+
+	void ReceiveUdpMessageSystem::processAck(UdpConnectionComponent& _connection, uint16_t _ack, uint32_t _ackBits)
+	{
+		UdpClock::time_point now = UdpClock::now();
+
+		for (uint16_t i = 0; i <= 32; i++)
+		{
+			if (i > 0 && (_ackBits & (1u << (i - 1))) == 0)
+			{
+				continue;
+			}
+
+			uint16_t sequence = static_cast<uint16_t>(_ack - i);
+			UdpSentPacket& sentPacket = _connection.m_sentPackets[sequence % UDP_SENT_PACKET_HISTORY];
+			if (!sentPacket.m_valid || sentPacket.m_sequence != sequence)
+			{
+				continue;
+			}
+
+			sentPacket.m_valid = false;
+
+			for (uint16_t reliableSequence : sentPacket.m_reliableSequences)
+			{
+				if (_connection.m_reliableToSend.empty())
+				{
+					break;
+				}
+
+				size_t index = static_cast<uint16_t>(reliableSequence - _connection.m_reliableToSend.front().m_sequence);
+				if (index < _connection.m_reliableToSend.size())
+				{
+					_connection.m_reliableToSend[index].m_acked = true;
+				}
+			}
+
+			if (i == 0)
+			{
+				// RFC 6298 smoothed round trip time, sampled on the newest acknowledged packet only
+				double sample = elapsedMs(sentPacket.m_sentAt, now);
+				if (!_connection.m_hasRttSample)
+				{
+					_connection.m_smoothedRtt = sample;
+					_connection.m_rttVariance = sample / 2.0;
+					_connection.m_hasRttSample = true;
+				}
+				else
+				{
+					_connection.m_rttVariance = 0.75 * _connection.m_rttVariance + 0.25 * std::fabs(_connection.m_smoothedRtt - sample);
+					_connection.m_smoothedRtt = 0.875 * _connection.m_smoothedRtt + 0.125 * sample;
+				}
+
+				double timeout = _connection.m_smoothedRtt + (std::max)(1.0, 4.0 * _connection.m_rttVariance);
+				_connection.m_retransmitTimeout = (std::min)((std::max)(timeout, static_cast<double>(m_config.m_udpMinRetransmitTimeoutMs)),
+					static_cast<double>(m_config.m_udpMaxRetransmitTimeoutMs));
+			}
+		}
+
+		while (!_connection.m_reliableToSend.empty() && _connection.m_reliableToSend.front().m_acked)
+		{
+			_connection.m_reliableToSend.pop_front();
+		}
+	}
+
+	void ReceiveUdpMessageSystem::deliver(UdpConnectionComponent& _connection, uint32_t _typeId, const uint8_t* _payload, size_t _size)
+	{
+		if (!MessageFactory::isRegistered(_typeId))
+		{
+			return;
+		}
+
+		std::vector<uint8_t> payload(_payload, _payload + _size);
+		std::shared_ptr<Message> newMessage = MessageSerializer::deserializePayload(_typeId, payload);
+		if (!newMessage)
+		{
+			m_metrics.m_udpDeserializeFailures.add();
+			return;
+		}
+
+		_connection.m_receivedMessages[newMessage->getType()].push_back(newMessage);
+	}
+
+	void SendUdpMessageSystem::update(NetworkEcs* _ecs)
+	{
+		std::shared_ptr<UdpPeerTableComponent> peerTable = nullptr;
+		std::shared_ptr<UdpSocketComponent> udpSocketComponent = getUdpSocketComponent(_ecs, peerTable);
+		if (!udpSocketComponent)
+		{
+			return;
+		}
+
+		core::UdpSocket& udpSocket = *udpSocketComponent->m_udpSocket;
+		UdpClock::time_point now = UdpClock::now();
+
+		size_t slotCount = (std::max)(m_config.m_udpBatchSize, 1u);
+		size_t slotCapacity = udpSocket.isSegmentationOffloadEnabled() ? core::UdpDatagramBatch::MAX_SEGMENTED_PAYLOAD : m_config.m_udpMaxPacketSize;
+		if (!m_batch || m_batch->getSlotCount() != slotCount || m_batch->getSlotCapacity() != slotCapacity)
+		{
+			m_batch = std::make_unique<core::UdpDatagramBatch>(slotCount, slotCapacity);
+		}
+
+		m_batchCount = 0;
+		m_batchConnection = nullptr;
+
+		EntityId entityId = 0;
+		std::shared_ptr<UdpConnectionComponent> udpConnectionComponent = nullptr;
+
+		for (auto queryResult : _ecs->query<UdpConnectionComponent>())
+		{
+			entityId = std::get<0>(queryResult);
+			udpConnectionComponent = std::get<1>(queryResult);
+			if (!udpConnectionComponent->m_bound || _ecs->hasComponent<PendingDisconnectComponentTag>(entityId))
+			{
+				continue;
+			}
+
+			UdpConnectionComponent& connection = *udpConnectionComponent;
+			if (connection.m_retransmitTimeout <= 0.0)
+			{
+				connection.m_retransmitTimeout = m_config.m_udpInitialRetransmitTimeoutMs;
+			}
+
+			for (UdpQueuedMessage& queuedMessage : connection.m_messagesToSend)
+			{
+				if (queuedMessage.m_channel != UdpChannel::ReliableOrdered)
+				{
+					continue;
+				}
+
+				UdpReliableMessage reliableMessage;
+				reliableMessage.m_sequence = connection.m_nextReliableSequence++;
+				reliableMessage.m_typeId = queuedMessage.m_typeId;
+				reliableMessage.m_payload = std::move(queuedMessage.m_payload);
+				connection.m_reliableToSend.push_back(std::move(reliableMessage));
+			}
+
+			if (connection.m_reliableToSend.size() > static_cast<size_t>(m_config.m_udpMaxReliableInFlight) * 4)
+			{
+				TRA_ERROR_LOG("SendUdpMessageSystem::update: Reliable backlog exceeded for entity %I32u, Pending: %llu",
+					entityId, static_cast<unsigned long long>(connection.m_reliableToSend.size()));
+
+				TRA_ENTITY_ADD_COMPONENT(_ecs, entityId, std::make_shared<PendingDisconnectComponentTag>(), {});
+				continue;
+			}
+
+			beginPacket();
+
+			bool timedOut = false;
+			size_t inFlight = 0;
+			for (UdpReliableMessage& reliableMessage : connection.m_reliableToSend)
+			{
+				if (reliableMessage.m_acked)
+				{
+					continue;
+				}
+
+				if (++inFlight > m_config.m_udpMaxReliableInFlight)
+				{
+					break;
+				}
+
+				if (reliableMessage.m_sent && elapsedMs(reliableMessage.m_lastSent, now) < connection.m_retransmitTimeout)
+				{
+					continue;
+				}
+
+				timedOut = timedOut || reliableMessage.m_sent;
+				if (appendEntry(udpSocket, connection, UdpChannel::ReliableOrdered, reliableMessage.m_sequence, reliableMessage.m_typeId, reliableMessage.m_payload))
+				{
+					reliableMessage.m_lastSent = now;
+					reliableMessage.m_sent = true;
+				}
+			}
+
+			if (timedOut)
+			{
+				connection.m_retransmitTimeout = (std::min)(connection.m_retransmitTimeout * 2.0, static_cast<double>(m_config.m_udpMaxRetransmitTimeoutMs));
+			}
+
+			for (const UdpQueuedMessage& queuedMessage : connection.m_messagesToSend)
+			{
+				if (queuedMessage.m_channel == UdpChannel::ReliableOrdered)
+				{
+					continue;
+				}
+
+				uint16_t sequence = queuedMessage.m_channel == UdpChannel::UnreliableSequenced ? connection.m_nextSequencedSequence++ : 0;
+				appendEntry(udpSocket, connection, queuedMessage.m_channel, sequence, queuedMessage.m_typeId, queuedMessage.m_payload);
+			}
+
+			connection.m_messagesToSend.clear();
+
+			if (m_packetEntries > 0 || connection.m_ackPending)
+			{
+				flushPacket(udpSocket, connection);
+			}
+		}
+
+		flushBatch(udpSocket);
+	}
+
+	void SendUdpMessageSystem::beginPacket()
+	{
+		m_packet.clear();
+		m_packet.resize(UDP_DATA_HEADER_SIZE);
+		m_packetReliableSequences.clear();
+		m_packetEntries = 0;
+	}
+
+	bool SendUdpMessageSystem::appendEntry(core::UdpSocket& _socket, UdpConnectionComponent& _connection, UdpChannel _channel, uint16_t _sequence,
+		uint32_t _typeId, const std::vector<uint8_t>& _payload)
+	{
+		if (UDP_DATA_HEADER_SIZE + UDP_ENTRY_HEADER_SIZE + _payload.size() > m_config.m_udpMaxPacketSize)
+		{
+			TRA_ERROR_LOG("SendUdpMessageSystem::update: Message of %llu bytes does not fit in a datagram, ErrorCode: %d",
+				static_cast<unsigned long long>(_payload.size()), static_cast<int>(ErrorCode::UdpMessageTooLarge));
+			return false;
+		}
+
+		if (m_packet.size() + UDP_ENTRY_HEADER_SIZE + _payload.size() > m_config.m_udpMaxPacketSize)
+		{
+			flushPacket(_socket, _connection);
+			beginPacket();
+		}
+
+		Endian::appendLittle(m_packet, static_cast<uint8_t>(_channel));
+		Endian::appendLittle(m_packet, _sequence);
+		Endian::appendLittle(m_packet, _typeId);
+		Endian::appendLittle(m_packet, static_cast<uint16_t>(_payload.size()));
+		m_packet.insert(m_packet.end(), _payload.begin(), _payload.end());
+
+		if (_channel == UdpChannel::ReliableOrdered)
+		{
+			m_packetReliableSequences.push_back(_sequence);
+		}
+
+		++m_packetEntries;
+		return true;
+	}
+
+	void SendUdpMessageSystem::flushPacket(core::UdpSocket& _socket, UdpConnectionComponent& _connection)
+	{
+		uint16_t sequence = _connection.m_nextPacketSequence++;
+
+		m_packet[0] = UDP_PACKET_VERSION;
+		m_packet[1] = static_cast<uint8_t>(UdpPacketType::Data);
+		Endian::storeLittle(m_packet.data() + 2, sequence);
+		Endian::storeLittle(m_packet.data() + 4, _connection.m_remoteSequence);
+		Endian::storeLittle(m_packet.data() + 6, _connection.m_remoteAckBits);
+
+		UdpSentPacket& sentPacket = _connection.m_sentPackets[sequence % UDP_SENT_PACKET_HISTORY];
+		sentPacket.m_sequence = sequence;
+		sentPacket.m_valid = true;
+		sentPacket.m_sentAt = UdpClock::now();
+		sentPacket.m_reliableSequences.swap(m_packetReliableSequences);
+		m_packetReliableSequences.clear();
+
+		queueDatagram(_socket, _connection);
+
+		_connection.m_ackPending = false;
+		m_packetEntries = 0;
+	}
+
+	void SendUdpMessageSystem::queueDatagram(core::UdpSocket& _socket, const UdpConnectionComponent& _connection)
+	{
+		if (m_batchCount > 0 && m_batchConnection == &_connection && _socket.isSegmentationOffloadEnabled())
+		{
+			core::UdpDatagram& datagram = (*m_batch)[m_batchCount - 1];
+			if (m_packet.size() <= datagram.m_segmentSize && datagram.m_size % datagram.m_segmentSize == 0
+				&& datagram.m_size + m_packet.size() <= m_batch->getSlotCapacity()
+				&& datagram.m_size / datagram.m_segmentSize < core::UdpDatagramBatch::MAX_SEGMENTS)
+			{
+				std::memcpy(datagram.m_data + datagram.m_size, m_packet.data(), m_packet.size());
+				datagram.m_size += m_packet.size();
+				return;
+			}
+		}
+
+		if (m_batchCount == m_batch->getSlotCount())
+		{
+			flushBatch(_socket);
+		}
+
+		core::UdpDatagram& datagram = (*m_batch)[m_batchCount++];
+		std::memcpy(datagram.m_data, m_packet.data(), m_packet.size());
+		datagram.m_size = m_packet.size();
+		datagram.m_address = _connection.m_peerAddress;
+		datagram.m_segmentSize = _socket.isSegmentationOffloadEnabled() ? static_cast<uint16_t>(m_packet.size()) : 0;
+		m_batchConnection = &_connection;
+	}
+
+	void SendUdpMessageSystem::flushBatch(core::UdpSocket& _socket)
+	{
+		if (m_batchCount == 0)
+		{
+			return;
+		}
+
+		size_t dropped = 0;
+		auto sendResult = _socket.sendBatch(*m_batch, m_batchCount, dropped);
+		if (sendResult.first != ErrorCode::Success)
+		{
+			TRA_DEBUG_LOG("SendUdpMessageSystem::update: Failed to send datagrams, Dropped: %llu/%llu, ErrorCode: %d, Last socket error: %d",
+				static_cast<unsigned long long>(dropped), static_cast<unsigned long long>(m_batchCount), static_cast<int>(sendResult.first), sendResult.second);
+		}
+
+		m_batchCount = 0;
+		m_batchConnection = nullptr;
+	}
+}
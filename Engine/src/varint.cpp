@@ -0,0 +1,110 @@
+#include "TRA/engine/varint.hpp"
+
+#include "TRA/engine/endian.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRA_VARINT_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace tra::engine::internal
+{
+	namespace
+	{
+		uint32_t countTrailingZeros(uint64_t _value)
+		{
+#ifdef _MSC_VER
+			unsigned long index = 0;
+			_BitScanForward64(&index, _value);
+			return static_cast<uint32_t>(index);
+#else
+			return static_cast<uint32_t>(__builtin_ctzll(_value));
+#endif
+		}
+
+		bool decodeOne(const uint8_t* _data, size_t _size, size_t& _offset, uint64_t& _value)
+		{
+			_value = 0;
+			for (size_t i = 0; i < MAX_VARINT_SIZE; i++)
+			{
+				if (_offset >= _size)
+				{
+					return false;
+				}
+
+				uint8_t byte = _data[_offset++];
+				_value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+				if ((byte & 0x80) == 0)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		uint64_t continuationMask(const uint8_t* _data, size_t& _blockSize)
+		{
+#ifdef TRA_VARINT_SSE2
+			_blockSize = 16;
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_data));
+			return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(block)));
+#else
+			_blockSize = 8;
+			uint64_t word = Endian::loadLittle<uint64_t>(_data) & 0x8080808080808080ull;
+
+			uint64_t mask = 0;
+			for (size_t i = 0; i < 8; i++)
+			{
+				mask |= ((word >> (i * 8 + 7)) & 1u) << i;
+			}
+
+			return mask;
+#endif
+		}
+	}
+
+	bool decodeVarintRun(const uint8_t* _data, size_t _size, size_t& _consumed, uint64_t* _out, size_t _count)
+	{
+		size_t offset = 0;
+		size_t decoded = 0;
+		size_t blockSize = 0;
+
+		while (decoded < _count)
+		{
+			if (_size - offset >= 16 && _count - decoded >= 16)
+			{
+				uint64_t mask = continuationMask(_data + offset, blockSize);
+				size_t singleByteValues = mask == 0 ? blockSize : countTrailingZeros(mask);
+
+				for (size_t i = 0; i < singleByteValues; i++)
+				{
+					_out[decoded + i] = _data[offset + i];
+				}
+
+				offset += singleByteValues;
+				decoded += singleByteValues;
+
+				if (singleByteValues == blockSize)
+				{
+					continue;
+				}
+			}
+
+			if (!decodeOne(_data, _size, offset, _out[decoded]))
+			{
+				_consumed = offset;
+				return false;
+			}
+
+			++decoded;
+		}
+
+		_consumed = offset;
+		return true;
+	}
+}
@@ -0,0 +1,87 @@
+#ifndef TRA_CLIENT_CLIENT_HPP
+#define TRA_CLIENT_CLIENT_HPP
+
+#include "TRA/export.hpp"
+
+#include <string>
+#include <cstdint>
+
+#include "TRA/errorCode.hpp"
+#include "TRA/engine/networkEngine.hpp"
+
+namespace tra::client
+{
+	using EntityId = uint32_t;
+
+	class Client
+	{
+	public:
+		TRA_API explicit Client(const engine::NetworkEngineConfig& _config = engine::NetworkEngineConfig());
+		TRA_API ~Client();
+
+		Client(Client& other) = delete;
+		void operator=(const Client&) = delete;
+
+		TRA_API static Client* Get();
+
+		TRA_API ErrorCode ConnectTo(const std::string& _address, uint16_t _port);
+		TRA_API ErrorCode Disconnect();
+
+		TRA_API bool IsConnected() const;
+
+		TRA_API void beginUpdate();
+		TRA_API void endUpdate();
+
+		TRA_API ErrorCode sendTcpMessage(std::shared_ptr<engine::Message> _message);
+		TRA_API std::vector<std::shared_ptr<engine::Message>> getTcpMessages(const std::string& _messageType);
+		TRA_API std::pair<ErrorCode, engine::ConnectionStats> getConnectionStats();
+
+		TRA_API bool IsUdpConnected();
+		TRA_API ErrorCode sendUdpMessage(std::shared_ptr<engine::Message> _message, engine::UdpChannel _channel);
+		TRA_API std::vector<std::shared_ptr<engine::Message>> getUdpMessages(const std::string& _messageType);
+
+		TRA_API core::MetricsSnapshot getMetricsSnapshot();
+		TRA_API ErrorCode dumpMetrics(const std::string& _path);
+		TRA_API ErrorCode startMetricsEndpoint(uint16_t _port);
+		TRA_API ErrorCode stopMetricsEndpoint();
+
+		TRA_API std::vector<engine::MessageLatency> getMessageLatencies() const;
+		TRA_API void resetMessageLatencies();
+
+		TRA_API std::vector<engine::SystemTiming> getTickProfile() const;
+		TRA_API void startTickTrace(size_t _maxEvents = 1 << 20);
+		TRA_API void stopTickTrace();
+		TRA_API ErrorCode writeTickTrace(const std::string& _path) const;
+
+		TRA_API ErrorCode startCapture(const std::string& _path);
+		TRA_API ErrorCode stopCapture();
+
+		TRA_API const engine::NetworkEngineConfig& getConfig() const;
+		TRA_API void setConfig(const engine::NetworkEngineConfig& _config);
+
+		template<typename ComponentType>
+		bool entityHasComponent(EntityId _entityId)
+		{
+			return m_networkEngine->entityHasComponent<ComponentType>(_entityId);
+		}
+
+		template<typename ...ComponentType>
+		std::vector<EntityId> queryEntityIds()
+		{
+			return m_networkEngine->queryEntityIds<ComponentType...>();
+		}
+
+		template<typename ...ComponentType>
+		std::vector<std::tuple<EntityId, std::shared_ptr<ComponentType>...>> queryEntity()
+		{
+			return m_networkEngine->queryEntity<ComponentType...>();
+		}
+
+	private:
+		static Client* m_singleton;
+
+		engine::NetworkEngine* m_networkEngine;
+	};
+}
+
+#endif
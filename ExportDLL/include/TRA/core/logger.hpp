@@ -0,0 +1,168 @@
+#ifndef TRA_CORE_LOGGER_HPP
+#define TRA_CORE_LOGGER_HPP
+
+#include "TRA/export.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace tra::core
+{
+    enum class LogLevel : uint8_t
+    {
+        Debug,
+        Info,
+        Error
+    };
+
+    // One per TRA_*_LOG call site, constant-initialized. Holds the format string
+    // and the per-site rate limiter state.
+    struct LogSite
+    {
+        constexpr LogSite(LogLevel _level, const char* _format)
+            : m_level(_level), m_format(_format), m_windowStartMs(0), m_windowCount(0), m_suppressed(0)
+        {
+        }
+
+        LogLevel m_level;
+        const char* m_format;
+        std::atomic<int64_t> m_windowStartMs;
+        std::atomic<uint32_t> m_windowCount;
+        std::atomic<uint32_t> m_suppressed;
+    };
+
+    enum class LogArgType : uint8_t
+    {
+        Signed,
+        Unsigned,
+        Double,
+        Pointer,
+        String
+    };
+
+    // A log call as it sits in the ring: the site plus its arguments in binary
+    // form. Strings are copied into m_text since they rarely outlive the call.
+    struct LogRecord
+    {
+        static constexpr size_t MAX_ARGS = 8;
+        static constexpr size_t TEXT_CAPACITY = 160;
+
+        const LogSite* m_site = nullptr;
+        uint32_t m_suppressed = 0;
+        uint8_t m_argCount = 0;
+        uint8_t m_textSize = 0;
+        LogArgType m_argTypes[MAX_ARGS] = {};
+        uint64_t m_args[MAX_ARGS] = {};
+        char m_text[TEXT_CAPACITY];
+
+        void push(LogArgType _type, uint64_t _value)
+        {
+            if (m_argCount < MAX_ARGS)
+            {
+                m_argTypes[m_argCount] = _type;
+                m_args[m_argCount] = _value;
+                m_argCount++;
+            }
+        }
+
+        void pushString(const char* _string)
+        {
+            if (_string == nullptr)
+            {
+                _string = "(null)";
+            }
+
+            size_t length = std::strlen(_string);
+            size_t available = TEXT_CAPACITY - m_textSize;
+            if (available == 0)
+            {
+                push(LogArgType::String, m_textSize - 1);
+                return;
+            }
+
+            length = length < available - 1 ? length : available - 1;
+            std::memcpy(m_text + m_textSize, _string, length);
+            m_text[m_textSize + length] = '\0';
+
+            push(LogArgType::String, m_textSize);
+            m_textSize = static_cast<uint8_t>(m_textSize + length + 1);
+        }
+
+        template<typename T>
+        void pushArg(T _value)
+        {
+            using Type = std::decay_t<T>;
+
+            if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+            {
+                pushString(_value);
+            }
+            else if constexpr (std::is_pointer_v<Type>)
+            {
+                push(LogArgType::Pointer, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(_value)));
+            }
+            else if constexpr (std::is_enum_v<Type>)
+            {
+                pushArg(static_cast<std::underlying_type_t<Type>>(_value));
+            }
+            else if constexpr (std::is_floating_point_v<Type>)
+            {
+                double value = static_cast<double>(_value);
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                push(LogArgType::Double, bits);
+            }
+            else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+            {
+                push(LogArgType::Signed, static_cast<uint64_t>(static_cast<int64_t>(_value)));
+            }
+            else
+            {
+                static_assert(std::is_integral_v<Type>, "TRA log arguments must be integers, floats, pointers or C strings");
+                push(LogArgType::Unsigned, static_cast<uint64_t>(_value));
+            }
+        }
+    };
+
+    // Log calls are captured into a bounded lock-free ring (Vyukov MPMC queue)
+    // and formatted and written by a background thread, so the calling thread
+    // never formats or touches a stream. When the ring is full the record is
+    // dropped and counted. Each call site is limited to a number of records per
+    // second; the overflow is folded into a "suppressed" count on the next
+    // record that gets through.
+    namespace Logger
+    {
+        // Returns false when the site is over its rate limit; _outSuppressed is
+        // then the number of records skipped since the last one written.
+        TRA_API bool admit(LogSite& _site, uint32_t& _outSuppressed);
+        TRA_API void submit(const LogRecord& _record);
+
+        // 0 disables rate limiting.
+        TRA_API void setRateLimit(uint32_t _maxPerSitePerSecond);
+
+        // Blocks until every record submitted so far has been written.
+        TRA_API void flush();
+
+        template<typename ...Args>
+        void log(LogSite& _site, Args... _args)
+        {
+            uint32_t suppressed = 0;
+            if (!admit(_site, suppressed))
+            {
+                return;
+            }
+
+            LogRecord record;
+            record.m_site = &_site;
+            record.m_suppressed = suppressed;
+            (record.pushArg(_args), ...);
+
+            submit(record);
+        }
+    }
+}
+
+#endif
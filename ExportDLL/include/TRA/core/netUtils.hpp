@@ -0,0 +1,21 @@
+#ifndef TRA_CORE_NET_UTILS_HPP
+#define TRA_CORE_NET_UTILS_HPP
+
+#include "TRA/export.hpp"
+
+#include <string>
+#include <cstdint>
+
+namespace tra::core
+{
+	namespace NetUtils
+	{
+		TRA_API bool isValidIpV4Address(const std::string& _address);
+		TRA_API bool isValidPort(uint16_t _port);
+		// Whether several sockets can listen on one port (SO_REUSEPORT), which
+		// Windows lacks.
+		TRA_API bool isReusePortSupported();
+	}
+}
+
+#endif
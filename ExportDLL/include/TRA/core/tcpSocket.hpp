@@ -0,0 +1,91 @@
+#ifndef TRA_CORE_TCP_SOCKET_HPP
+#define TRA_CORE_TCP_SOCKET_HPP
+
+#include "TRA/export.hpp"
+
+#include <utility>
+#include <limits>
+#include <memory>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "TRA/errorCode.hpp"
+#include "networkInclude.hpp"
+#include "socketAddress.hpp"
+
+namespace tra::core
+{
+    // Kernel timestamps of one send: m_bufferedNs is the time from send() until
+    // the stack handed the data to the device, m_wireNs the time from there
+    // until the peer acknowledged it.
+    struct TransmitTimestamp
+    {
+        uint64_t m_bufferedNs = 0;
+        uint64_t m_wireNs = 0;
+    };
+
+    class TcpSocket
+    {
+    public:
+        TRA_API TcpSocket();
+        TRA_API ~TcpSocket();
+
+        TRA_API std::pair<ErrorCode, int> shutdownSocket();
+        TRA_API void closeSocket();
+        // A non-blocking connect returns SocketConnectInProgress until
+        // finishConnect reports the outcome.
+        TRA_API std::pair<ErrorCode, int> connectTo(const std::string& _adress, const uint16_t _port, bool _nonBlocking = false);
+        TRA_API std::pair<ErrorCode, int> finishConnect();
+        TRA_API std::pair<ErrorCode, int> bindSocket(const uint16_t _port, bool _reusePort = false, bool _loopbackOnly = false);
+        TRA_API std::pair<ErrorCode, int> listenSocket(int _backlog = SOMAXCONN);
+        TRA_API std::pair<ErrorCode, int> acceptSocket(TcpSocket** _outClient, bool _nonBlocking = false);
+        TRA_API std::pair<ErrorCode, int> waitReadable(uint32_t _timeoutMs);
+        TRA_API std::pair<ErrorCode, int> sendData(const void* _data, size_t _size, int& _byteSent);
+        TRA_API std::pair<ErrorCode, int> receiveData(std::vector<uint8_t>& _buffer, size_t _maxBytes = std::numeric_limits<size_t>::max());
+        TRA_API std::pair<ErrorCode, int> setBlocking(bool _blocking);
+        TRA_API std::pair<ErrorCode, uint16_t> getPort();
+        TRA_API std::pair<ErrorCode, int> getPeerAddress(SocketAddress& _outAddress);
+        TRA_API bool isBlocking() const;
+        TRA_API bool isOpen() const;
+        TRA_API bool isConnected() const;
+
+        // Linux SO_TIMESTAMPING: software receive timestamps plus send and ACK
+        // timestamps from the error queue. Enable it on a fresh connection;
+        // bytes sent before it was enabled are not matched.
+        TRA_API std::pair<ErrorCode, int> setKernelTimestamping(bool _enabled);
+        TRA_API bool isKernelTimestamping() const;
+
+        // Drains the error queue into _outTransmits and returns in
+        // _outReceiveDelayNs the largest delay between the kernel receiving
+        // data and receiveData handing it over since the previous call.
+        TRA_API std::pair<ErrorCode, int> readKernelTimestamps(std::vector<TransmitTimestamp>& _outTransmits, uint64_t& _outReceiveDelayNs);
+
+    private:
+        struct PendingTransmit
+        {
+            uint32_t m_key;
+            uint64_t m_sendNs;
+            uint64_t m_transmitNs;
+        };
+
+        static constexpr size_t MAX_PENDING_TRANSMITS = 4096;
+
+        int receiveTimestamped(char* _buffer, size_t _size);
+
+        socket_t m_socket;
+        mutable std::mutex m_mutex;
+		uint16_t m_port;
+		bool m_isBlocking;
+
+        bool m_kernelTimestamping;
+        uint32_t m_timestampedBytes;
+        uint64_t m_receiveDelayNs;
+        std::deque<PendingTransmit> m_pendingTransmits;
+    };
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef TRA_CORE_UDP_SOCKET_HPP
+#define TRA_CORE_UDP_SOCKET_HPP
+
+#include "TRA/export.hpp"
+
+#include <utility>
+#include <mutex>
+#include <string>
+
+#include "TRA/errorCode.hpp"
+#include "networkInclude.hpp"
+#include "socketAddress.hpp"
+#include "udpDatagramBatch.hpp"
+
+namespace tra::core
+{
+    class UdpSocket
+    {
+    public:
+        TRA_API UdpSocket();
+        TRA_API ~UdpSocket();
+
+        TRA_API void closeSocket();
+        TRA_API std::pair<ErrorCode, int> bindSocket(const uint16_t _port);
+        TRA_API std::pair<ErrorCode, int> sendDataTo(const void* _data, size_t _size, const SocketAddress& _destAddr);
+        TRA_API std::pair<ErrorCode, int> receiveDataFrom(void* _buffer, size_t _size, SocketAddress& _outSrcAddr);
+        // A datagram the socket refuses is skipped and counted in _outDropped;
+        // the rest of the batch is still sent. Returns SocketSendFailed with the
+        // last error when any were dropped.
+        TRA_API std::pair<ErrorCode, int> sendBatch(UdpDatagramBatch& _batch, size_t _count, size_t& _outDropped);
+        TRA_API std::pair<ErrorCode, int> receiveBatch(UdpDatagramBatch& _batch, size_t _maxCount);
+        TRA_API std::pair<ErrorCode, int> setSegmentationOffload(bool _enabled);
+        TRA_API std::pair<ErrorCode, int> setReceiveOffload(bool _enabled);
+        // Linux SO_TIMESTAMPING software receive timestamps, reported per
+        // datagram by receiveBatch.
+        TRA_API std::pair<ErrorCode, int> setKernelTimestamping(bool _enabled);
+        TRA_API std::pair<ErrorCode, int> setBlocking(bool _blocking);
+        TRA_API std::pair<ErrorCode, uint16_t> getPort();
+        TRA_API bool isBlocking();
+        TRA_API bool isSegmentationOffloadEnabled() const;
+        TRA_API bool isReceiveOffloadEnabled() const;
+        TRA_API bool isKernelTimestamping() const;
+        TRA_API bool isOpen() const;
+
+    private:
+        socket_t m_socket;
+        mutable std::mutex m_mutex;
+        uint16_t m_port;
+        bool m_isBlocking;
+        bool m_segmentationOffload;
+        bool m_receiveOffload;
+        bool m_kernelTimestamping;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef TRA_DEBUG_UTILS_HPP
+#define TRA_DEBUG_UTILS_HPP
+
+#include <cassert>
+#include <type_traits>
+
+#include "TRA/core/logger.hpp"
+
+#define TRA_LOG_LEVEL_DEBUG 0
+#define TRA_LOG_LEVEL_INFO 1
+#define TRA_LOG_LEVEL_ERROR 2
+#define TRA_LOG_LEVEL_NONE 3
+
+// Calls below TRA_LOG_LEVEL compile to nothing, arguments included.
+#ifndef TRA_LOG_LEVEL
+#ifdef NDEBUG
+#define TRA_LOG_LEVEL TRA_LOG_LEVEL_INFO
+#else
+#define TRA_LOG_LEVEL TRA_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define TRA_LOG_AT(level, fmt, ...) \
+	{ \
+		static tra::core::LogSite traLogSite(level, fmt); \
+		tra::core::Logger::log(traLogSite, ##__VA_ARGS__); \
+	}
+
+#ifdef NDEBUG
+#define TRA_ASSERT_REF_PTR_OR_COPIABLE(obj) ((void)0)
+#else
+#define TRA_ASSERT_REF_PTR_OR_COPIABLE(obj) \
+	static_assert(RefPtrOrTriviallyCopiable<decltype(obj)>().m_value && #obj " is not a reference, a pointer, or copyable")
+#endif
+
+#if TRA_LOG_LEVEL <= TRA_LOG_LEVEL_DEBUG
+#define TRA_DEBUG_LOG(fmt, ...) TRA_LOG_AT(tra::core::LogLevel::Debug, fmt, ##__VA_ARGS__)
+#else
+#define TRA_DEBUG_LOG(fmt, ...) ((void)0)
+#endif
+
+#if TRA_LOG_LEVEL <= TRA_LOG_LEVEL_INFO
+#define TRA_INFO_LOG(fmt, ...) TRA_LOG_AT(tra::core::LogLevel::Info, fmt, ##__VA_ARGS__)
+#else
+#define TRA_INFO_LOG(fmt, ...) ((void)0)
+#endif
+
+#if TRA_LOG_LEVEL <= TRA_LOG_LEVEL_ERROR
+#define TRA_ERROR_LOG(fmt, ...) TRA_LOG_AT(tra::core::LogLevel::Error, fmt, ##__VA_ARGS__)
+#else
+#define TRA_ERROR_LOG(fmt, ...) ((void)0)
+#endif
+
+	template<typename T>
+	struct RefPtrOrTriviallyCopiable
+	{
+		bool m_value = std::is_reference_v<T> || std::is_pointer_v<T> || std::is_trivially_copyable_v<T>;
+	};
+
+#endif
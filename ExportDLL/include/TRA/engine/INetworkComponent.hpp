@@ -0,0 +1,12 @@
+#ifndef TRA_ENGINE_I_NETWORK_COMPONENT_HPP
+#define TRA_ENGINE_I_NETWORK_COMPONENT_HPP
+
+namespace tra::engine
+{
+	struct INetworkComponent
+	{
+		virtual ~INetworkComponent() = default;
+	};
+}
+
+#endif
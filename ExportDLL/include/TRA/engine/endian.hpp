@@ -0,0 +1,147 @@
+#ifndef TRA_ENGINE_ENDIAN_HPP
+#define TRA_ENGINE_ENDIAN_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+namespace tra::engine::Endian
+{
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	constexpr bool IS_LITTLE_ENDIAN_HOST = true;
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	constexpr bool IS_LITTLE_ENDIAN_HOST = false;
+#else
+#error "Unable to detect host byte order"
+#endif
+
+	static_assert(sizeof(int) == 4, "The wire format requires a 32-bit int");
+	static_assert(sizeof(float) == 4 && sizeof(double) == 8, "The wire format requires IEEE-754 float and double");
+
+	template<typename T>
+	struct WireType
+	{
+		using type = T;
+	};
+
+	template<>
+	struct WireType<long>
+	{
+		using type = int64_t;
+	};
+
+	template<>
+	struct WireType<unsigned long>
+	{
+		using type = uint64_t;
+	};
+
+	template<typename T>
+	using WireType_t = typename WireType<T>::type;
+
+	template<typename T>
+	inline constexpr bool IsMemcpyCompatible_v = IS_LITTLE_ENDIAN_HOST && sizeof(WireType_t<T>) == sizeof(T);
+
+	inline uint16_t byteSwap(uint16_t _value)
+	{
+#ifdef _MSC_VER
+		return _byteswap_ushort(_value);
+#else
+		return __builtin_bswap16(_value);
+#endif
+	}
+
+	inline uint32_t byteSwap(uint32_t _value)
+	{
+#ifdef _MSC_VER
+		return _byteswap_ulong(_value);
+#else
+		return __builtin_bswap32(_value);
+#endif
+	}
+
+	inline uint64_t byteSwap(uint64_t _value)
+	{
+#ifdef _MSC_VER
+		return _byteswap_uint64(_value);
+#else
+		return __builtin_bswap64(_value);
+#endif
+	}
+
+	inline uint8_t byteSwap(uint8_t _value)
+	{
+		return _value;
+	}
+
+	template<size_t Size>
+	struct UnsignedOfSize;
+
+	template<> struct UnsignedOfSize<1> { using type = uint8_t; };
+	template<> struct UnsignedOfSize<2> { using type = uint16_t; };
+	template<> struct UnsignedOfSize<4> { using type = uint32_t; };
+	template<> struct UnsignedOfSize<8> { using type = uint64_t; };
+
+	template<typename T>
+	void storeLittle(uint8_t* _destination, T _value)
+	{
+		using Wire = WireType_t<T>;
+		using Bits = typename UnsignedOfSize<sizeof(Wire)>::type;
+
+		Wire wire = static_cast<Wire>(_value);
+		if constexpr (IS_LITTLE_ENDIAN_HOST)
+		{
+			std::memcpy(_destination, &wire, sizeof(Wire));
+		}
+		else
+		{
+			Bits bits;
+			std::memcpy(&bits, &wire, sizeof(Wire));
+			bits = byteSwap(bits);
+			std::memcpy(_destination, &bits, sizeof(Wire));
+		}
+	}
+
+	template<typename T>
+	T loadLittle(const uint8_t* _source)
+	{
+		using Wire = WireType_t<T>;
+		using Bits = typename UnsignedOfSize<sizeof(Wire)>::type;
+
+		Wire wire;
+		if constexpr (IS_LITTLE_ENDIAN_HOST)
+		{
+			std::memcpy(&wire, _source, sizeof(Wire));
+		}
+		else
+		{
+			Bits bits;
+			std::memcpy(&bits, _source, sizeof(Wire));
+			bits = byteSwap(bits);
+			std::memcpy(&wire, &bits, sizeof(Wire));
+		}
+
+		return static_cast<T>(wire);
+	}
+
+	template<typename T>
+	void appendLittle(std::vector<uint8_t>& _data, T _value)
+	{
+		size_t offset = _data.size();
+		_data.resize(offset + sizeof(WireType_t<T>));
+		storeLittle(_data.data() + offset, _value);
+	}
+
+	template<typename T>
+	constexpr size_t wireSize()
+	{
+		return sizeof(WireType_t<T>);
+	}
+}
+
+#endif
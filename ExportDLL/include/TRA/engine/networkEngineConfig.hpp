@@ -0,0 +1,111 @@
+#ifndef TRA_ENGINE_NETWORK_ENGINE_CONFIG_HPP
+#define TRA_ENGINE_NETWORK_ENGINE_CONFIG_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace tra::engine
+{
+	enum class SlowConsumerPolicy
+	{
+		DropOldest,
+		Coalesce,
+		Disconnect
+	};
+
+	// Simulated link conditions applied to everything the engine receives,
+	// before it is decoded, so reliability and buffering can be exercised on
+	// localhost. Each TCP connection and each UDP peer gets its own link and
+	// random stream derived from m_seed: the same seed and the same sequence
+	// of reads make the same decisions. TCP bytes are never lost or
+	// reordered, so only the delay, jitter and bandwidth apply to them.
+	// Condition both peers to impair both directions.
+	struct NetworkConditionerConfig
+	{
+		bool m_enabled = false;
+		uint64_t m_seed = 1;
+
+		uint32_t m_delayMs = 0;
+		// Uniform in [-m_jitterMs, m_jitterMs] around m_delayMs, never below 0.
+		uint32_t m_jitterMs = 0;
+		// 0 for unlimited.
+		uint64_t m_bandwidthBytesPerSecond = 0;
+		// A full link tail-drops datagrams and stops reading from TCP sockets.
+		size_t m_maxQueuedBytes = 1024 * 1024;
+
+		// UDP only, probabilities in [0, 1]. A reordered datagram is held
+		// back by an extra m_reorderDelayMs.
+		double m_lossRate = 0.0;
+		double m_duplicateRate = 0.0;
+		double m_reorderRate = 0.0;
+		uint32_t m_reorderDelayMs = 20;
+	};
+
+	struct NetworkEngineConfig
+	{
+		uint32_t m_tcpAcceptorThreads = 0;
+		bool m_tcpReusePort = false;
+		uint32_t m_maxAcceptedConnectionsPerTick = 32;
+
+		uint32_t m_maxFrameSize = 1024 * 1024;
+		size_t m_maxReceiveBufferSize = 4 * 1024 * 1024;
+		size_t m_maxBytesReadPerTick = 256 * 1024;
+
+		size_t m_maxBytesDecodedPerTick = 4 * 1024 * 1024;
+		uint32_t m_maxMessagesDecodedPerTick = 4096;
+		size_t m_receiveQuantum = 16 * 1024;
+
+		size_t m_sendHighWatermark = 1024 * 1024;
+		size_t m_sendLowWatermark = 256 * 1024;
+		size_t m_maxSendQueueSize = 16 * 1024 * 1024;
+		uint32_t m_slowConsumerTicks = 64;
+		SlowConsumerPolicy m_slowConsumerPolicy = SlowConsumerPolicy::DropOldest;
+
+		size_t m_udpMaxPacketSize = 1200;
+		uint32_t m_udpMaxDatagramsReadPerTick = 1024;
+		uint32_t m_udpHandshakeIntervalMs = 250;
+		uint32_t m_udpCookieLifetimeMs = 10000;
+		uint32_t m_udpInitialRetransmitTimeoutMs = 1000;
+		uint32_t m_udpMinRetransmitTimeoutMs = 100;
+		uint32_t m_udpMaxRetransmitTimeoutMs = 2000;
+		uint32_t m_udpMaxReliableInFlight = 512;
+		uint32_t m_udpBatchSize = 64;
+		bool m_udpSegmentationOffload = false;
+		bool m_udpReceiveOffload = false;
+
+		// TCP liveness, each 0 to disable. A connection that has queued
+		// nothing for m_heartbeatIntervalMs sends a heartbeat, which the peer
+		// consumes without handing it to the application. A connection that
+		// has received nothing for m_idleTimeoutMs is disconnected, and so is
+		// one whose first frame has not arrived m_handshakeTimeoutMs after it
+		// was made. With heartbeats on, a connection sends one as soon as it
+		// is made, so such a peer completes the handshake even if it sends
+		// nothing else. Set an idle timeout a few heartbeat intervals long.
+		uint32_t m_heartbeatIntervalMs = 0;
+		uint32_t m_idleTimeoutMs = 0;
+		uint32_t m_handshakeTimeoutMs = 0;
+
+		bool m_tickProfiling = true;
+
+		// Adds a send timestamp and an echo of the peer's to every TCP frame
+		// (24 bytes) and records per message type latency histograms. Both
+		// peers need it for the network and end-to-end stages.
+		bool m_latencyTimestamps = false;
+
+		// Linux SO_TIMESTAMPING on TCP connections and the UDP socket: splits
+		// send latency into time in the local stack and time on the wire, and
+		// measures how long received data waited in the kernel. Only the local
+		// peer needs it. A non-zero m_kernelSendDelayCongestionMs also marks a
+		// connection congested while its average send delay is above it.
+		bool m_kernelTimestamps = false;
+		uint32_t m_kernelSendDelayCongestionMs = 0;
+
+		NetworkConditionerConfig m_conditioner;
+
+		// Frames recorded by NetworkEngine::startCapture are dropped rather than
+		// queued once this many bytes are waiting for the writer thread.
+		size_t m_captureMaxQueuedBytes = 64 * 1024 * 1024;
+	};
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TRA_ENGINE_NETWORK_ROOT_COMPONENT_TAG_HPP
+#define TRA_ENGINE_NETWORK_ROOT_COMPONENT_TAG_HPP
+
+#include "TRA/engine/INetworkComponent.hpp"
+
+namespace tra::engine
+{
+	struct NetworkRootComponentTag : public INetworkComponent
+	{
+
+	};
+}
+
+#endif
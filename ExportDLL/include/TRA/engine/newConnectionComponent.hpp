@@ -0,0 +1,14 @@
+#ifndef TRA_ENGINE_NEW_CONNECTION_COMPONENT_HPP
+#define TRA_ENGINE_NEW_CONNECTION_COMPONENT_HPP
+
+#include "TRA/engine/INetworkComponent.hpp"
+
+namespace tra::engine
+{
+	struct NewConnectionComponentTag : INetworkComponent
+	{
+
+	};
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef TRA_ENGINE_UDP_CHANNEL_HPP
+#define TRA_ENGINE_UDP_CHANNEL_HPP
+
+#include <cstdint>
+
+namespace tra::engine
+{
+	enum class UdpChannel : uint8_t
+	{
+		Unreliable = 0,
+		UnreliableSequenced = 1,
+		ReliableOrdered = 2
+	};
+}
+
+#endif
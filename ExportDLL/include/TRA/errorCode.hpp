@@ -0,0 +1,76 @@
+#ifndef TRA_API_ERRORCODE_HPP
+#define TRA_API_ERRORCODE_HPP
+
+namespace tra
+{
+	enum class ErrorCode
+	{
+		Success = 0,
+		Failure,
+
+		// Client/Server Error
+		DisconnectWithErrors,
+
+		// Server Error
+		ServerAlreadyStarted,
+		ServerNotRunning,
+		InvalidShardIndex,
+		ShardingNotSupported,
+
+		// Client Error
+		ClientAlreadyConnected,
+		ClientNotConnected,
+
+		// Engine Error
+		NetworkEngineNotInitialized,
+		InvalidIpAddress,
+		InvalidPortNumber,
+		InvalidComponent,
+		FrameSizeTooLarge,
+		ReceiveBufferFull,
+		SendQueueCongested,
+		UdpNotConnected,
+		UdpMessageTooLarge,
+		MetricsWriteFailed,
+		TickTraceWriteFailed,
+		CaptureAlreadyRunning,
+		CaptureOpenFailed,
+		CaptureWriteFailed,
+		CaptureInvalidFormat,
+
+		// Network ECS Error
+		EntityDoesNotHaveComponent,
+		EntityAlreadyHasComponent,
+		ComponentStoreUnavailable,
+		InvalidEntity,
+		EntityDoesNotExist,
+
+		// Socket Error
+		SocketAlreadyOpen,
+		SocketNotOpen,
+		SocketConnectionClosed,
+		SocketWouldBlock,
+		SocketShutdownFailed,
+		SocketGetaddrinfoFailed,
+		SocketConnectFailed,
+		SocketBindFailed,
+		SocketListenFailed,
+		SocketAcceptFailed,
+		SocketSendSizeTooLarge,
+		SocketSendFailed,
+		SocketSendPartial,
+		SocketReceiveSizeTooLarge,
+		SocketReceiveFailed,
+		SocketSetBlockingFailed,
+		SocketGetPortFailed,
+		SocketGetPeerAddressFailed,
+		SocketSetOptionFailed,
+		SocketOptionNotSupported,
+		SocketConnectInProgress,
+
+		// WSA Error
+		WSAStartupFailed
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef TRA_SERVER_SHARDED_SERVER_HPP
+#define TRA_SERVER_SHARDED_SERVER_HPP
+
+#include "TRA/export.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <functional>
+
+#include "TRA/errorCode.hpp"
+#include "TRA/server/server.hpp"
+
+namespace tra::server
+{
+	struct MigratedEntity
+	{
+		EntityId m_entityId = 0;
+		uint32_t m_fromShard = 0;
+		std::shared_ptr<engine::Message> m_context;
+	};
+
+	// Runs one Server per shard, each on its own thread pinned to a core. All
+	// shards listen on the same TCP port through SO_REUSEPORT, so the kernel
+	// spreads new connections across them; each shard has its own UDP port,
+	// which is advertised to clients in the UDP handshake.
+	//
+	// SO_REUSEPORT is only available on Linux, BSD and macOS. Elsewhere, on
+	// Windows in particular, Start refuses more than one shard with
+	// ShardingNotSupported; a single shard runs anywhere.
+	//
+	// Shards share nothing. They talk through per-shard mailboxes that are
+	// drained at the start of every tick: postMessage() delivers an application
+	// message, migrateConnection() moves a live TCP connection (and its
+	// buffered frames) to another shard. Called from the source shard's update
+	// callback, migrateConnection() detaches the connection at once; from any
+	// other thread it is queued to the source shard, which detaches it before
+	// its next tick and only logs a failure. takeMigratedConnections() and
+	// takeMessages() must be called from that shard's update callback.
+	class ShardedServer
+	{
+	public:
+		using UpdateCallback = std::function<void(uint32_t _shardIndex, Server& _server)>;
+
+		TRA_API explicit ShardedServer(uint32_t _shardCount = 0, const engine::NetworkEngineConfig& _config = engine::NetworkEngineConfig());
+		TRA_API ~ShardedServer();
+
+		ShardedServer(ShardedServer& other) = delete;
+		void operator=(const ShardedServer&) = delete;
+
+		// _udpBasePort 0 gives every shard an ephemeral UDP port, otherwise shard i
+		// binds _udpBasePort + i. ShardingNotSupported when there are several
+		// shards and the platform has no SO_REUSEPORT.
+		TRA_API ErrorCode Start(uint16_t _port, UpdateCallback _onUpdate, uint16_t _udpBasePort = 0, uint32_t _tickIntervalMs = 16);
+		TRA_API ErrorCode Stop();
+
+		TRA_API bool isRunning() const;
+		TRA_API uint32_t getShardCount() const;
+
+		TRA_API ErrorCode migrateConnection(uint32_t _fromShard, EntityId _entityId, uint32_t _toShard, std::shared_ptr<engine::Message> _context = nullptr);
+		TRA_API ErrorCode postMessage(uint32_t _toShard, std::shared_ptr<engine::Message> _message);
+
+		TRA_API std::vector<MigratedEntity> takeMigratedConnections(uint32_t _shardIndex);
+		TRA_API std::vector<std::shared_ptr<engine::Message>> takeMessages(uint32_t _shardIndex);
+
+	private:
+		struct Shard;
+
+		void runShard(uint32_t _shardIndex);
+		void drainMailbox(Shard& _shard);
+		void sendOutgoingMigrations(uint32_t _shardIndex);
+		ErrorCode detachAndPost(uint32_t _fromShard, EntityId _entityId, uint32_t _toShard, std::shared_ptr<engine::Message> _context);
+
+		std::vector<std::unique_ptr<Shard>> m_shards;
+		engine::NetworkEngineConfig m_config;
+		UpdateCallback m_onUpdate;
+		uint32_t m_tickIntervalMs;
+		std::atomic<bool> m_running;
+	};
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include "echoServer.hpp"
+
+#include "TRA/engine/networkRootComponentTag.hpp"
+#include "TRA/engine/connectionStatusComponent.hpp"
+
+#include "loadMessage.hpp"
+
+namespace tra::loadgen
+{
+	EchoServer::EchoServer(const engine::NetworkEngineConfig& _config)
+		: m_server(_config), m_stopping(false)
+	{
+	}
+
+	EchoServer::~EchoServer()
+	{
+		stop();
+	}
+
+	ErrorCode EchoServer::start(uint16_t _port, const std::string& _capturePath)
+	{
+		ErrorCode ec = m_server.Start(_port);
+		if (ec != ErrorCode::Success)
+		{
+			return ec;
+		}
+
+		if (!_capturePath.empty())
+		{
+			ec = m_server.startCapture(_capturePath);
+			if (ec != ErrorCode::Success)
+			{
+				m_server.Stop();
+				return ec;
+			}
+		}
+
+		m_stopping.store(false);
+		m_thread = std::thread(&EchoServer::run, this);
+		return ErrorCode::Success;
+	}
+
+	void EchoServer::stop()
+	{
+		if (!m_thread.joinable())
+		{
+			return;
+		}
+
+		m_stopping.store(true);
+		m_thread.join();
+		m_server.stopCapture();
+		m_server.Stop();
+	}
+
+	void EchoServer::run()
+	{
+		engine::EntityId selfEntityId = m_server.getSelfEntityId();
+
+		while (!m_stopping.load(std::memory_order_relaxed) && m_server.isRunning())
+		{
+			m_server.beginUpdate();
+
+			std::vector<engine::EntityId> queryIds = m_server.queryEntityIds<engine::NetworkRootComponentTag, engine::ConnectedComponentTag>();
+			for (engine::EntityId entityId : queryIds)
+			{
+				if (entityId == selfEntityId)
+				{
+					continue;
+				}
+
+				for (const std::shared_ptr<engine::Message>& message : m_server.getTcpMessages(entityId, message::LoadPing::MESSAGE_TYPE_NAME))
+				{
+					m_server.sendTcpMessage(entityId, message);
+				}
+			}
+
+			m_server.endUpdate();
+
+			std::this_thread::yield();
+		}
+	}
+}
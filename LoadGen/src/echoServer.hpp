@@ -0,0 +1,42 @@
+#ifndef TRA_LOADGEN_ECHO_SERVER_HPP
+#define TRA_LOADGEN_ECHO_SERVER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "TRA/errorCode.hpp"
+#include "TRA/server/server.hpp"
+
+namespace tra::loadgen
+{
+	// The Server under test, ticking on its own thread and echoing every
+	// LoadPing back to its sender.
+	class EchoServer
+	{
+	public:
+		explicit EchoServer(const engine::NetworkEngineConfig& _config);
+		~EchoServer();
+
+		// A non-empty _capturePath records everything the server receives
+		// until stop.
+		ErrorCode start(uint16_t _port, const std::string& _capturePath);
+		void stop();
+
+		// Safe while running: the metrics are read lock-free.
+		core::MetricsSnapshot getMetricsSnapshot() { return m_server.getMetricsSnapshot(); }
+
+		// Only once stopped, the profiler is owned by the tick thread.
+		std::vector<engine::SystemTiming> getTickProfile() const { return m_server.getTickProfile(); }
+
+	private:
+		void run();
+
+		server::Server m_server;
+		std::thread m_thread;
+		std::atomic<bool> m_stopping;
+	};
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "loadConnection.hpp"
+
+#include <stdexcept>
+
+#include "messageSerializer.hpp"
+
+namespace tra::loadgen
+{
+	LoadConnection::LoadConnection()
+		: m_nextSendNs(0), m_socket(std::make_unique<core::TcpSocket>()), m_state(ConnectionState::Connecting),
+		m_sendOffset(0), m_nextSequence(0), m_readOffset(0)
+	{
+	}
+
+	ErrorCode LoadConnection::startConnect(const std::string& _address, uint16_t _port)
+	{
+		std::pair<ErrorCode, int> connectResult = m_socket->connectTo(_address, _port, true);
+		if (connectResult.first == ErrorCode::Success)
+		{
+			m_state = ConnectionState::Connected;
+		}
+		else if (connectResult.first != ErrorCode::SocketConnectInProgress)
+		{
+			m_state = ConnectionState::Failed;
+		}
+
+		return connectResult.first;
+	}
+
+	ConnectionState LoadConnection::updateConnect()
+	{
+		if (m_state != ConnectionState::Connecting)
+		{
+			return m_state;
+		}
+
+		std::pair<ErrorCode, int> finishResult = m_socket->finishConnect();
+		if (finishResult.first == ErrorCode::Success)
+		{
+			m_state = ConnectionState::Connected;
+		}
+		else if (finishResult.first != ErrorCode::SocketConnectInProgress)
+		{
+			m_state = ConnectionState::Failed;
+		}
+
+		return m_state;
+	}
+
+	void LoadConnection::queueMessage(const message::LoadPing& _message)
+	{
+		engine::MessageHeader header;
+		header.typeId = message::LoadPing::MESSAGE_TYPE_ID;
+
+		std::vector<uint8_t> frame = engine::MessageSerializer::serializeForNetwork(header, _message.serialize());
+		engine::MessageSerializer::writeSequence(frame, m_nextSequence++);
+
+		m_sendBuffer.insert(m_sendBuffer.end(), frame.begin(), frame.end());
+	}
+
+	bool LoadConnection::flush()
+	{
+		if (m_state != ConnectionState::Connected)
+		{
+			return false;
+		}
+
+		while (m_sendOffset < m_sendBuffer.size())
+		{
+			int byteSent = 0;
+			std::pair<ErrorCode, int> sendResult = m_socket->sendData(m_sendBuffer.data() + m_sendOffset, m_sendBuffer.size() - m_sendOffset, byteSent);
+			m_sendOffset += static_cast<size_t>(byteSent);
+
+			if (sendResult.first == ErrorCode::SocketSendPartial || sendResult.first == ErrorCode::SocketWouldBlock)
+			{
+				break;
+			}
+			else if (sendResult.first != ErrorCode::Success)
+			{
+				m_state = ConnectionState::Failed;
+				return false;
+			}
+		}
+
+		if (m_sendOffset == m_sendBuffer.size())
+		{
+			m_sendBuffer.clear();
+			m_sendOffset = 0;
+		}
+
+		return true;
+	}
+
+	bool LoadConnection::receive(std::vector<uint8_t>& _scratch, std::vector<Echo>& _outEchoes)
+	{
+		if (m_state != ConnectionState::Connected)
+		{
+			return false;
+		}
+
+		std::pair<ErrorCode, int> receiveResult = m_socket->receiveData(_scratch, 64 * 1024);
+		m_receiveBuffer.insert(m_receiveBuffer.end(), _scratch.begin(), _scratch.end());
+		if (receiveResult.first != ErrorCode::Success)
+		{
+			m_state = ConnectionState::Failed;
+			return false;
+		}
+
+		engine::MessageHeader header;
+		while (engine::MessageSerializer::readHeader(m_receiveBuffer, m_readOffset, header))
+		{
+			size_t frameStart = m_readOffset + engine::MESSAGE_HEADER_WIRE_SIZE;
+			if (m_receiveBuffer.size() - frameStart < header.size)
+			{
+				break;
+			}
+
+			m_readOffset = frameStart + header.size;
+
+			// The server's own frames, such as the UDP handshake, are skipped.
+			if (header.typeId != message::LoadPing::MESSAGE_TYPE_ID || (header.flags & engine::MessageFlagInternal) != 0)
+			{
+				continue;
+			}
+
+			size_t payloadStart = frameStart;
+			if ((header.flags & engine::MessageFlagTimestamped) != 0)
+			{
+				payloadStart += engine::MESSAGE_TIMESTAMP_WIRE_SIZE;
+			}
+
+			if (payloadStart > m_readOffset)
+			{
+				m_state = ConnectionState::Failed;
+				return false;
+			}
+
+			_scratch.assign(m_receiveBuffer.begin() + payloadStart, m_receiveBuffer.begin() + m_readOffset);
+			try
+			{
+				std::unique_ptr<engine::Message> decoded = message::LoadPing::createFromBytes(_scratch);
+				const message::LoadPing& ping = static_cast<const message::LoadPing&>(*decoded);
+				_outEchoes.push_back({ ping.sizeClass, ping.sentNs });
+			}
+			catch (const std::exception&)
+			{
+				m_state = ConnectionState::Failed;
+				return false;
+			}
+		}
+
+		if (m_readOffset == m_receiveBuffer.size())
+		{
+			m_receiveBuffer.clear();
+			m_readOffset = 0;
+		}
+		else if (m_readOffset > m_receiveBuffer.size() / 2)
+		{
+			m_receiveBuffer.erase(m_receiveBuffer.begin(), m_receiveBuffer.begin() + m_readOffset);
+			m_readOffset = 0;
+		}
+
+		return true;
+	}
+
+	void LoadConnection::close()
+	{
+		m_socket->shutdownSocket();
+		m_socket->closeSocket();
+		m_state = ConnectionState::Failed;
+	}
+}
@@ -0,0 +1,63 @@
+#ifndef TRA_LOADGEN_LOAD_CONNECTION_HPP
+#define TRA_LOADGEN_LOAD_CONNECTION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TRA/errorCode.hpp"
+#include "TRA/core/tcpSocket.hpp"
+
+#include "loadMessage.hpp"
+
+namespace tra::loadgen
+{
+	enum class ConnectionState
+	{
+		Connecting,
+		Connected,
+		Failed
+	};
+
+	struct Echo
+	{
+		uint32_t m_sizeClass;
+		uint64_t m_sentNs;
+	};
+
+	// One simulated client: a non-blocking TcpSocket speaking the engine's
+	// TCP framing directly, without a NetworkEngine of its own.
+	class LoadConnection
+	{
+	public:
+		LoadConnection();
+
+		ErrorCode startConnect(const std::string& _address, uint16_t _port);
+		ConnectionState updateConnect();
+		ConnectionState getState() const { return m_state; }
+
+		void queueMessage(const message::LoadPing& _message);
+
+		// Both return false once the connection is unusable.
+		bool flush();
+		bool receive(std::vector<uint8_t>& _scratch, std::vector<Echo>& _outEchoes);
+
+		void close();
+
+		uint64_t m_nextSendNs;
+
+	private:
+		std::unique_ptr<core::TcpSocket> m_socket;
+		ConnectionState m_state;
+
+		std::vector<uint8_t> m_sendBuffer;
+		size_t m_sendOffset;
+		uint16_t m_nextSequence;
+
+		std::vector<uint8_t> m_receiveBuffer;
+		size_t m_readOffset;
+	};
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TRA_LOADGEN_LOAD_MESSAGE_HPP
+#define TRA_LOADGEN_LOAD_MESSAGE_HPP
+
+#include "TRA/engine/message.hpp"
+
+// Sent by every simulated client and echoed back unchanged by the server.
+// sentNs is the client's steady clock, so the echo gives the round trip.
+DECLARE_MESSAGE_BEGIN(LoadPing)
+FIELD(uint64_t, sentNs)
+FIELD(uint32_t, sizeClass)
+FIELD(std::string, payload)
+DECLARE_MESSAGE_END()
+
+#endif
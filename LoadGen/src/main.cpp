@@ -0,0 +1,579 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "TRA/core/hdrHistogram.hpp"
+#include "TRA/core/logger.hpp"
+#include "TRA/engine/tickProfiler.hpp"
+
+#include "echoServer.hpp"
+#include "loadConnection.hpp"
+#include "loadMessage.hpp"
+
+using namespace tra;
+using namespace tra::loadgen;
+
+namespace
+{
+	// Messages a connection may queue in one pass when it has fallen behind
+	// its schedule, so one slow pass does not turn into an unbounded burst.
+	constexpr uint32_t MAX_BURST = 16;
+
+	// How long the ramp waits for connects, then for the server to accept.
+	constexpr uint64_t RAMP_TIMEOUT_NS = 60ull * 1000 * 1000 * 1000;
+	constexpr uint64_t ACCEPT_TIMEOUT_NS = 10ull * 1000 * 1000 * 1000;
+
+	enum class Phase : int
+	{
+		Warmup,
+		Measure,
+		Stop
+	};
+
+	struct SizeClass
+	{
+		uint32_t m_bytes;
+		uint32_t m_weight;
+	};
+
+	struct Options
+	{
+		uint32_t m_connections = 10000;
+		double m_rate = 1.0;
+		std::vector<SizeClass> m_mix = { { 64, 70 }, { 512, 25 }, { 4096, 5 } };
+		double m_durationSeconds = 10.0;
+		double m_warmupSeconds = 1.0;
+		uint16_t m_port = 2600;
+		uint32_t m_threads = 0;
+		uint32_t m_maxPending = 512;
+		uint32_t m_seed = 1;
+
+		// Applied to what the server receives; TCP only sees delay, jitter
+		// and bandwidth.
+		engine::NetworkConditionerConfig m_conditioner;
+
+		// Where the server records what it receives, for tra_replay.
+		std::string m_capturePath;
+	};
+
+	struct WorkerStats
+	{
+		std::vector<core::HdrHistogram> m_roundTrips;
+		uint64_t m_sent = 0;
+		uint64_t m_received = 0;
+		uint32_t m_failed = 0;
+	};
+
+	uint64_t nowNs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// "64:70,512:25,4096:5": payload bytes and relative weight per class.
+	bool parseMix(const char* _text, std::vector<SizeClass>& _outMix)
+	{
+		_outMix.clear();
+
+		std::string text = _text;
+		size_t start = 0;
+		while (start < text.size())
+		{
+			size_t end = text.find(',', start);
+			if (end == std::string::npos)
+			{
+				end = text.size();
+			}
+
+			std::string entry = text.substr(start, end - start);
+			size_t colon = entry.find(':');
+			if (colon == std::string::npos)
+			{
+				return false;
+			}
+
+			SizeClass sizeClass;
+			sizeClass.m_bytes = static_cast<uint32_t>(std::strtoul(entry.c_str(), nullptr, 10));
+			sizeClass.m_weight = static_cast<uint32_t>(std::strtoul(entry.c_str() + colon + 1, nullptr, 10));
+			_outMix.push_back(sizeClass);
+
+			start = end + 1;
+		}
+
+		return !_outMix.empty();
+	}
+
+	bool parseOptions(int _argc, char** _argv, Options& _outOptions)
+	{
+		for (int i = 1; i < _argc; i++)
+		{
+			const char* argument = _argv[i];
+			bool valid = true;
+
+			if (std::strncmp(argument, "--connections=", 14) == 0)
+			{
+				_outOptions.m_connections = static_cast<uint32_t>(std::strtoul(argument + 14, nullptr, 10));
+			}
+			else if (std::strncmp(argument, "--rate=", 7) == 0)
+			{
+				_outOptions.m_rate = std::atof(argument + 7);
+				valid = _outOptions.m_rate > 0.0;
+			}
+			else if (std::strncmp(argument, "--mix=", 6) == 0)
+			{
+				valid = parseMix(argument + 6, _outOptions.m_mix);
+			}
+			else if (std::strncmp(argument, "--duration=", 11) == 0)
+			{
+				_outOptions.m_durationSeconds = std::atof(argument + 11);
+			}
+			else if (std::strncmp(argument, "--warmup=", 9) == 0)
+			{
+				_outOptions.m_warmupSeconds = std::atof(argument + 9);
+			}
+			else if (std::strncmp(argument, "--port=", 7) == 0)
+			{
+				_outOptions.m_port = static_cast<uint16_t>(std::strtoul(argument + 7, nullptr, 10));
+			}
+			else if (std::strncmp(argument, "--threads=", 10) == 0)
+			{
+				_outOptions.m_threads = static_cast<uint32_t>(std::strtoul(argument + 10, nullptr, 10));
+			}
+			else if (std::strncmp(argument, "--max-pending=", 14) == 0)
+			{
+				_outOptions.m_maxPending = static_cast<uint32_t>(std::strtoul(argument + 14, nullptr, 10));
+				valid = _outOptions.m_maxPending > 0;
+			}
+			else if (std::strncmp(argument, "--seed=", 7) == 0)
+			{
+				_outOptions.m_seed = static_cast<uint32_t>(std::strtoul(argument + 7, nullptr, 10));
+			}
+			else if (std::strncmp(argument, "--delay-ms=", 11) == 0)
+			{
+				_outOptions.m_conditioner.m_enabled = true;
+				_outOptions.m_conditioner.m_delayMs = static_cast<uint32_t>(std::strtoul(argument + 11, nullptr, 10));
+			}
+			else if (std::strncmp(argument, "--jitter-ms=", 12) == 0)
+			{
+				_outOptions.m_conditioner.m_enabled = true;
+				_outOptions.m_conditioner.m_jitterMs = static_cast<uint32_t>(std::strtoul(argument + 12, nullptr, 10));
+			}
+			else if (std::strncmp(argument, "--bandwidth=", 12) == 0)
+			{
+				_outOptions.m_conditioner.m_enabled = true;
+				_outOptions.m_conditioner.m_bandwidthBytesPerSecond = std::strtoull(argument + 12, nullptr, 10);
+			}
+			else if (std::strncmp(argument, "--capture=", 10) == 0)
+			{
+				_outOptions.m_capturePath = argument + 10;
+				valid = !_outOptions.m_capturePath.empty();
+			}
+			else
+			{
+				valid = false;
+			}
+
+			if (!valid)
+			{
+				std::fprintf(stderr, "usage: %s [--connections=N] [--rate=<msgs/s per connection>] [--mix=<bytes:weight,...>]\n"
+					"          [--duration=<s>] [--warmup=<s>] [--port=N] [--threads=N] [--max-pending=N] [--seed=N]\n"
+					"          [--delay-ms=N] [--jitter-ms=N] [--bandwidth=<bytes/s per connection>] [--capture=<path>]\n", _argv[0]);
+				return false;
+			}
+		}
+
+		_outOptions.m_conditioner.m_seed = _outOptions.m_seed;
+
+		if (_outOptions.m_threads == 0)
+		{
+			_outOptions.m_threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 8u);
+		}
+
+		return true;
+	}
+
+	// Both ends of every connection live in this process, so the default
+	// descriptor limit is usually hit long before 10k connections. Returns
+	// the limit in effect, 0 if unknown.
+	uint64_t raiseFileLimit()
+	{
+#if !defined(_WIN32)
+		rlimit limit;
+		if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+		{
+			return 0;
+		}
+
+		if (limit.rlim_cur < limit.rlim_max)
+		{
+			limit.rlim_cur = limit.rlim_max;
+			setrlimit(RLIMIT_NOFILE, &limit);
+			getrlimit(RLIMIT_NOFILE, &limit);
+		}
+
+		return static_cast<uint64_t>(limit.rlim_cur);
+#else
+		return 0;
+#endif
+	}
+
+	// Resident set size, or 0 where it cannot be read.
+	size_t getResidentBytes()
+	{
+#if defined(__linux__)
+		std::ifstream statm("/proc/self/statm");
+		size_t totalPages = 0;
+		size_t residentPages = 0;
+		if (statm >> totalPages >> residentPages)
+		{
+			return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		}
+#endif
+		return 0;
+	}
+
+	int64_t getCounter(const core::MetricsSnapshot& _snapshot, const char* _name)
+	{
+		const core::MetricSample* sample = _snapshot.find(_name);
+		return sample != nullptr ? sample->m_value : 0;
+	}
+
+	double toMicroseconds(uint64_t _ns)
+	{
+		return static_cast<double>(_ns) / 1000.0;
+	}
+
+	void runWorker(const std::vector<LoadConnection*>& _connections, const Options& _options, const std::atomic<int>& _phase, uint32_t _seed, WorkerStats& _outStats)
+	{
+		std::mt19937 random(_seed);
+
+		std::vector<double> weights;
+		std::vector<std::string> payloads;
+		for (const SizeClass& sizeClass : _options.m_mix)
+		{
+			weights.push_back(static_cast<double>(sizeClass.m_weight));
+			payloads.emplace_back(sizeClass.m_bytes, 'x');
+		}
+		std::discrete_distribution<uint32_t> pickSizeClass(weights.begin(), weights.end());
+
+		_outStats.m_roundTrips.assign(_options.m_mix.size(), core::HdrHistogram());
+
+		// Spread the first sends over one interval so connections do not all
+		// fire on the same tick.
+		uint64_t intervalNs = static_cast<uint64_t>(1e9 / _options.m_rate);
+		uint64_t startNs = nowNs();
+		std::uniform_int_distribution<uint64_t> pickOffset(0, intervalNs);
+		for (LoadConnection* connection : _connections)
+		{
+			connection->m_nextSendNs = startNs + pickOffset(random);
+		}
+
+		message::LoadPing ping;
+		std::vector<uint8_t> scratch;
+		std::vector<Echo> echoes;
+		Phase seenPhase = Phase::Warmup;
+
+		for (;;)
+		{
+			Phase phase = static_cast<Phase>(_phase.load(std::memory_order_acquire));
+			if (phase == Phase::Stop)
+			{
+				break;
+			}
+
+			if (phase == Phase::Measure && seenPhase == Phase::Warmup)
+			{
+				for (core::HdrHistogram& histogram : _outStats.m_roundTrips)
+				{
+					histogram.reset();
+				}
+				_outStats.m_sent = 0;
+				_outStats.m_received = 0;
+				seenPhase = Phase::Measure;
+			}
+
+			uint64_t passNs = nowNs();
+			for (LoadConnection* connection : _connections)
+			{
+				if (connection->getState() != ConnectionState::Connected)
+				{
+					continue;
+				}
+
+				// Open loop: sends follow the schedule whatever the replies do,
+				// and the scheduled time is what gets echoed, so a stall shows
+				// up in the round trip instead of delaying the next send.
+				for (uint32_t burst = 0; burst < MAX_BURST && connection->m_nextSendNs <= passNs; burst++)
+				{
+					ping.sentNs = connection->m_nextSendNs;
+					ping.sizeClass = pickSizeClass(random);
+					ping.payload = payloads[ping.sizeClass];
+					connection->queueMessage(ping);
+
+					connection->m_nextSendNs += intervalNs;
+					_outStats.m_sent++;
+				}
+
+				if (!connection->flush() || !connection->receive(scratch, echoes))
+				{
+					_outStats.m_failed++;
+					continue;
+				}
+
+				if (echoes.empty())
+				{
+					continue;
+				}
+
+				uint64_t receivedNs = nowNs();
+				for (const Echo& echo : echoes)
+				{
+					if (echo.m_sizeClass < _outStats.m_roundTrips.size())
+					{
+						_outStats.m_roundTrips[echo.m_sizeClass].record(receivedNs > echo.m_sentNs ? receivedNs - echo.m_sentNs : 0);
+					}
+				}
+				_outStats.m_received += echoes.size();
+				echoes.clear();
+			}
+
+			std::this_thread::yield();
+		}
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	Options options;
+	if (!parseOptions(_argc, _argv, options))
+	{
+		return 1;
+	}
+
+	// Two descriptors per connection, plus a few for the server's sockets.
+	uint64_t fileLimit = raiseFileLimit();
+	if (fileLimit != 0 && fileLimit < 2ull * options.m_connections + 64)
+	{
+		std::fprintf(stderr, "warning: descriptor limit %llu is too low for %u connections; raise it with ulimit -n\n",
+			static_cast<unsigned long long>(fileLimit), options.m_connections);
+	}
+
+	engine::NetworkEngineConfig config;
+	config.m_maxAcceptedConnectionsPerTick = 1024;
+	config.m_conditioner = options.m_conditioner;
+
+	EchoServer server(config);
+	ErrorCode ec = server.start(options.m_port, options.m_capturePath);
+	if (ec != ErrorCode::Success)
+	{
+		std::fprintf(stderr, "failed to start the server on port %u: %d\n", options.m_port, static_cast<int>(ec));
+		return 1;
+	}
+
+	std::printf("connections %u, rate %.2f msg/s each, %u threads, port %u\n", options.m_connections, options.m_rate, options.m_threads, options.m_port);
+
+	// Ramp: non-blocking connects with at most --max-pending in flight.
+	size_t residentBefore = getResidentBytes();
+
+	std::vector<std::unique_ptr<LoadConnection>> connections;
+	connections.reserve(options.m_connections);
+	std::vector<LoadConnection*> pending;
+	std::vector<LoadConnection*> connected;
+	connected.reserve(options.m_connections);
+	uint32_t failed = 0;
+	ErrorCode firstFailure = ErrorCode::Success;
+
+	uint64_t rampStartNs = nowNs();
+	while (connected.size() + failed < options.m_connections && nowNs() - rampStartNs < RAMP_TIMEOUT_NS)
+	{
+		while (connections.size() < options.m_connections && pending.size() < options.m_maxPending)
+		{
+			connections.push_back(std::make_unique<LoadConnection>());
+			LoadConnection* connection = connections.back().get();
+
+			ErrorCode connectResult = connection->startConnect("127.0.0.1", options.m_port);
+			if (connection->getState() == ConnectionState::Failed)
+			{
+				failed++;
+				if (firstFailure == ErrorCode::Success)
+				{
+					firstFailure = connectResult;
+				}
+			}
+			else
+			{
+				pending.push_back(connection);
+			}
+		}
+
+		for (size_t i = 0; i < pending.size();)
+		{
+			ConnectionState state = pending[i]->updateConnect();
+			if (state == ConnectionState::Connecting)
+			{
+				i++;
+				continue;
+			}
+
+			if (state == ConnectionState::Connected)
+			{
+				connected.push_back(pending[i]);
+			}
+			else
+			{
+				failed++;
+			}
+
+			pending[i] = pending.back();
+			pending.pop_back();
+		}
+
+		std::this_thread::yield();
+	}
+
+	// A connect completes once the kernel queues it; setup ends when the
+	// server has accepted every one of them.
+	uint64_t acceptStartNs = nowNs();
+	int64_t accepted = 0;
+	while (nowNs() - acceptStartNs < ACCEPT_TIMEOUT_NS)
+	{
+		accepted = getCounter(server.getMetricsSnapshot(), "tra_tcp_connections");
+		if (accepted >= static_cast<int64_t>(connected.size()))
+		{
+			break;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	uint64_t rampNs = nowNs() - rampStartNs;
+
+	size_t residentAfter = getResidentBytes();
+
+	// The server logs every accept; let it finish before the report starts.
+	core::Logger::flush();
+
+	std::printf("setup: %zu connected, %lld accepted, %u failed in %.3f s (%.0f conn/s)\n", connected.size(), static_cast<long long>(accepted), failed,
+		static_cast<double>(rampNs) / 1e9, static_cast<double>(connected.size()) * 1e9 / static_cast<double>(rampNs));
+	if (failed > 0 && firstFailure != ErrorCode::Success)
+	{
+		std::printf("first connect failure: %d\n", static_cast<int>(firstFailure));
+	}
+
+	if (residentBefore != 0 && residentAfter != 0 && !connected.empty())
+	{
+		double perConnection = static_cast<double>(residentAfter > residentBefore ? residentAfter - residentBefore : 0) / static_cast<double>(connected.size());
+		std::printf("memory: %.1f MiB resident, %.0f bytes per connection (client and server ends)\n",
+			static_cast<double>(residentAfter) / (1024.0 * 1024.0), perConnection);
+	}
+	else
+	{
+		std::printf("memory: n/a\n");
+	}
+	std::fflush(stdout);
+
+	if (connected.empty())
+	{
+		server.stop();
+		return 1;
+	}
+
+	// Traffic: every worker owns an interleaved share of the connections.
+	std::atomic<int> phase(static_cast<int>(Phase::Warmup));
+	std::vector<std::vector<LoadConnection*>> shares(options.m_threads);
+	for (size_t i = 0; i < connected.size(); i++)
+	{
+		shares[i % options.m_threads].push_back(connected[i]);
+	}
+
+	std::vector<WorkerStats> stats(options.m_threads);
+	std::vector<std::thread> workers;
+	for (uint32_t i = 0; i < options.m_threads; i++)
+	{
+		workers.emplace_back(runWorker, std::cref(shares[i]), std::cref(options), std::cref(phase), options.m_seed + i, std::ref(stats[i]));
+	}
+
+	std::this_thread::sleep_for(std::chrono::duration<double>(options.m_warmupSeconds));
+
+	core::MetricsSnapshot before = server.getMetricsSnapshot();
+	uint64_t measureStartNs = nowNs();
+	phase.store(static_cast<int>(Phase::Measure), std::memory_order_release);
+
+	std::this_thread::sleep_for(std::chrono::duration<double>(options.m_durationSeconds));
+
+	core::MetricsSnapshot after = server.getMetricsSnapshot();
+	double measureSeconds = static_cast<double>(nowNs() - measureStartNs) / 1e9;
+	phase.store(static_cast<int>(Phase::Stop), std::memory_order_release);
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	// The server goes first: echoing to a client that already closed
+	// would raise SIGPIPE.
+	server.stop();
+	for (LoadConnection* connection : connected)
+	{
+		connection->close();
+	}
+	core::Logger::flush();
+
+	// Report.
+	int64_t serverMessages = getCounter(after, "tra_tcp_messages_received_total") - getCounter(before, "tra_tcp_messages_received_total");
+	int64_t serverBytes = getCounter(after, "tra_tcp_bytes_received_total") - getCounter(before, "tra_tcp_bytes_received_total");
+	std::printf("server: %.0f msg/s, %.2f MiB/s received over %.2f s\n", static_cast<double>(serverMessages) / measureSeconds,
+		static_cast<double>(serverBytes) / (1024.0 * 1024.0) / measureSeconds, measureSeconds);
+
+	WorkerStats total;
+	total.m_roundTrips.assign(options.m_mix.size(), core::HdrHistogram());
+	for (const WorkerStats& workerStats : stats)
+	{
+		for (size_t i = 0; i < workerStats.m_roundTrips.size(); i++)
+		{
+			total.m_roundTrips[i].merge(workerStats.m_roundTrips[i]);
+		}
+		total.m_sent += workerStats.m_sent;
+		total.m_received += workerStats.m_received;
+		total.m_failed += workerStats.m_failed;
+	}
+
+	std::printf("clients: %llu sent, %llu echoed, %u connections lost\n", static_cast<unsigned long long>(total.m_sent),
+		static_cast<unsigned long long>(total.m_received), total.m_failed);
+
+	std::printf("%-12s %10s %10s %10s %10s %10s %10s\n", "rtt (us)", "count", "p50", "p90", "p99", "p99.9", "max");
+	for (size_t i = 0; i < options.m_mix.size(); i++)
+	{
+		const core::HdrHistogram& histogram = total.m_roundTrips[i];
+		std::string label = std::to_string(options.m_mix[i].m_bytes) + " B";
+		std::printf("%-12s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", label.c_str(), static_cast<unsigned long long>(histogram.getCount()),
+			toMicroseconds(histogram.getValueAtPercentile(50.0)), toMicroseconds(histogram.getValueAtPercentile(90.0)),
+			toMicroseconds(histogram.getValueAtPercentile(99.0)), toMicroseconds(histogram.getValueAtPercentile(99.9)),
+			toMicroseconds(histogram.getMax()));
+	}
+
+	std::vector<engine::SystemTiming> tickProfile = server.getTickProfile();
+	for (size_t slot : { engine::TickProfiler::BEGIN_UPDATE_SLOT, engine::TickProfiler::END_UPDATE_SLOT })
+	{
+		if (slot < tickProfile.size())
+		{
+			const engine::SystemTiming& timing = tickProfile[slot];
+			std::printf("server %-12s p50 %.1f us, p99 %.1f us, max %.1f us\n", timing.m_name.c_str(),
+				toMicroseconds(timing.m_p50Ns), toMicroseconds(timing.m_p99Ns), toMicroseconds(timing.m_maxNs));
+		}
+	}
+
+	return 0;
+}
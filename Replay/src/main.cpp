@@ -0,0 +1,117 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "TRA/core/logger.hpp"
+#include "TRA/engine/trafficReplayer.hpp"
+
+// Linked so captures of tra_loadgen decode rather than being skipped.
+#include "loadMessage.hpp"
+
+using namespace tra;
+
+namespace
+{
+	struct Options
+	{
+		std::string m_capturePath;
+		engine::ReplaySpeed m_speed = engine::ReplaySpeed::Max;
+		uint32_t m_repeat = 1;
+	};
+
+	bool parseOptions(int _argc, char** _argv, Options& _outOptions)
+	{
+		for (int i = 1; i < _argc; i++)
+		{
+			const char* argument = _argv[i];
+			bool valid = true;
+
+			if (std::strcmp(argument, "--speed=original") == 0)
+			{
+				_outOptions.m_speed = engine::ReplaySpeed::Original;
+			}
+			else if (std::strcmp(argument, "--speed=max") == 0)
+			{
+				_outOptions.m_speed = engine::ReplaySpeed::Max;
+			}
+			else if (std::strncmp(argument, "--repeat=", 9) == 0)
+			{
+				_outOptions.m_repeat = static_cast<uint32_t>(std::strtoul(argument + 9, nullptr, 10));
+				valid = _outOptions.m_repeat > 0;
+			}
+			else if (argument[0] != '-' && _outOptions.m_capturePath.empty())
+			{
+				_outOptions.m_capturePath = argument;
+			}
+			else
+			{
+				valid = false;
+			}
+
+			if (!valid)
+			{
+				_outOptions.m_capturePath.clear();
+				break;
+			}
+		}
+
+		if (_outOptions.m_capturePath.empty())
+		{
+			std::fprintf(stderr, "usage: %s <capture> [--speed=original|max] [--repeat=N]\n", _argv[0]);
+			return false;
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	engine::TrafficReplayer replayer;
+	ErrorCode ec = replayer.open(options.m_capturePath);
+	if (ec != ErrorCode::Success)
+	{
+		std::fprintf(stderr, "failed to open capture %s: %d\n", options.m_capturePath.c_str(), static_cast<int>(ec));
+		core::Logger::flush();
+		return 1;
+	}
+
+	for (uint32_t pass = 0; pass < options.m_repeat; pass++)
+	{
+		if (pass > 0)
+		{
+			replayer.rewind();
+		}
+
+		while (replayer.step(options.m_speed))
+		{
+		}
+
+		const engine::ReplayStats& stats = replayer.getStats();
+		double decodeSeconds = static_cast<double>(stats.m_decodeNs) / 1e9;
+
+		std::printf("pass %u: %llu frames, %.2f MB, %llu connections, %llu messages, %llu ticks over %.3f s captured\n",
+			pass + 1, static_cast<unsigned long long>(stats.m_frames), static_cast<double>(stats.m_bytes) / (1024.0 * 1024.0),
+			static_cast<unsigned long long>(stats.m_connections), static_cast<unsigned long long>(stats.m_messages),
+			static_cast<unsigned long long>(stats.m_ticks), static_cast<double>(stats.m_captureNs) / 1e9);
+
+		if (stats.m_frames > 0 && decodeSeconds > 0.0)
+		{
+			std::printf("        decode %.1f ns/frame, %.0f frames/s, %.1f MB/s\n",
+				static_cast<double>(stats.m_decodeNs) / static_cast<double>(stats.m_frames),
+				static_cast<double>(stats.m_frames) / decodeSeconds,
+				static_cast<double>(stats.m_bytes) / (1024.0 * 1024.0) / decodeSeconds);
+		}
+	}
+
+	core::Logger::flush();
+	std::fflush(stdout);
+	return 0;
+}
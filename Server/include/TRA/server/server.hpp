@@ -18,15 +18,21 @@ namespace tra::server
 {
 	using EntityId = uint32_t;
 
+	// Each Server owns its own NetworkEngine, so several can live in one
+	// process. Get() keeps a process-wide default instance for existing callers.
 	class Server
 	{
 	public:
+		TRA_API explicit Server(const engine::NetworkEngineConfig& _config = engine::NetworkEngineConfig());
+		TRA_API ~Server();
+
 		Server(Server& other) = delete;
 		void operator=(const Server&) = delete;
 
 		TRA_API static Server* Get();
 
 		TRA_API ErrorCode Start(uint16_t _port);
+		TRA_API ErrorCode Start(uint16_t _tcpPort, uint16_t _udpPort);
 		TRA_API ErrorCode Stop();
 
 		TRA_API bool isRunning() const;
@@ -36,9 +42,36 @@ namespace tra::server
 
 		TRA_API ErrorCode sendTcpMessage(engine::EntityId _entityId, std::shared_ptr<engine::Message> _message);
 		TRA_API std::vector<std::shared_ptr<engine::Message>> getTcpMessages(EntityId _entityId, const std::string& _messageType);
+		TRA_API std::pair<ErrorCode, engine::ReceiveQueueDepth> getReceiveQueueDepth(EntityId _entityId);
+		TRA_API std::pair<ErrorCode, engine::ConnectionStats> getConnectionStats(EntityId _entityId);
+
+		TRA_API ErrorCode sendUdpMessage(engine::EntityId _entityId, std::shared_ptr<engine::Message> _message, engine::UdpChannel _channel);
+		TRA_API std::vector<std::shared_ptr<engine::Message>> getUdpMessages(EntityId _entityId, const std::string& _messageType);
+
+		TRA_API std::pair<ErrorCode, std::shared_ptr<engine::MigratedConnection>> detachConnection(EntityId _entityId);
+		TRA_API std::pair<ErrorCode, EntityId> attachConnection(std::shared_ptr<engine::MigratedConnection> _connection);
+
+		TRA_API core::MetricsSnapshot getMetricsSnapshot();
+		TRA_API ErrorCode dumpMetrics(const std::string& _path);
+		TRA_API ErrorCode startMetricsEndpoint(uint16_t _port);
+		TRA_API ErrorCode stopMetricsEndpoint();
+
+		TRA_API std::vector<engine::MessageLatency> getMessageLatencies() const;
+		TRA_API void resetMessageLatencies();
+
+		TRA_API std::vector<engine::SystemTiming> getTickProfile() const;
+		TRA_API void startTickTrace(size_t _maxEvents = 1 << 20);
+		TRA_API void stopTickTrace();
+		TRA_API ErrorCode writeTickTrace(const std::string& _path) const;
+
+		TRA_API ErrorCode startCapture(const std::string& _path);
+		TRA_API ErrorCode stopCapture();
 
 		TRA_API EntityId getSelfEntityId();
 
+		TRA_API const engine::NetworkEngineConfig& getConfig() const;
+		TRA_API void setConfig(const engine::NetworkEngineConfig& _config);
+
 		template<typename ComponentType>
 		bool entityHasComponent(EntityId _entityId)
 		{
@@ -61,12 +94,7 @@ namespace tra::server
 		static Server* m_singleton;
 
 		engine::NetworkEngine* m_networkEngine;
-
-		Server();
-		~Server();
 	};
-
-	
 }
 
 #endif
\ No newline at end of file
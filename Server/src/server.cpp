@@ -8,14 +8,16 @@ namespace tra::server
 {
 	Server* Server::m_singleton = nullptr;
 
-	Server::Server()
+	Server::Server(const engine::NetworkEngineConfig& _config)
 	{
-		m_networkEngine = new engine::NetworkEngine();
+		m_networkEngine = new engine::NetworkEngine(_config);
 	}
 
 	Server::~Server()
 	{
 		Stop();
+
+		delete m_networkEngine;
 	}
 
 	Server* Server::Get()
@@ -29,6 +31,11 @@ namespace tra::server
 	}
 
 	ErrorCode Server::Start(uint16_t _port)
+	{
+		return Start(_port, _port);
+	}
+
+	ErrorCode Server::Start(uint16_t _tcpPort, uint16_t _udpPort)
 	{
 		if (isRunning())
 		{
@@ -44,20 +51,20 @@ namespace tra::server
 
 		ErrorCode ec;
 
-		ec = m_networkEngine->startTcpListenOnPort(_port, false);
+		ec = m_networkEngine->startTcpListenOnPort(_tcpPort, false);
 		if (ec != ErrorCode::Success)
 		{
 			return ec;
 		}
 
-		/*ec = m_networkEngine->startUdpOnPort(_port, false);
+		ec = m_networkEngine->startUdpOnPort(_udpPort, false);
 		if (ec != ErrorCode::Success)
 		{
 			m_networkEngine->stopTcpListen();
 			return ec;
-		}*/
+		}
 
-		TRA_INFO_LOG("Server: Started successfully on port %d.", _port);
+		TRA_INFO_LOG("Server: Started successfully on TCP port %d, UDP port %d.", _tcpPort, _udpPort);
 		return ErrorCode::Success;
 	}
 
@@ -76,11 +83,11 @@ namespace tra::server
 		}
 
 		ErrorCode ecTcp = m_networkEngine->stopTcpListen();
-		//ErrorCode ecUdp = m_networkEngine->stopUdp();
+		ErrorCode ecUdp = m_networkEngine->stopUdp();
 
-		if (ecTcp != ErrorCode::Success /*|| ecUdp != ErrorCode::Success*/)
+		if (ecTcp != ErrorCode::Success || ecUdp != ErrorCode::Success)
 		{
-			TRA_ERROR_LOG("Server: Failed to stop server sockets properly. TCP ErrorCode: %d", static_cast<int>(ecTcp));
+			TRA_ERROR_LOG("Server: Failed to stop server sockets properly. TCP ErrorCode: %d, UDP ErrorCode: %d", static_cast<int>(ecTcp), static_cast<int>(ecUdp));
 			return ErrorCode::DisconnectWithErrors;
 		}
 		else
@@ -138,8 +145,138 @@ namespace tra::server
 		return m_networkEngine->getTcpMessages(_entityId, _messageType);
 	}
 
+	std::pair<ErrorCode, engine::ReceiveQueueDepth> Server::getReceiveQueueDepth(EntityId _entityId)
+	{
+		if (!isRunning())
+		{
+			return { ErrorCode::ServerNotRunning, engine::ReceiveQueueDepth() };
+		}
+
+		return m_networkEngine->getReceiveQueueDepth(_entityId);
+	}
+
+	std::pair<ErrorCode, engine::ConnectionStats> Server::getConnectionStats(EntityId _entityId)
+	{
+		if (!isRunning())
+		{
+			return { ErrorCode::ServerNotRunning, engine::ConnectionStats() };
+		}
+
+		return m_networkEngine->getConnectionStats(_entityId);
+	}
+
+	ErrorCode Server::sendUdpMessage(engine::EntityId _entityId, std::shared_ptr<engine::Message> _message, engine::UdpChannel _channel)
+	{
+		if (!isRunning())
+		{
+			return ErrorCode::ServerNotRunning;
+		}
+
+		return m_networkEngine->sendUdpMessage(_entityId, _message, _channel);
+	}
+
+	std::vector<std::shared_ptr<engine::Message>> Server::getUdpMessages(EntityId _entityId, const std::string& _messageType)
+	{
+		if (!isRunning())
+		{
+			return {};
+		}
+
+		return m_networkEngine->getUdpMessages(_entityId, _messageType);
+	}
+
+	std::pair<ErrorCode, std::shared_ptr<engine::MigratedConnection>> Server::detachConnection(EntityId _entityId)
+	{
+		if (!isRunning())
+		{
+			return { ErrorCode::ServerNotRunning, nullptr };
+		}
+
+		return m_networkEngine->detachConnection(_entityId);
+	}
+
+	std::pair<ErrorCode, EntityId> Server::attachConnection(std::shared_ptr<engine::MigratedConnection> _connection)
+	{
+		if (!isRunning())
+		{
+			return { ErrorCode::ServerNotRunning, 0 };
+		}
+
+		return m_networkEngine->attachConnection(_connection);
+	}
+
+	core::MetricsSnapshot Server::getMetricsSnapshot()
+	{
+		return m_networkEngine->getMetricsSnapshot();
+	}
+
+	ErrorCode Server::dumpMetrics(const std::string& _path)
+	{
+		return m_networkEngine->dumpMetrics(_path);
+	}
+
+	ErrorCode Server::startMetricsEndpoint(uint16_t _port)
+	{
+		return m_networkEngine->startMetricsEndpoint(_port);
+	}
+
+	ErrorCode Server::stopMetricsEndpoint()
+	{
+		return m_networkEngine->stopMetricsEndpoint();
+	}
+
+	std::vector<engine::MessageLatency> Server::getMessageLatencies() const
+	{
+		return m_networkEngine->getMessageLatencies();
+	}
+
+	void Server::resetMessageLatencies()
+	{
+		m_networkEngine->resetMessageLatencies();
+	}
+
+	std::vector<engine::SystemTiming> Server::getTickProfile() const
+	{
+		return m_networkEngine->getTickProfile();
+	}
+
+	void Server::startTickTrace(size_t _maxEvents)
+	{
+		m_networkEngine->startTickTrace(_maxEvents);
+	}
+
+	void Server::stopTickTrace()
+	{
+		m_networkEngine->stopTickTrace();
+	}
+
+	ErrorCode Server::writeTickTrace(const std::string& _path) const
+	{
+		return m_networkEngine->writeTickTrace(_path);
+	}
+
+	ErrorCode Server::startCapture(const std::string& _path)
+	{
+		return m_networkEngine->startCapture(_path);
+	}
+
+	ErrorCode Server::stopCapture()
+	{
+		return m_networkEngine->stopCapture();
+	}
+
 	EntityId Server::getSelfEntityId()
 	{
 		return m_networkEngine->getSelfEntityId();
 	}
+
+	const engine::NetworkEngineConfig& Server::getConfig() const
+	{
+		return m_networkEngine->getConfig();
+	}
+
+	void Server::setConfig(const engine::NetworkEngineConfig& _config)
+	{
+		m_networkEngine->setConfig(_config);
+	}
 }
\ No newline at end of file
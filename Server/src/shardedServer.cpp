@@ -0,0 +1,349 @@
+#include "TRA/server/shardedServer.hpp"
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+
+#include "TRA/debugUtils.hpp"
+#include "TRA/core/netUtils.hpp"
+#include "TRA/engine/message.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace tra::server
+{
+	struct ShardedServer::Shard
+	{
+		struct OutgoingMigration
+		{
+			EntityId m_entityId = 0;
+			uint32_t m_toShard = 0;
+			std::shared_ptr<engine::Message> m_context;
+		};
+
+		std::unique_ptr<Server> m_server;
+		std::thread m_thread;
+		// Set by the shard's thread while it runs, so other threads can tell
+		// whether they may touch its engine.
+		std::atomic<std::thread::id> m_threadId;
+
+		std::mutex m_mailboxMutex;
+		std::vector<std::pair<MigratedEntity, std::shared_ptr<engine::MigratedConnection>>> m_incomingConnections;
+		std::vector<std::shared_ptr<engine::Message>> m_incomingMessages;
+		std::vector<OutgoingMigration> m_outgoingMigrations;
+
+		// Only touched by the shard's own thread.
+		std::vector<MigratedEntity> m_migratedConnections;
+		std::vector<std::shared_ptr<engine::Message>> m_messages;
+	};
+
+	namespace
+	{
+		void pinCurrentThread(uint32_t _cpu)
+		{
+#if defined(_WIN32)
+			SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << (_cpu % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+			cpu_set_t cpuSet;
+			CPU_ZERO(&cpuSet);
+			CPU_SET(_cpu % CPU_SETSIZE, &cpuSet);
+			int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+			if (result != 0)
+			{
+				TRA_DEBUG_LOG("ShardedServer: Failed to pin shard thread to CPU %u, error %d.", _cpu, result);
+			}
+#else
+			(void)_cpu;
+#endif
+		}
+	}
+
+	ShardedServer::ShardedServer(uint32_t _shardCount, const engine::NetworkEngineConfig& _config)
+		: m_config(_config), m_tickIntervalMs(16), m_running(false)
+	{
+		if (_shardCount == 0)
+		{
+			_shardCount = (std::max)(1u, std::thread::hardware_concurrency());
+		}
+
+		// One shard has the port to itself and needs no SO_REUSEPORT.
+		m_config.m_tcpReusePort = _shardCount > 1;
+
+		for (uint32_t i = 0; i < _shardCount; i++)
+		{
+			m_shards.push_back(std::make_unique<Shard>());
+		}
+	}
+
+	ShardedServer::~ShardedServer()
+	{
+		Stop();
+	}
+
+	ErrorCode ShardedServer::Start(uint16_t _port, UpdateCallback _onUpdate, uint16_t _udpBasePort, uint32_t _tickIntervalMs)
+	{
+		if (isRunning())
+		{
+			TRA_DEBUG_LOG("ShardedServer: Start called but server is already running.");
+			return ErrorCode::ServerAlreadyStarted;
+		}
+
+		if (m_shards.size() > 1 && !core::NetUtils::isReusePortSupported())
+		{
+			TRA_ERROR_LOG("ShardedServer: %zu shards need SO_REUSEPORT to share port %d, which this platform does not support. Use a single shard.",
+				m_shards.size(), _port);
+			return ErrorCode::ShardingNotSupported;
+		}
+
+		if (_udpBasePort != 0 && static_cast<uint32_t>(_udpBasePort) + m_shards.size() - 1 > 65535)
+		{
+			TRA_ERROR_LOG("ShardedServer: UDP base port %d leaves no room for %zu shards.", _udpBasePort, m_shards.size());
+			return ErrorCode::InvalidPortNumber;
+		}
+
+		for (uint32_t i = 0; i < m_shards.size(); i++)
+		{
+			m_shards[i]->m_server = std::make_unique<Server>(m_config);
+
+			uint16_t udpPort = _udpBasePort == 0 ? 0 : static_cast<uint16_t>(_udpBasePort + i);
+			ErrorCode ec = m_shards[i]->m_server->Start(_port, udpPort);
+			if (ec != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("ShardedServer: Failed to start shard %u. ErrorCode: %d", i, static_cast<int>(ec));
+				for (uint32_t j = 0; j <= i; j++)
+				{
+					m_shards[j]->m_server.reset();
+				}
+				return ec;
+			}
+		}
+
+		m_onUpdate = _onUpdate;
+		m_tickIntervalMs = _tickIntervalMs;
+		m_running = true;
+
+		for (uint32_t i = 0; i < m_shards.size(); i++)
+		{
+			m_shards[i]->m_thread = std::thread(&ShardedServer::runShard, this, i);
+		}
+
+		TRA_INFO_LOG("ShardedServer: Started %zu shards on port %d.", m_shards.size(), _port);
+		return ErrorCode::Success;
+	}
+
+	ErrorCode ShardedServer::Stop()
+	{
+		if (!isRunning())
+		{
+			return ErrorCode::Success;
+		}
+
+		m_running = false;
+
+		ErrorCode result = ErrorCode::Success;
+		for (std::unique_ptr<Shard>& shard : m_shards)
+		{
+			if (shard->m_thread.joinable())
+			{
+				shard->m_thread.join();
+			}
+
+			if (shard->m_server->Stop() != ErrorCode::Success)
+			{
+				result = ErrorCode::DisconnectWithErrors;
+			}
+		}
+
+		for (std::unique_ptr<Shard>& shard : m_shards)
+		{
+			std::lock_guard<std::mutex> lock(shard->m_mailboxMutex);
+			shard->m_incomingConnections.clear();
+			shard->m_incomingMessages.clear();
+			shard->m_outgoingMigrations.clear();
+			shard->m_migratedConnections.clear();
+			shard->m_messages.clear();
+			shard->m_server.reset();
+		}
+
+		TRA_INFO_LOG("ShardedServer: Stopped.");
+		return result;
+	}
+
+	bool ShardedServer::isRunning() const
+	{
+		return m_running;
+	}
+
+	uint32_t ShardedServer::getShardCount() const
+	{
+		return static_cast<uint32_t>(m_shards.size());
+	}
+
+	ErrorCode ShardedServer::migrateConnection(uint32_t _fromShard, EntityId _entityId, uint32_t _toShard, std::shared_ptr<engine::Message> _context)
+	{
+		if (_fromShard >= m_shards.size() || _toShard >= m_shards.size())
+		{
+			return ErrorCode::InvalidShardIndex;
+		}
+
+		if (!isRunning())
+		{
+			return ErrorCode::ServerNotRunning;
+		}
+
+		// Only the source shard's thread may touch its engine.
+		Shard& source = *m_shards[_fromShard];
+		if (source.m_threadId.load() != std::this_thread::get_id())
+		{
+			std::lock_guard<std::mutex> lock(source.m_mailboxMutex);
+			source.m_outgoingMigrations.push_back({ _entityId, _toShard, _context });
+			return ErrorCode::Success;
+		}
+
+		return detachAndPost(_fromShard, _entityId, _toShard, _context);
+	}
+
+	ErrorCode ShardedServer::detachAndPost(uint32_t _fromShard, EntityId _entityId, uint32_t _toShard, std::shared_ptr<engine::Message> _context)
+	{
+		auto detachResult = m_shards[_fromShard]->m_server->detachConnection(_entityId);
+		if (detachResult.first != ErrorCode::Success)
+		{
+			return detachResult.first;
+		}
+
+		MigratedEntity migratedEntity;
+		migratedEntity.m_fromShard = _fromShard;
+		migratedEntity.m_context = _context;
+
+		Shard& target = *m_shards[_toShard];
+		std::lock_guard<std::mutex> lock(target.m_mailboxMutex);
+		target.m_incomingConnections.emplace_back(migratedEntity, detachResult.second);
+
+		return ErrorCode::Success;
+	}
+
+	ErrorCode ShardedServer::postMessage(uint32_t _toShard, std::shared_ptr<engine::Message> _message)
+	{
+		if (_toShard >= m_shards.size())
+		{
+			return ErrorCode::InvalidShardIndex;
+		}
+
+		Shard& target = *m_shards[_toShard];
+		std::lock_guard<std::mutex> lock(target.m_mailboxMutex);
+		target.m_incomingMessages.push_back(_message);
+
+		return ErrorCode::Success;
+	}
+
+	std::vector<MigratedEntity> ShardedServer::takeMigratedConnections(uint32_t _shardIndex)
+	{
+		if (_shardIndex >= m_shards.size())
+		{
+			return {};
+		}
+
+		return std::move(m_shards[_shardIndex]->m_migratedConnections);
+	}
+
+	std::vector<std::shared_ptr<engine::Message>> ShardedServer::takeMessages(uint32_t _shardIndex)
+	{
+		if (_shardIndex >= m_shards.size())
+		{
+			return {};
+		}
+
+		return std::move(m_shards[_shardIndex]->m_messages);
+	}
+
+	void ShardedServer::runShard(uint32_t _shardIndex)
+	{
+		pinCurrentThread(_shardIndex);
+
+		Shard& shard = *m_shards[_shardIndex];
+		shard.m_threadId = std::this_thread::get_id();
+		std::chrono::steady_clock::time_point nextTick = std::chrono::steady_clock::now();
+
+		while (m_running)
+		{
+			// Before the tick decodes anything a detach would discard.
+			sendOutgoingMigrations(_shardIndex);
+
+			shard.m_server->beginUpdate();
+
+			drainMailbox(shard);
+
+			if (m_onUpdate)
+			{
+				m_onUpdate(_shardIndex, *shard.m_server);
+			}
+
+			shard.m_server->endUpdate();
+
+			shard.m_migratedConnections.clear();
+			shard.m_messages.clear();
+
+			nextTick += std::chrono::milliseconds(m_tickIntervalMs);
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (nextTick < now)
+			{
+				nextTick = now;
+			}
+
+			std::this_thread::sleep_until(nextTick);
+		}
+
+		shard.m_threadId = std::thread::id();
+	}
+
+	void ShardedServer::sendOutgoingMigrations(uint32_t _shardIndex)
+	{
+		Shard& shard = *m_shards[_shardIndex];
+
+		std::vector<Shard::OutgoingMigration> outgoingMigrations;
+		{
+			std::lock_guard<std::mutex> lock(shard.m_mailboxMutex);
+			outgoingMigrations.swap(shard.m_outgoingMigrations);
+		}
+
+		for (Shard::OutgoingMigration& migration : outgoingMigrations)
+		{
+			ErrorCode ec = detachAndPost(_shardIndex, migration.m_entityId, migration.m_toShard, migration.m_context);
+			if (ec != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("ShardedServer: Failed to migrate entity %I32u from shard %u to shard %u. ErrorCode: %d",
+					migration.m_entityId, _shardIndex, migration.m_toShard, static_cast<int>(ec));
+			}
+		}
+	}
+
+	void ShardedServer::drainMailbox(Shard& _shard)
+	{
+		std::vector<std::pair<MigratedEntity, std::shared_ptr<engine::MigratedConnection>>> incomingConnections;
+		{
+			std::lock_guard<std::mutex> lock(_shard.m_mailboxMutex);
+			incomingConnections.swap(_shard.m_incomingConnections);
+			_shard.m_messages.insert(_shard.m_messages.end(), _shard.m_incomingMessages.begin(), _shard.m_incomingMessages.end());
+			_shard.m_incomingMessages.clear();
+		}
+
+		for (auto& incoming : incomingConnections)
+		{
+			auto attachResult = _shard.m_server->attachConnection(incoming.second);
+			if (attachResult.first != ErrorCode::Success)
+			{
+				TRA_ERROR_LOG("ShardedServer: Failed to attach connection migrated from shard %u. ErrorCode: %d",
+					incoming.first.m_fromShard, static_cast<int>(attachResult.first));
+				continue;
+			}
+
+			incoming.first.m_entityId = attachResult.second;
+			_shard.m_migratedConnections.push_back(incoming.first);
+		}
+	}
+}
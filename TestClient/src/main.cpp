@@ -1,4 +1,5 @@
 #include <thread>
+#include <iostream>
 #include <chrono>
 
 #include "TRA/client/client.hpp"
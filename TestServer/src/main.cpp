@@ -1,6 +1,7 @@
 #include "TRA/server/server.hpp"
 
 #include <thread>
+#include <iostream>
 #include <chrono>
 
 #include "TRA/debugUtils.hpp"
@@ -35,8 +36,7 @@ int main() {
 		{
 			if (queryIds[i] == selfEntityId) continue;
 
-			auto getMessageResult = Server::Get()->getTcpMessages(queryIds[i], "HelloWorld");
-			for (auto message : getMessageResult.second)
+			for (auto message : Server::Get()->getTcpMessages(queryIds[i], "HelloWorld"))
 			{
 				message::HelloWorld* helloMessage = static_cast<message::HelloWorld*>(message.get());
 				std::cout << "Received from client " << queryIds[i] << ": " << helloMessage->string << std::endl;